@@ -0,0 +1,254 @@
+#include "gesture.h"
+#include "gesture_config.h"
+#include "mpu6050_task.h"
+#include "mymqtt.h"
+#include "esp_log.h"
+#include <math.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+static const char *TAG = "gesture";
+
+#define GRAVITY_MS2             9.80665f
+#define GESTURE_SWING_GAP_US    ((int64_t)GESTURE_SWING_GAP_MS * 1000)
+#define GESTURE_TAP_MAX_US      ((int64_t)GESTURE_TAP_MAX_MS * 1000)
+#define GESTURE_REFRACTORY_US   ((int64_t)GESTURE_REFRACTORY_MS * 1000)
+
+/* 单轴往复摆动计数：角速度超过阈值且方向与上次相反记一次摆动 */
+typedef struct {
+    int8_t sign;            // 上一次摆动方向（0 表示尚未摆动）
+    uint8_t swings;         // 连续反向摆动次数
+    int64_t last_us;        // 最近一次超过阈值的时刻
+    float peak;             // 本轮角速度峰值（°/s）
+} gesture_swing_t;
+
+/* 敲击：|a| 偏离 1g 的短促冲击 */
+typedef struct {
+    bool active;
+    int64_t start_us;
+    float peak_g;           // 冲击峰值（g）
+    float gyro_peak;        // 冲击期间角速度峰值（°/s）
+} gesture_tap_t;
+
+/* 检测状态（只在 MPU6050 消费者任务中访问） */
+static gesture_swing_t s_nod;
+static gesture_swing_t s_shake;
+static gesture_tap_t s_tap;
+static int64_t s_refractory_until = 0;
+
+static volatile gesture_event_cb_t s_event_cb = NULL;
+static uint8_t s_packet[GESTURE_PACKET_BYTES];
+static uint16_t s_seq = 0;
+static gesture_stats_t s_stats;
+static bool s_started = false;
+#if GESTURE_SWITCH_PROFILE
+static mpu6050_profile_t s_prev_profile;    // 启动前的档位（停止时恢复）
+#endif
+
+static const char *const s_type_names[GESTURE_MAX] = {
+    [GESTURE_NONE] = "none",
+    [GESTURE_NOD] = "nod",
+    [GESTURE_SHAKE] = "shake",
+    [GESTURE_TAP] = "tap",
+};
+
+static void _gesture_swing_update(gesture_swing_t *s, float w, float thresh, int64_t ts)
+{
+    // 摆动间隔过长，之前的计数作废
+    if (s->swings > 0 && ts - s->last_us > GESTURE_SWING_GAP_US) {
+        memset(s, 0, sizeof(*s));
+    }
+
+    float a = fabsf(w);
+    if (a < thresh) {
+        return;
+    }
+
+    int8_t sign = (w > 0.0f) ? 1 : -1;
+    if (sign != s->sign) {
+        s->sign = sign;
+        s->swings++;
+    }
+    s->last_us = ts;
+    if (a > s->peak) {
+        s->peak = a;
+    }
+}
+
+// 返回冲击峰值（g），未检测到敲击返回 0
+static float _gesture_tap_update(gesture_tap_t *t, float dev_g, float gyro_abs, int64_t ts)
+{
+    if (!t->active) {
+        if (dev_g > GESTURE_TAP_HIGH_G) {
+            t->active = true;
+            t->start_us = ts;
+            t->peak_g = dev_g;
+            t->gyro_peak = gyro_abs;
+        }
+        return 0.0f;
+    }
+
+    if (dev_g > t->peak_g) t->peak_g = dev_g;
+    if (gyro_abs > t->gyro_peak) t->gyro_peak = gyro_abs;
+
+    if (dev_g >= GESTURE_TAP_LOW_G) {
+        return 0.0f;
+    }
+
+    // 冲击结束：短促且头部没有明显转动才算敲击
+    t->active = false;
+    if (ts - t->start_us <= GESTURE_TAP_MAX_US && t->gyro_peak < GESTURE_TAP_QUIET_DPS) {
+        return t->peak_g;
+    }
+    return 0.0f;
+}
+
+static void _gesture_emit(gesture_type_t type, int64_t ts, float strength)
+{
+    gesture_event_t event = {
+        .type = type,
+        .timestamp_us = ts,
+        .strength = (strength > UINT16_MAX) ? UINT16_MAX : (uint16_t)strength,
+    };
+
+    uint64_t t = (uint64_t)ts;
+    s_packet[0] = GESTURE_FORMAT_VERSION;
+    s_packet[1] = (uint8_t)type;
+    s_packet[2] = (uint8_t)s_seq;
+    s_packet[3] = (uint8_t)(s_seq >> 8);
+    for (int i = 0; i < 8; i++) {
+        s_packet[4 + i] = (uint8_t)(t >> (8 * i));
+    }
+    s_packet[12] = (uint8_t)event.strength;
+    s_packet[13] = (uint8_t)(event.strength >> 8);
+
+    if (mymqtt_publish(GESTURE_TOPIC, s_packet, sizeof(s_packet), GESTURE_QOS) < 0) {
+        s_stats.publish_failed++;
+    }
+    s_seq++;
+    s_stats.events[type]++;
+
+    ESP_LOGI(TAG, "%s（强度 %u）", s_type_names[type], event.strength);
+
+    gesture_event_cb_t cb = s_event_cb;
+    if (cb) {
+        cb(&event);
+    }
+
+    // 不应期内不再检测，动作的回摆不会被当成新动作
+    memset(&s_nod, 0, sizeof(s_nod));
+    memset(&s_shake, 0, sizeof(s_shake));
+    memset(&s_tap, 0, sizeof(s_tap));
+    s_refractory_until = ts + GESTURE_REFRACTORY_US;
+}
+
+// MPU6050 消费者任务中按段调用
+static void _gesture_on_batch(const mpu6050_sample_t *samples, const mpu6050_data_soa_t *data, size_t count)
+{
+    const float *gyro[3] = {data->gyro_x, data->gyro_y, data->gyro_z};
+
+    for (size_t i = 0; i < count; i++) {
+        int64_t ts = samples[i].timestamp_us;
+        if (ts < s_refractory_until) {
+            continue;
+        }
+
+        float w_nod = gyro[GESTURE_NOD_AXIS][i];
+        float w_shake = gyro[GESTURE_SHAKE_AXIS][i];
+        _gesture_swing_update(&s_nod, w_nod, GESTURE_NOD_THRESH_DPS, ts);
+        _gesture_swing_update(&s_shake, w_shake, GESTURE_SHAKE_THRESH_DPS, ts);
+
+        float ax = data->accel_x[i], ay = data->accel_y[i], az = data->accel_z[i];
+        float dev_g = fabsf(sqrtf(ax * ax + ay * ay + az * az) / GRAVITY_MS2 - 1.0f);
+        // 量程饱和时 |a| 被削顶，偏离值可能不足阈值，按刚超过阈值计
+        const mpu6050_raw_data_t *raw = &samples[i].raw;
+        if (abs(raw->accel_x) >= GESTURE_TAP_SATURATION || abs(raw->accel_y) >= GESTURE_TAP_SATURATION ||
+            abs(raw->accel_z) >= GESTURE_TAP_SATURATION) {
+            dev_g = fmaxf(dev_g, GESTURE_TAP_HIGH_G + 0.01f);
+        }
+        float gyro_abs = fmaxf(fmaxf(fabsf(gyro[0][i]), fabsf(gyro[1][i])), fabsf(gyro[2][i]));
+        float tap_g = _gesture_tap_update(&s_tap, dev_g, gyro_abs, ts);
+
+        // 另一轴也在大幅转动说明是杂乱运动，不判为点头/摇头
+        if (s_shake.swings >= GESTURE_SHAKE_SWINGS &&
+            s_nod.peak < GESTURE_CROSS_AXIS_RATIO * s_shake.peak) {
+            _gesture_emit(GESTURE_SHAKE, ts, s_shake.peak);
+        } else if (s_nod.swings >= GESTURE_NOD_SWINGS &&
+                   s_shake.peak < GESTURE_CROSS_AXIS_RATIO * s_nod.peak) {
+            _gesture_emit(GESTURE_NOD, ts, s_nod.peak);
+        } else if (tap_g > 0.0f) {
+            _gesture_emit(GESTURE_TAP, ts, tap_g * 1000.0f);
+        }
+    }
+}
+
+esp_err_t gesture_start(void)
+{
+    if (s_started) {
+        return ESP_OK;
+    }
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    memset(&s_nod, 0, sizeof(s_nod));
+    memset(&s_shake, 0, sizeof(s_shake));
+    memset(&s_tap, 0, sizeof(s_tap));
+
+#if GESTURE_SWITCH_PROFILE
+    // 档位在采集任务下次唤醒时切换，之前的少量采样仍按原量程检测
+    s_prev_profile = mpu6050_task_get_profile();
+    esp_err_t ret = mpu6050_task_set_profile(GESTURE_PROFILE);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "切换档位失败: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    mpu6050_profile_t profile = GESTURE_PROFILE;
+#else
+    mpu6050_profile_t profile = mpu6050_task_get_profile();
+#endif
+    mpu6050_task_set_batch_cb(_gesture_on_batch);
+
+    s_started = true;
+    ESP_LOGI(TAG, "动作检测已启动（档位 %s，%u Hz）",
+             mpu6050_get_profile_desc(profile)->name,
+             mpu6050_get_profile_desc(profile)->rate_hz);
+    return ESP_OK;
+}
+
+void gesture_stop(void)
+{
+    if (!s_started) {
+        return;
+    }
+
+    mpu6050_task_set_batch_cb(NULL);
+#if GESTURE_SWITCH_PROFILE
+    // 期间被其他模块切走的档位不覆盖
+    if (mpu6050_task_get_profile() == GESTURE_PROFILE && s_prev_profile != GESTURE_PROFILE) {
+        mpu6050_task_set_profile(s_prev_profile);
+    }
+#endif
+
+    s_started = false;
+    ESP_LOGI(TAG, "动作检测已停止");
+}
+
+void gesture_set_event_cb(gesture_event_cb_t cb)
+{
+    s_event_cb = cb;
+}
+
+const char *gesture_type_name(gesture_type_t type)
+{
+    if (type < 0 || type >= GESTURE_MAX) {
+        return "?";
+    }
+    return s_type_names[type];
+}
+
+void gesture_get_stats(gesture_stats_t *stats)
+{
+    if (stats != NULL) {
+        *stats = s_stats;
+    }
+}
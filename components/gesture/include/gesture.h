@@ -0,0 +1,73 @@
+#ifndef __GESTURE_H__
+#define __GESTURE_H__
+
+#include "esp_err.h"
+#include <stdint.h>
+
+/**
+ * @brief 动作类型
+ */
+typedef enum {
+    GESTURE_NONE = 0,
+    GESTURE_NOD,            // 点头
+    GESTURE_SHAKE,          // 摇头
+    GESTURE_TAP,            // 敲击
+    GESTURE_MAX
+} gesture_type_t;
+
+/**
+ * @brief 动作事件
+ */
+typedef struct {
+    gesture_type_t type;
+    int64_t timestamp_us;   // 判定时刻对应的采样时间
+    uint16_t strength;      // 摆动峰值（°/s）或冲击峰值（mg）
+} gesture_event_t;
+
+/**
+ * @brief 动作事件回调（在 MPU6050 消费者任务中调用，不应阻塞；界面更新请转投 LVGL 任务）
+ * @param event 事件
+ */
+typedef void (*gesture_event_cb_t)(const gesture_event_t *event);
+
+/**
+ * @brief 动作统计
+ */
+typedef struct {
+    uint32_t events[GESTURE_MAX];   // 各类型事件数
+    uint32_t publish_failed;        // 发布失败数
+} gesture_stats_t;
+
+/**
+ * @brief 启动动作检测：注册 MPU6050 批量采样回调（GESTURE_SWITCH_PROFILE 为 1 时先切换到 GESTURE_PROFILE），
+ *        检测到动作后发布事件并通知回调
+ *
+ * 需先调用 mpu6050_task_init()。
+ *
+ * @return ESP_OK 成功，其他值表示档位切换失败
+ */
+esp_err_t gesture_start(void);
+
+/**
+ * @brief 停止动作检测：注销回调；切换过档位且档位仍为 GESTURE_PROFILE 时恢复启动前的档位
+ */
+void gesture_stop(void);
+
+/**
+ * @brief 设置事件回调（NULL 取消）
+ * @param cb 回调函数
+ */
+void gesture_set_event_cb(gesture_event_cb_t cb);
+
+/**
+ * @brief 获取事件类型名
+ */
+const char *gesture_type_name(gesture_type_t type);
+
+/**
+ * @brief 获取动作统计
+ * @param stats 输出
+ */
+void gesture_get_stats(gesture_stats_t *stats);
+
+#endif /* __GESTURE_H__ */
@@ -0,0 +1,54 @@
+#ifndef __GESTURE_CONFIG_H__
+#define __GESTURE_CONFIG_H__
+
+#include "mymqtt_config.h"
+#include "mpu6050.h"
+
+/* ================= Publish Config ================= */
+#define GESTURE_TOPIC                   MYMQTT_TOPIC_GESTURE
+#define GESTURE_QOS                     1               // 事件稀疏且不可由后续数据恢复，需要确认
+
+/* ================= Sensor Config ================= */
+/*
+ * 档位是整条采集链路共用的：切到 GESTURE_PROFILE（1kHz，±2000°/s，±8g）后原始遥测数据量翻倍，
+ * 姿态融合的量程分辨率也随之下降，因此默认沿用当前档位。检测按时间戳判定，与采样率无关；
+ * ±2g 下敲击冲击会削顶，任一加速度轴饱和即视为冲击（见 GESTURE_TAP_SATURATION）。
+ */
+#define GESTURE_SWITCH_PROFILE          0               // 1=检测期间切换到 GESTURE_PROFILE，停止时恢复
+#define GESTURE_PROFILE                 MPU6050_PROFILE_GESTURE
+
+/* ================= Axis Config ================= */
+/* 陀螺仪通道：0=X 1=Y 2=Z（与 imu_fusion 机体系一致：俯仰绕 Y，偏航绕 Z） */
+#define GESTURE_NOD_AXIS                1               // 点头：俯仰往复
+#define GESTURE_SHAKE_AXIS              2               // 摇头：偏航往复
+
+/* ================= Swing Detection ================= */
+#define GESTURE_NOD_THRESH_DPS          (60.0f)         // 点头摆动角速度阈值
+#define GESTURE_SHAKE_THRESH_DPS        (90.0f)         // 摇头摆动角速度阈值
+#define GESTURE_NOD_SWINGS              (2)             // 点头：下-上两次反向摆动
+#define GESTURE_SHAKE_SWINGS            (4)             // 摇头：左右至少四次反向摆动
+#define GESTURE_SWING_GAP_MS            (400)           // 相邻摆动最大间隔，超时重新计数
+#define GESTURE_CROSS_AXIS_RATIO        (0.6f)          // 另一轴峰值超过本轴峰值的该比例时视为杂乱运动
+
+/* ================= Tap Detection ================= */
+#define GESTURE_TAP_HIGH_G              (1.0f)          // |a| 偏离 1g 超过该值进入冲击
+#define GESTURE_TAP_LOW_G               (0.3f)          // 回落到该值以下冲击结束
+#define GESTURE_TAP_MAX_MS              (80)            // 冲击持续上限，更长的是运动而不是敲击
+#define GESTURE_TAP_QUIET_DPS           (60.0f)         // 冲击期间三轴角速度上限（排除甩头）
+#define GESTURE_TAP_SATURATION          (32000)         // 加速度原始值绝对值达到该值视为量程饱和
+
+/* ================= Event Config ================= */
+#define GESTURE_REFRACTORY_MS           (500)           // 事件后不应期，避免同一动作重复触发
+
+/* ================= Packet Format =================
+ * 小端序，固定 14 字节：
+ *   [0]      u8   版本号 GESTURE_FORMAT_VERSION
+ *   [1]      u8   事件类型 gesture_type_t
+ *   [2..3]   u16  事件序号
+ *   [4..11]  u64  事件时间戳（us，设备时钟）
+ *   [12..13] u16  强度（摆动峰值 °/s 或冲击峰值 mg）
+ */
+#define GESTURE_FORMAT_VERSION          1
+#define GESTURE_PACKET_BYTES            (14)
+
+#endif /* __GESTURE_CONFIG_H__ */
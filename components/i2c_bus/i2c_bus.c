@@ -0,0 +1,339 @@
+#include "i2c_bus.h"
+#include "i2c_bus_config.h"
+#include "sys_task.h"
+#include "driver/i2c_master.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+static const char *TAG = "i2c_bus";
+
+struct i2c_bus_device {
+    i2c_master_dev_handle_t handle;
+    const char *name;
+    uint16_t addr;
+    uint8_t retries;
+    i2c_bus_dev_stats_t stats;
+};
+
+static i2c_master_bus_handle_t s_bus = NULL;
+static struct i2c_bus_device s_devices[I2C_BUS_MAX_DEVICES];
+static size_t s_device_count = 0;
+
+static SemaphoreHandle_t s_lock = NULL;     // 总线锁：同步/异步传输与复位互斥
+static QueueHandle_t s_queue = NULL;        // 异步事务队列
+static TaskHandle_t s_worker = NULL;
+
+static uint32_t s_consecutive_failures = 0; // 连续失败次数（任一设备，持锁访问）
+static uint32_t s_reset_count = 0;
+static bool s_inited = false;
+
+static inline bool _i2c_bus_dev_valid(i2c_bus_device_handle_t dev)
+{
+    return dev >= &s_devices[0] && dev < &s_devices[s_device_count];
+}
+
+// 退避等待：至少让出一个 tick（100Hz 下 1~8ms 换算为 0 tick），不忙等，避免高优先级调用方饿死同核任务
+static void _i2c_bus_backoff(uint32_t ms)
+{
+    TickType_t ticks = pdMS_TO_TICKS(ms);
+    vTaskDelay(ticks > 0 ? ticks : 1);
+}
+
+static esp_err_t _i2c_bus_reset_locked(void)
+{
+    esp_err_t err = i2c_master_bus_reset(s_bus);
+    s_reset_count++;
+    s_consecutive_failures = 0;
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "总线复位失败: %s", esp_err_to_name(err));
+    } else {
+        ESP_LOGW(TAG, "总线已复位（累计 %lu 次）", (unsigned long)s_reset_count);
+    }
+    return err;
+}
+
+static esp_err_t _i2c_bus_xfer_once(const i2c_bus_txn_t *txn)
+{
+    i2c_master_dev_handle_t h = txn->dev->handle;
+
+    if (txn->rd_len == 0) {
+        return i2c_master_transmit(h, txn->wr, txn->wr_len, I2C_BUS_TIMEOUT_MS);
+    }
+    if (txn->wr_len == 0) {
+        return i2c_master_receive(h, txn->rd, txn->rd_len, I2C_BUS_TIMEOUT_MS);
+    }
+    return i2c_master_transmit_receive(h, txn->wr, txn->wr_len, txn->rd, txn->rd_len, I2C_BUS_TIMEOUT_MS);
+}
+
+static esp_err_t _i2c_bus_execute(const i2c_bus_txn_t *txn)
+{
+    struct i2c_bus_device *dev = txn->dev;
+    uint32_t attempts = (txn->flags & I2C_BUS_FLAG_NO_RETRY) ? 1 : 1 + (uint32_t)dev->retries;
+    uint32_t backoff_ms = I2C_BUS_BACKOFF_BASE_MS;
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t err = ESP_FAIL;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (uint32_t i = 0; i < attempts; i++) {
+        if (i > 0) {
+            // 退避期间释放总线，其他设备的事务可以继续
+            dev->stats.retries++;
+            xSemaphoreGive(s_lock);
+            _i2c_bus_backoff(backoff_ms);
+            backoff_ms = (backoff_ms * 2 > I2C_BUS_BACKOFF_MAX_MS) ? I2C_BUS_BACKOFF_MAX_MS : backoff_ms * 2;
+            xSemaphoreTake(s_lock, portMAX_DELAY);
+        }
+
+        err = _i2c_bus_xfer_once(txn);
+        if (err == ESP_OK) {
+            s_consecutive_failures = 0;
+            break;
+        }
+
+        if (err == ESP_ERR_TIMEOUT) {
+            dev->stats.timeouts++;
+        } else {
+            dev->stats.errors++;
+        }
+        dev->stats.last_error = err;
+
+        // 从机卡住 SDA 时后续传输都会失败，复位后再重试
+        if (++s_consecutive_failures >= I2C_BUS_RESET_THRESHOLD) {
+            _i2c_bus_reset_locked();
+        }
+    }
+
+    dev->stats.transfers++;
+    if (err != ESP_OK) {
+        dev->stats.failures++;
+    }
+    uint32_t latency = (uint32_t)(esp_timer_get_time() - start_us);
+    if (latency > dev->stats.max_latency_us) {
+        dev->stats.max_latency_us = latency;
+    }
+    xSemaphoreGive(s_lock);
+
+    if (err != ESP_OK) {
+        ESP_LOGD(TAG, "%s(0x%02X) 传输失败: %s", dev->name, dev->addr, esp_err_to_name(err));
+    }
+    return err;
+}
+
+static void _i2c_bus_worker_task(void *arg)
+{
+    (void)arg;
+
+    i2c_bus_txn_t txn;
+    while (1) {
+        if (xQueueReceive(s_queue, &txn, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        esp_err_t err = _i2c_bus_execute(&txn);
+        if (txn.cb) {
+            txn.cb(err, txn.arg);
+        }
+    }
+}
+
+esp_err_t i2c_bus_init(void)
+{
+    if (s_inited) {
+        return ESP_OK;
+    }
+
+    if (s_lock == NULL) {
+        s_lock = xSemaphoreCreateMutex();
+        if (s_lock == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    if (s_bus == NULL) {
+        i2c_master_bus_config_t bus_cfg = {
+            .i2c_port = I2C_BUS_PORT,
+            .sda_io_num = I2C_BUS_SDA_PIN,
+            .scl_io_num = I2C_BUS_SCL_PIN,
+            .clk_source = I2C_CLK_SRC_DEFAULT,
+            .glitch_ignore_cnt = I2C_BUS_GLITCH_IGNORE_CNT,
+            .flags.enable_internal_pullup = I2C_BUS_INTERNAL_PULLUP,
+        };
+
+        esp_err_t err = i2c_new_master_bus(&bus_cfg, &s_bus);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "创建 I2C 总线失败: %s", esp_err_to_name(err));
+            s_bus = NULL;
+            return err;
+        }
+    }
+
+    if (s_queue == NULL) {
+        s_queue = xQueueCreate(I2C_BUS_QUEUE_LEN, sizeof(i2c_bus_txn_t));
+        if (s_queue == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    if (s_worker == NULL) {
+        esp_err_t err = sys_task_create(SYS_TASK_ID_I2C_BUS, _i2c_bus_worker_task, NULL, &s_worker);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    s_inited = true;
+    ESP_LOGI(TAG, "I2C 总线初始化完成 (SDA=%d, SCL=%d)", I2C_BUS_SDA_PIN, I2C_BUS_SCL_PIN);
+    return ESP_OK;
+}
+
+esp_err_t i2c_bus_add_device(const char *name, uint16_t addr, uint32_t scl_speed_hz,
+                             i2c_bus_device_handle_t *out)
+{
+    if (out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!s_inited) {
+        ESP_LOGE(TAG, "I2C 总线未初始化");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (s_device_count >= I2C_BUS_MAX_DEVICES) {
+        ESP_LOGE(TAG, "设备数已达上限 %d", I2C_BUS_MAX_DEVICES);
+        return ESP_ERR_NO_MEM;
+    }
+
+    i2c_device_config_t dev_cfg = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = addr,
+        .scl_speed_hz = scl_speed_hz,
+    };
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    struct i2c_bus_device *dev = &s_devices[s_device_count];
+    memset(dev, 0, sizeof(*dev));
+    esp_err_t err = i2c_master_bus_add_device(s_bus, &dev_cfg, &dev->handle);
+    if (err == ESP_OK) {
+        dev->name = (name != NULL) ? name : "?";
+        dev->addr = addr;
+        dev->retries = I2C_BUS_DEFAULT_RETRIES;
+        s_device_count++;
+    }
+    xSemaphoreGive(s_lock);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "挂载设备 0x%02X 失败: %s", addr, esp_err_to_name(err));
+        return err;
+    }
+
+    *out = dev;
+    return ESP_OK;
+}
+
+void i2c_bus_set_retries(i2c_bus_device_handle_t dev, uint8_t retries)
+{
+    if (_i2c_bus_dev_valid(dev)) {
+        dev->retries = retries;
+    }
+}
+
+esp_err_t i2c_bus_transfer(const i2c_bus_txn_t *txn)
+{
+    if (txn == NULL || !_i2c_bus_dev_valid(txn->dev) ||
+        (txn->wr_len == 0 && txn->rd_len == 0) ||
+        (txn->wr_len > 0 && txn->wr == NULL) || (txn->rd_len > 0 && txn->rd == NULL)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return _i2c_bus_execute(txn);
+}
+
+esp_err_t i2c_bus_submit(const i2c_bus_txn_t *txn, uint32_t wait_ms)
+{
+    if (!s_inited) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (txn == NULL || !_i2c_bus_dev_valid(txn->dev) ||
+        (txn->wr_len == 0 && txn->rd_len == 0) ||
+        (txn->wr_len > 0 && txn->wr == NULL) || (txn->rd_len > 0 && txn->rd == NULL)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (xQueueSend(s_queue, txn, pdMS_TO_TICKS(wait_ms)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    return ESP_OK;
+}
+
+esp_err_t i2c_bus_write_reg(i2c_bus_device_handle_t dev, uint8_t reg, uint8_t value)
+{
+    uint8_t buf[] = {reg, value};
+    i2c_bus_txn_t txn = {
+        .dev = dev,
+        .wr = buf,
+        .wr_len = sizeof(buf),
+    };
+    return i2c_bus_transfer(&txn);
+}
+
+esp_err_t i2c_bus_read_regs(i2c_bus_device_handle_t dev, uint8_t reg, uint8_t *data, size_t len)
+{
+    i2c_bus_txn_t txn = {
+        .dev = dev,
+        .wr = &reg,
+        .wr_len = 1,
+        .rd = data,
+        .rd_len = len,
+    };
+    return i2c_bus_transfer(&txn);
+}
+
+esp_err_t i2c_bus_reset(void)
+{
+    if (!s_inited) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    esp_err_t err = _i2c_bus_reset_locked();
+    xSemaphoreGive(s_lock);
+    return err;
+}
+
+esp_err_t i2c_bus_get_stats(i2c_bus_device_handle_t dev, i2c_bus_dev_stats_t *stats)
+{
+    if (!_i2c_bus_dev_valid(dev) || stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    *stats = dev->stats;
+    xSemaphoreGive(s_lock);
+    return ESP_OK;
+}
+
+uint32_t i2c_bus_get_reset_count(void)
+{
+    return s_reset_count;
+}
+
+void i2c_bus_dump_stats(void)
+{
+    ESP_LOGI(TAG, "%-10s %4s %8s %6s %6s %6s %6s %8s", "dev", "addr", "xfers", "fail", "retry", "tmo", "err", "max_us");
+    for (size_t i = 0; i < s_device_count; i++) {
+        i2c_bus_dev_stats_t st;
+        i2c_bus_get_stats(&s_devices[i], &st);
+        ESP_LOGI(TAG, "%-10s 0x%02X %8lu %6lu %6lu %6lu %6lu %8lu",
+                 s_devices[i].name, s_devices[i].addr,
+                 (unsigned long)st.transfers, (unsigned long)st.failures, (unsigned long)st.retries,
+                 (unsigned long)st.timeouts, (unsigned long)st.errors, (unsigned long)st.max_latency_us);
+    }
+    ESP_LOGI(TAG, "总线复位 %lu 次", (unsigned long)s_reset_count);
+}
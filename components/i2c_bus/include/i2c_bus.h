@@ -0,0 +1,143 @@
+#ifndef __I2C_BUS_H__
+#define __I2C_BUS_H__
+
+/*
+ * 共享 I2C 总线服务：
+ *
+ * - 总线由本模块统一创建，各传感器驱动通过 i2c_bus_add_device 挂载
+ * - 同步传输在调用方任务中执行，异步事务排队后由总线任务按提交顺序执行，两者由总线锁串行化
+ * - 失败自动重试（指数退避，退避期间释放总线锁），连续失败达到阈值时复位总线
+ * - 所有错误以返回值报告，不会因单次 NACK/超时中止程序
+ * - 不可在中断中调用
+ */
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief 设备句柄
+ */
+typedef struct i2c_bus_device *i2c_bus_device_handle_t;
+
+/* 事务标志 */
+#define I2C_BUS_FLAG_NO_RETRY           (1U << 0)       // 失败不重试（读取会改变设备状态时使用，如 FIFO 数据寄存器）
+
+/**
+ * @brief 异步事务完成回调（在总线任务中调用，不应长时间阻塞）
+ * @param err 传输结果（已包含重试）
+ * @param arg 提交时的用户参数
+ */
+typedef void (*i2c_bus_done_cb_t)(esp_err_t err, void *arg);
+
+/**
+ * @brief 传输事务（先写 wr 再读 rd，任一段长度可为 0）
+ *
+ * 异步提交时 wr/rd 指向的缓冲区须保持有效直到完成回调。
+ */
+typedef struct {
+    i2c_bus_device_handle_t dev;    // 目标设备
+    const uint8_t *wr;              // 写入数据
+    size_t wr_len;
+    uint8_t *rd;                    // 读取缓冲
+    size_t rd_len;
+    uint32_t flags;                 // I2C_BUS_FLAG_*
+    i2c_bus_done_cb_t cb;           // 完成回调（仅异步，可为 NULL）
+    void *arg;                      // 回调参数
+} i2c_bus_txn_t;
+
+/**
+ * @brief 设备统计
+ */
+typedef struct {
+    uint32_t transfers;         // 完成的传输数（含失败）
+    uint32_t failures;          // 重试后仍失败的传输数
+    uint32_t retries;           // 重试次数
+    uint32_t timeouts;          // 超时次数（每次尝试计一次）
+    uint32_t errors;            // 其他错误次数（NACK、仲裁丢失等）
+    uint32_t max_latency_us;    // 单次传输最长耗时（含重试与等待总线）
+    esp_err_t last_error;       // 最近一次错误
+} i2c_bus_dev_stats_t;
+
+/**
+ * @brief 初始化共享总线（引脚等见 i2c_bus_config.h，可重复调用）
+ *
+ * @return ESP_OK 成功，其他值表示失败
+ */
+esp_err_t i2c_bus_init(void);
+
+/**
+ * @brief 挂载设备
+ *
+ * @param name 设备名（统计输出用，需为常量字符串）
+ * @param addr 7 位地址
+ * @param scl_speed_hz SCL 频率
+ * @param out 输出设备句柄
+ * @return ESP_OK 成功，ESP_ERR_INVALID_STATE 总线未初始化，ESP_ERR_NO_MEM 设备数已满，其他值表示失败
+ */
+esp_err_t i2c_bus_add_device(const char *name, uint16_t addr, uint32_t scl_speed_hz,
+                             i2c_bus_device_handle_t *out);
+
+/**
+ * @brief 设置设备重试次数（默认 I2C_BUS_DEFAULT_RETRIES）
+ *
+ * @param dev 设备句柄
+ * @param retries 重试次数（不含首次）
+ */
+void i2c_bus_set_retries(i2c_bus_device_handle_t dev, uint8_t retries);
+
+/**
+ * @brief 同步传输（在调用方任务中执行，忽略 cb/arg）
+ *
+ * @param txn 事务
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效，其他值为最后一次尝试的错误
+ */
+esp_err_t i2c_bus_transfer(const i2c_bus_txn_t *txn);
+
+/**
+ * @brief 异步提交事务（拷贝事务描述入队，由总线任务执行后调用 cb）
+ *
+ * @param txn 事务
+ * @param wait_ms 队列满时最长等待
+ * @return ESP_OK 已入队，ESP_ERR_TIMEOUT 队列满，ESP_ERR_INVALID_ARG 参数无效，ESP_ERR_INVALID_STATE 未初始化
+ */
+esp_err_t i2c_bus_submit(const i2c_bus_txn_t *txn, uint32_t wait_ms);
+
+/**
+ * @brief 写单个寄存器（同步，带重试）
+ */
+esp_err_t i2c_bus_write_reg(i2c_bus_device_handle_t dev, uint8_t reg, uint8_t value);
+
+/**
+ * @brief 从指定寄存器起连续读取（同步，带重试）
+ */
+esp_err_t i2c_bus_read_regs(i2c_bus_device_handle_t dev, uint8_t reg, uint8_t *data, size_t len);
+
+/**
+ * @brief 复位总线（释放被从机拉低的 SDA 并复位控制器）
+ *
+ * @return ESP_OK 成功，其他值表示失败
+ */
+esp_err_t i2c_bus_reset(void);
+
+/**
+ * @brief 获取设备统计
+ *
+ * @param dev 设备句柄
+ * @param stats 输出
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效
+ */
+esp_err_t i2c_bus_get_stats(i2c_bus_device_handle_t dev, i2c_bus_dev_stats_t *stats);
+
+/**
+ * @brief 获取总线复位次数
+ */
+uint32_t i2c_bus_get_reset_count(void);
+
+/**
+ * @brief 输出所有设备统计
+ */
+void i2c_bus_dump_stats(void);
+
+#endif /* __I2C_BUS_H__ */
@@ -0,0 +1,23 @@
+#ifndef __I2C_BUS_CONFIG_H__
+#define __I2C_BUS_CONFIG_H__
+
+/* ================= I2C Hardware Config ================= */
+#define I2C_BUS_PORT                    I2C_NUM_0       // I2C 端口号
+#define I2C_BUS_SDA_PIN                 1               // SDA 引脚
+#define I2C_BUS_SCL_PIN                 0               // SCL 引脚
+#define I2C_BUS_GLITCH_IGNORE_CNT       7               // 毛刺忽略计数
+#define I2C_BUS_INTERNAL_PULLUP         1               // 使能内部上拉（外部已有上拉时可关闭）
+
+/* ================= Transfer Policy ================= */
+#define I2C_BUS_MAX_DEVICES             (4)             // 总线上最多挂载的设备数
+#define I2C_BUS_TIMEOUT_MS              (50)            // 单次传输超时（400kHz 下 384 字节突发读约 10ms）
+#define I2C_BUS_DEFAULT_RETRIES         (2)             // 失败后重试次数（不含首次）
+#define I2C_BUS_BACKOFF_BASE_MS         (1)             // 首次重试前等待，之后逐次翻倍
+#define I2C_BUS_BACKOFF_MAX_MS          (20)            // 重试等待上限
+#define I2C_BUS_RESET_THRESHOLD         (3)             // 连续失败次数达到该值时复位总线（9 个 SCL 脉冲释放 SDA）
+
+/* ================= Async Queue ================= */
+#define I2C_BUS_QUEUE_LEN               (8)             // 异步事务队列长度
+/* 事务执行任务核心/优先级/栈大小见 sys_task_config.h */
+
+#endif /* __I2C_BUS_CONFIG_H__ */
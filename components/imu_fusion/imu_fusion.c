@@ -0,0 +1,184 @@
+#include "imu_fusion.h"
+#include <math.h>
+#include <stddef.h>
+
+#define RAD_TO_DEG  57.29577951f
+
+static inline float _inv_norm3(float x, float y, float z)
+{
+    float n = x * x + y * y + z * z;
+    return (n > 0.0f) ? 1.0f / sqrtf(n) : 0.0f;
+}
+
+static inline void _quat_normalize(imu_fusion_quat_t *q)
+{
+    float n = q->w * q->w + q->x * q->x + q->y * q->y + q->z * q->z;
+    if (n <= 0.0f) {
+        q->w = 1.0f;
+        q->x = q->y = q->z = 0.0f;
+        return;
+    }
+    float r = 1.0f / sqrtf(n);
+    q->w *= r;
+    q->x *= r;
+    q->y *= r;
+    q->z *= r;
+}
+
+void imu_fusion_init(imu_fusion_t *f, imu_fusion_algo_t algo, float sample_rate_hz)
+{
+    if (f == NULL) return;
+
+    f->algo = algo;
+    f->dt = (sample_rate_hz > 0.0f) ? 1.0f / sample_rate_hz : 0.0f;
+    f->gain = (algo == IMU_FUSION_MADGWICK) ? IMU_FUSION_DEFAULT_BETA : IMU_FUSION_DEFAULT_KP;
+    f->q.w = 1.0f;
+    f->q.x = f->q.y = f->q.z = 0.0f;
+}
+
+void imu_fusion_set_gain(imu_fusion_t *f, float gain)
+{
+    if (f == NULL) return;
+    f->gain = gain;
+}
+
+void imu_fusion_set_rate(imu_fusion_t *f, float sample_rate_hz)
+{
+    if (f == NULL) return;
+    f->dt = (sample_rate_hz > 0.0f) ? 1.0f / sample_rate_hz : 0.0f;
+}
+
+void imu_fusion_align(imu_fusion_t *f, float ax, float ay, float az)
+{
+    if (f == NULL) return;
+
+    float r = _inv_norm3(ax, ay, az);
+    if (r == 0.0f) return;
+
+    // 重力方向 -> 横滚/俯仰，偏航为 0
+    float roll = atan2f(ay, az);
+    float pitch = atan2f(-ax, sqrtf(ay * ay + az * az));
+    float cr = cosf(roll * 0.5f), sr = sinf(roll * 0.5f);
+    float cp = cosf(pitch * 0.5f), sp = sinf(pitch * 0.5f);
+
+    f->q.w = cr * cp;
+    f->q.x = sr * cp;
+    f->q.y = cr * sp;
+    f->q.z = -sr * sp;
+}
+
+// 互补滤波：估计重力方向与实测加速度方向的叉积作为角速度修正
+static void _fusion_complementary(imu_fusion_t *f, float gx, float gy, float gz, float ax, float ay, float az)
+{
+    imu_fusion_quat_t *q = &f->q;
+    float r = _inv_norm3(ax, ay, az);
+
+    if (r != 0.0f) {
+        ax *= r;
+        ay *= r;
+        az *= r;
+
+        // 机体系下的估计重力方向（旋转矩阵第三行）
+        float vx = 2.0f * (q->x * q->z - q->w * q->y);
+        float vy = 2.0f * (q->w * q->x + q->y * q->z);
+        float vz = q->w * q->w - q->x * q->x - q->y * q->y + q->z * q->z;
+
+        float ex = ay * vz - az * vy;
+        float ey = az * vx - ax * vz;
+        float ez = ax * vy - ay * vx;
+
+        gx += f->gain * ex;
+        gy += f->gain * ey;
+        gz += f->gain * ez;
+    }
+
+    // q += 0.5 * q ⊗ (0, g) * dt
+    float h = 0.5f * f->dt;
+    gx *= h;
+    gy *= h;
+    gz *= h;
+    float qw = q->w, qx = q->x, qy = q->y, qz = q->z;
+    q->w += -qx * gx - qy * gy - qz * gz;
+    q->x += qw * gx + qy * gz - qz * gy;
+    q->y += qw * gy - qx * gz + qz * gx;
+    q->z += qw * gz + qx * gy - qy * gx;
+
+    _quat_normalize(q);
+}
+
+// Madgwick IMU：沿目标函数梯度方向修正陀螺仪积分
+static void _fusion_madgwick(imu_fusion_t *f, float gx, float gy, float gz, float ax, float ay, float az)
+{
+    imu_fusion_quat_t *q = &f->q;
+    float qw = q->w, qx = q->x, qy = q->y, qz = q->z;
+
+    // 陀螺仪四元数导数
+    float dw = 0.5f * (-qx * gx - qy * gy - qz * gz);
+    float dx = 0.5f * (qw * gx + qy * gz - qz * gy);
+    float dy = 0.5f * (qw * gy - qx * gz + qz * gx);
+    float dz = 0.5f * (qw * gz + qx * gy - qy * gx);
+
+    float r = _inv_norm3(ax, ay, az);
+    if (r != 0.0f) {
+        ax *= r;
+        ay *= r;
+        az *= r;
+
+        float _2qw = 2.0f * qw, _2qx = 2.0f * qx, _2qy = 2.0f * qy, _2qz = 2.0f * qz;
+        float _4qw = 4.0f * qw, _4qx = 4.0f * qx, _4qy = 4.0f * qy;
+        float _8qx = 8.0f * qx, _8qy = 8.0f * qy;
+        float qwqw = qw * qw, qxqx = qx * qx, qyqy = qy * qy, qzqz = qz * qz;
+
+        float sw = _4qw * qyqy + _2qy * ax + _4qw * qxqx - _2qx * ay;
+        float sx = _4qx * qzqz - _2qz * ax + 4.0f * qwqw * qx - _2qw * ay - _4qx + _8qx * qxqx + _8qx * qyqy + _4qx * az;
+        float sy = 4.0f * qwqw * qy + _2qw * ax + _4qy * qzqz - _2qz * ay - _4qy + _8qy * qxqx + _8qy * qyqy + _4qy * az;
+        float sz = 4.0f * qxqx * qz - _2qx * ax + 4.0f * qyqy * qz - _2qy * ay;
+
+        float n = sw * sw + sx * sx + sy * sy + sz * sz;
+        if (n > 0.0f) {
+            float rn = f->gain / sqrtf(n);
+            dw -= rn * sw;
+            dx -= rn * sx;
+            dy -= rn * sy;
+            dz -= rn * sz;
+        }
+    }
+
+    q->w = qw + dw * f->dt;
+    q->x = qx + dx * f->dt;
+    q->y = qy + dy * f->dt;
+    q->z = qz + dz * f->dt;
+
+    _quat_normalize(q);
+}
+
+void imu_fusion_update(imu_fusion_t *f, float gx, float gy, float gz, float ax, float ay, float az)
+{
+    if (f == NULL) return;
+
+    if (f->algo == IMU_FUSION_MADGWICK) {
+        _fusion_madgwick(f, gx, gy, gz, ax, ay, az);
+    } else {
+        _fusion_complementary(f, gx, gy, gz, ax, ay, az);
+    }
+}
+
+void imu_fusion_quat_to_euler(const imu_fusion_quat_t *q, float *yaw, float *pitch, float *roll)
+{
+    if (q == NULL) return;
+
+    if (yaw) {
+        *yaw = atan2f(2.0f * (q->w * q->z + q->x * q->y),
+                      1.0f - 2.0f * (q->y * q->y + q->z * q->z)) * RAD_TO_DEG;
+    }
+    if (pitch) {
+        float s = 2.0f * (q->w * q->y - q->z * q->x);
+        if (s > 1.0f) s = 1.0f;
+        if (s < -1.0f) s = -1.0f;
+        *pitch = asinf(s) * RAD_TO_DEG;
+    }
+    if (roll) {
+        *roll = atan2f(2.0f * (q->w * q->x + q->y * q->z),
+                       1.0f - 2.0f * (q->x * q->x + q->y * q->y)) * RAD_TO_DEG;
+    }
+}
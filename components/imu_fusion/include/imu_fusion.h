@@ -0,0 +1,91 @@
+#ifndef __IMU_FUSION_H__
+#define __IMU_FUSION_H__
+
+/*
+ * 六轴姿态融合（加速度计 + 陀螺仪），四元数状态，固定步长，单精度浮点。
+ * 纯 C 实现，不依赖 ESP-IDF，可直接在主机上编译（见 tools/imu_fusion_bench.c）。
+ *
+ * 没有磁力计，偏航角只能由陀螺仪积分得到，长期会漂移；俯仰/横滚由重力方向校正。
+ */
+
+#include <stdint.h>
+
+/* ================= Default Gains ================= */
+#define IMU_FUSION_DEFAULT_BETA         0.1f        // Madgwick 梯度下降步长
+#define IMU_FUSION_DEFAULT_KP           1.0f        // 互补滤波加速度校正增益（1/s）
+
+/**
+ * @brief 融合算法
+ */
+typedef enum {
+    IMU_FUSION_COMPLEMENTARY = 0,   // 四元数互补滤波（加速度误差比例反馈到角速度）
+    IMU_FUSION_MADGWICK,            // Madgwick 梯度下降（IMU 版本）
+} imu_fusion_algo_t;
+
+/**
+ * @brief 单位四元数（w 为实部）
+ */
+typedef struct {
+    float w;
+    float x;
+    float y;
+    float z;
+} imu_fusion_quat_t;
+
+/**
+ * @brief 融合状态
+ */
+typedef struct {
+    imu_fusion_algo_t algo;
+    float dt;                   // 固定步长（秒）
+    float gain;                 // Madgwick: beta；互补滤波: kp
+    imu_fusion_quat_t q;        // 当前姿态（机体系 -> 世界系）
+} imu_fusion_t;
+
+/**
+ * @brief 初始化融合状态（姿态复位为单位四元数，增益取默认值）
+ * @param f 融合状态
+ * @param algo 算法
+ * @param sample_rate_hz 采样率（固定步长 = 1 / sample_rate_hz）
+ */
+void imu_fusion_init(imu_fusion_t *f, imu_fusion_algo_t algo, float sample_rate_hz);
+
+/**
+ * @brief 设置滤波增益
+ * @param f 融合状态
+ * @param gain Madgwick 为 beta，互补滤波为 kp
+ */
+void imu_fusion_set_gain(imu_fusion_t *f, float gain);
+
+/**
+ * @brief 更新采样率（姿态保持不变，只改变固定步长）
+ * @param f 融合状态
+ * @param sample_rate_hz 采样率
+ */
+void imu_fusion_set_rate(imu_fusion_t *f, float sample_rate_hz);
+
+/**
+ * @brief 用加速度方向直接初始化俯仰/横滚（偏航置 0），避免上电后缓慢收敛
+ * @param f 融合状态
+ * @param ax,ay,az 加速度（任意单位）
+ */
+void imu_fusion_align(imu_fusion_t *f, float ax, float ay, float az);
+
+/**
+ * @brief 推进一个固定步长
+ * @param f 融合状态
+ * @param gx,gy,gz 角速度（rad/s）
+ * @param ax,ay,az 加速度（任意单位，内部归一化；全 0 时只积分陀螺仪）
+ */
+void imu_fusion_update(imu_fusion_t *f, float gx, float gy, float gz, float ax, float ay, float az);
+
+/**
+ * @brief 四元数转欧拉角（ZYX 顺序，单位：度）
+ * @param q 四元数
+ * @param yaw 偏航（绕 Z，可为 NULL）
+ * @param pitch 俯仰（绕 Y，可为 NULL）
+ * @param roll 横滚（绕 X，可为 NULL）
+ */
+void imu_fusion_quat_to_euler(const imu_fusion_quat_t *q, float *yaw, float *pitch, float *roll);
+
+#endif /* __IMU_FUSION_H__ */
@@ -4,6 +4,7 @@
 #include "esp_err.h"
 #include <stdbool.h>
 #include <stdint.h>
+#include <stddef.h>
 
 /**
  * @brief MPU6050 原始传感器数据结构
@@ -29,6 +30,30 @@ typedef struct {
     float gyro_z;      // 陀螺仪 Z 轴（°/s）
 } mpu6050_data_t;
 
+/**
+ * @brief 批量转换输出（结构体数组，每个通道一段连续数组，长度不小于转换个数）
+ */
+typedef struct {
+    float *accel_x;    // 加速度 X 轴（m/s²）
+    float *accel_y;
+    float *accel_z;
+    float *gyro_x;     // 陀螺仪 X 轴（°/s，已减零偏）
+    float *gyro_y;
+    float *gyro_z;
+} mpu6050_data_soa_t;
+
+/**
+ * @brief 批量定点转换输出（整数单位，适合无需浮点的后级）
+ */
+typedef struct {
+    int32_t *accel_x;  // 加速度 X 轴（mm/s²）
+    int32_t *accel_y;
+    int32_t *accel_z;
+    int32_t *gyro_x;   // 陀螺仪 X 轴（m°/s，已减零偏）
+    int32_t *gyro_y;
+    int32_t *gyro_z;
+} mpu6050_data_fixed_soa_t;
+
 /**
  * @brief 陀螺仪零偏校准数据结构
  */
@@ -38,6 +63,37 @@ typedef struct {
     int16_t gyro_z_bias;   // Z 轴零偏
 } mpu6050_gyro_bias_t;
 
+/**
+ * @brief 运行配置档位（参数见 mpu6050_config.h）
+ */
+typedef enum {
+    MPU6050_PROFILE_LOW_POWER = 0,  // 50Hz，窄带宽，省电
+    MPU6050_PROFILE_TRACKING,       // 500Hz，姿态跟踪
+    MPU6050_PROFILE_GESTURE,        // 1kHz，大量程，手势识别
+    MPU6050_PROFILE_MAX
+} mpu6050_profile_t;
+
+/**
+ * @brief 配置档位描述
+ */
+typedef struct {
+    const char *name;       // 档位名
+    uint16_t rate_hz;       // 采样率
+    uint8_t dlpf_cfg;       // CONFIG 寄存器 DLPF_CFG（1-6）
+    uint8_t gyro_range;     // 陀螺仪量程寄存器值
+    uint8_t accel_range;    // 加速度计量程寄存器值
+} mpu6050_profile_desc_t;
+
+/**
+ * @brief 换算组信息（采样按采集时的换算组编号标记）
+ */
+typedef struct {
+    uint8_t gyro_range;         // 陀螺仪量程寄存器值
+    uint8_t accel_range;        // 加速度计量程寄存器值
+    float gyro_sensitivity;     // LSB/°/s
+    float accel_sensitivity;    // LSB/g
+} mpu6050_scale_info_t;
+
 /**
  * @brief 初始化 MPU6050 驱动
  * 
@@ -69,6 +125,66 @@ esp_err_t mpu6050_read_raw_data(mpu6050_raw_data_t *data);
  */
 esp_err_t mpu6050_convert_data(const mpu6050_raw_data_t *raw_data, mpu6050_data_t *data);
 
+/**
+ * @brief 按指定换算组将原始数据转换为物理单位（用于带编号的缓冲采样，量程切换前后都能正确换算）
+ *
+ * @param raw_data 原始数据
+ * @param scale_id 采集时的换算组编号（mpu6050_get_scale_id）
+ * @param data 输出
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效
+ */
+esp_err_t mpu6050_convert_data_scaled(const mpu6050_raw_data_t *raw_data, uint8_t scale_id, mpu6050_data_t *data);
+
+/**
+ * @brief 批量将原始数据转换为物理单位（预计算倒数系数与零偏，循环内只有乘加）
+ *
+ * @param raw 第一个原始数据
+ * @param stride 相邻原始数据间隔（字节，0 表示紧密排列；可直接遍历 mpu6050_sample_t 数组中的 raw）
+ * @param count 个数
+ * @param out 输出（各通道数组）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效
+ */
+esp_err_t mpu6050_convert_batch(const mpu6050_raw_data_t *raw, size_t stride, size_t count,
+                                const mpu6050_data_soa_t *out);
+
+/**
+ * @brief 按指定换算组批量转换（同一段采样须属于同一换算组）
+ *
+ * @param raw 第一个原始数据
+ * @param stride 相邻原始数据间隔（字节，0 表示紧密排列）
+ * @param count 个数
+ * @param scale_id 采集时的换算组编号
+ * @param out 输出（各通道数组）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效
+ */
+esp_err_t mpu6050_convert_batch_scaled(const mpu6050_raw_data_t *raw, size_t stride, size_t count,
+                                       uint8_t scale_id, const mpu6050_data_soa_t *out);
+
+/**
+ * @brief 批量将原始数据转换为定点物理单位（mm/s²、m°/s，Q16 系数整数乘法）
+ *
+ * @param raw 第一个原始数据
+ * @param stride 相邻原始数据间隔（字节，0 表示紧密排列）
+ * @param count 个数
+ * @param out 输出（各通道数组）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效
+ */
+esp_err_t mpu6050_convert_batch_fixed(const mpu6050_raw_data_t *raw, size_t stride, size_t count,
+                                      const mpu6050_data_fixed_soa_t *out);
+
+/**
+ * @brief 按指定换算组批量转换为定点物理单位（同一段采样须属于同一换算组）
+ *
+ * @param raw 第一个原始数据
+ * @param stride 相邻原始数据间隔（字节，0 表示紧密排列）
+ * @param count 个数
+ * @param scale_id 采集时的换算组编号
+ * @param out 输出（各通道数组）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效
+ */
+esp_err_t mpu6050_convert_batch_fixed_scaled(const mpu6050_raw_data_t *raw, size_t stride, size_t count,
+                                             uint8_t scale_id, const mpu6050_data_fixed_soa_t *out);
+
 /**
  * @brief 读取 MPU6050 转换后的数据（物理单位）
  * 
@@ -86,6 +202,37 @@ esp_err_t mpu6050_read_data(mpu6050_data_t *data);
  */
 esp_err_t mpu6050_calibrate_gyro(mpu6050_gyro_bias_t *bias, uint16_t samples);
 
+/**
+ * @brief 设置陀螺仪零偏（如从 NVS 恢复或后台静止校准结果），立即作用于后续换算
+ * 
+ * @param bias 零偏（当前陀螺仪量程下的原始 LSB）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效
+ */
+esp_err_t mpu6050_set_gyro_bias(const mpu6050_gyro_bias_t *bias);
+
+/**
+ * @brief 按物理单位设置陀螺仪零偏（与量程无关，各换算组按自身灵敏度换算为 LSB）
+ *
+ * @param dps 三轴零偏（°/s）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效，ESP_ERR_INVALID_STATE 未初始化
+ */
+esp_err_t mpu6050_set_gyro_bias_dps(const float dps[3]);
+
+/**
+ * @brief 清除陀螺仪零偏，恢复为未校准状态
+ *
+ * @return ESP_OK 成功，ESP_ERR_INVALID_STATE 未初始化
+ */
+esp_err_t mpu6050_clear_gyro_bias(void);
+
+/**
+ * @brief 获取当前陀螺仪零偏
+ * 
+ * @param bias 输出（当前陀螺仪量程下的原始 LSB）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效，ESP_ERR_INVALID_STATE 尚未校准
+ */
+esp_err_t mpu6050_get_gyro_bias(mpu6050_gyro_bias_t *bias);
+
 /**
  * @brief 设置陀螺仪量程
  * 
@@ -116,6 +263,103 @@ float mpu6050_get_gyro_sensitivity(void);
  */
 float mpu6050_get_accel_sensitivity(void);
 
+/**
+ * @brief 设置采样率（同时开启 DLPF，陀螺仪输出率 1kHz，采样率 = 1000 / (1 + SMPLRT_DIV)）
+ *
+ * @param rate_hz 采样率（4-1000Hz）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效，其他值表示失败
+ */
+esp_err_t mpu6050_set_sample_rate(uint16_t rate_hz);
+
+/**
+ * @brief 获取配置档位描述
+ *
+ * @param profile 档位
+ * @return 描述指针，档位无效时返回 NULL
+ */
+const mpu6050_profile_desc_t *mpu6050_get_profile_desc(mpu6050_profile_t profile);
+
+/**
+ * @brief 切换配置档位：在配置锁内依次写入 DLPF、采样率分频和量程，再一次性切换换算系数
+ *
+ * 已在 FIFO 中的旧帧仍按旧量程采集，需要逐帧区分时由调用方在切换后复位 FIFO
+ * （mpu6050_task_set_profile 会在采集任务中完成）。
+ *
+ * @param profile 档位
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效，ESP_ERR_INVALID_STATE 未初始化，其他值表示写入失败
+ */
+esp_err_t mpu6050_apply_profile(mpu6050_profile_t profile);
+
+/**
+ * @brief 获取当前换算组编号（量程或零偏每变化一次递增，采样入队时记录）
+ *
+ * @return 换算组编号
+ */
+uint8_t mpu6050_get_scale_id(void);
+
+/**
+ * @brief 获取换算组对应的量程与灵敏度
+ *
+ * @param scale_id 换算组编号
+ * @param info 输出
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效，ESP_ERR_NOT_FOUND 编号未使用
+ */
+esp_err_t mpu6050_get_scale_info(uint8_t scale_id, mpu6050_scale_info_t *info);
+
+/**
+ * @brief 两个换算组的量程是否相同（只有零偏不同的组，原始值可按同一量程解读）
+ *
+ * @param a 换算组编号
+ * @param b 换算组编号
+ * @return true 量程相同
+ */
+bool mpu6050_scale_same_range(uint8_t a, uint8_t b);
+
+/**
+ * @brief 开启/关闭硬件 FIFO（加速度计 + 陀螺仪，每帧 12 字节），开启时先复位 FIFO
+ *
+ * @param enable true 开启，false 关闭
+ * @return ESP_OK 成功，其他值表示失败
+ */
+esp_err_t mpu6050_fifo_enable(bool enable);
+
+/**
+ * @brief 复位 FIFO（丢弃未读数据）
+ *
+ * @return ESP_OK 成功，其他值表示失败
+ */
+esp_err_t mpu6050_fifo_reset(void);
+
+/**
+ * @brief 读取 FIFO 中的字节数
+ *
+ * @param count 输出字节数
+ * @return ESP_OK 成功，其他值表示失败
+ */
+esp_err_t mpu6050_fifo_get_count(uint16_t *count);
+
+/**
+ * @brief 从 FIFO 突发读取完整帧（按时间先后排列）
+ *
+ * FIFO 溢出或帧未对齐时自动复位 FIFO 并返回 ESP_ERR_INVALID_SIZE，本次数据丢弃。
+ *
+ * @param data 输出数组
+ * @param max_count 数组容量（帧数）
+ * @param out_count 实际读取帧数
+ * @return ESP_OK 成功，ESP_ERR_INVALID_SIZE FIFO 溢出已复位，其他值表示失败
+ */
+esp_err_t mpu6050_fifo_read(mpu6050_raw_data_t *data, size_t max_count, size_t *out_count);
+
+/**
+ * @brief 开启/关闭 DATA_RDY 中断输出（INT 引脚每个采样输出一个 50us 高脉冲）
+ *
+ * MPU6050 没有 FIFO 水位中断，FIFO 模式下由调用方对脉冲计数后批量读取。
+ *
+ * @param enable true 开启，false 关闭
+ * @return ESP_OK 成功，其他值表示失败
+ */
+esp_err_t mpu6050_int_enable(bool enable);
+
 /**
  * @brief 计算角度变化（通过积分）
  * 
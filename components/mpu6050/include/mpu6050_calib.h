@@ -0,0 +1,63 @@
+#ifndef __MPU6050_CALIB_H__
+#define __MPU6050_CALIB_H__
+
+#include "mpu6050_task.h"
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * 陀螺仪后台零偏校准：
+ *   - 启动时从 NVS 恢复上次零偏，采样立即开始，不再阻塞等待静止
+ *   - 消费者每取出一段采样送入静止检测，窗口内陀螺仪/加速度计波动都很小时视为静止，
+ *     以窗口均值更新零偏（首次直接采用，之后按比例平滑）
+ *   - 零偏以 m°/s 存储（与量程无关），变化超过阈值且距上次写入足够久时才写 NVS，限制 Flash 擦写
+ *
+ * 局限：绕竖直轴匀速慢转时加速度计看不出变化，可能被误判为静止，平滑更新可减小影响。
+ */
+
+/* ================= NVS ================= */
+#define MPU6050_CALIB_NVS_NAMESPACE     "mpu6050"
+#define MPU6050_CALIB_NVS_KEY_X         "gbias_x"       // 单位 m°/s
+#define MPU6050_CALIB_NVS_KEY_Y         "gbias_y"
+#define MPU6050_CALIB_NVS_KEY_Z         "gbias_z"
+
+/* ================= Still Detection ================= */
+#define MPU6050_CALIB_WINDOW_MS         (1000)          // 静止检测窗口
+#define MPU6050_CALIB_GYRO_SPAN_DPS     (2.0f)          // 窗口内各轴陀螺仪峰峰值上限（°/s）
+#define MPU6050_CALIB_ACCEL_SPAN_G      (0.05f)         // 窗口内各轴加速度峰峰值上限（g）
+#define MPU6050_CALIB_MAX_BIAS_DPS      (10.0f)         // 零偏合理范围，超出视为在转动
+#define MPU6050_CALIB_BLEND             (0.25f)         // 已有零偏时向新窗口均值靠拢的比例
+
+/* ================= Persistence ================= */
+#define MPU6050_CALIB_SAVE_DELTA_MDPS   (100)           // 任一轴变化超过该值才写入（m°/s）
+#define MPU6050_CALIB_SAVE_INTERVAL_S   (600)           // 两次写入最小间隔（秒）
+
+/**
+ * @brief 从 NVS 恢复陀螺仪零偏（需在 mpu6050_init 之后、NVS 初始化之后调用）
+ *
+ * @return ESP_OK 已恢复，ESP_ERR_NVS_NOT_FOUND 尚未保存过，其他值表示 NVS 不可用
+ */
+esp_err_t mpu6050_calib_load(void);
+
+/**
+ * @brief 送入一段连续采样做静止检测（仅在消费者任务中调用）
+ *
+ * @param samples 采样（时间顺序）
+ * @param count 个数
+ */
+void mpu6050_calib_feed(const mpu6050_sample_t *samples, size_t count);
+
+/**
+ * @brief 立即把当前零偏写入 NVS（忽略变化阈值与写入间隔）
+ *
+ * @return ESP_OK 成功，ESP_ERR_INVALID_STATE 尚未校准或 NVS 未初始化，其他值表示写入失败
+ */
+esp_err_t mpu6050_calib_save(void);
+
+/**
+ * @brief 启动以来是否已有可用零偏（NVS 恢复或后台校准）
+ */
+bool mpu6050_calib_is_valid(void);
+
+#endif /* __MPU6050_CALIB_H__ */
@@ -2,12 +2,10 @@
 #define __MPU6050_CONFIG_H__
 
 /* ================= I2C Hardware Config ================= */
-#define MPU6050_I2C_PORT                I2C_NUM_0       // I2C 端口号
-#define MPU6050_SDA_PIN                 1               // SDA 引脚
-#define MPU6050_SCL_PIN                 0               // SCL 引脚
+/* 总线端口与引脚由 i2c_bus 统一配置（i2c_bus_config.h） */
 #define MPU6050_I2C_ADDR                0x68            // I2C 从地址
 #define MPU6050_I2C_CLK_SPEED           400000U         // I2C 时钟频率 (400kHz)
-#define MPU6050_I2C_GLITCH_IGNORE_CNT   7               // 毛刺忽略计数
+#define MPU6050_INT_PIN                 2               // INT 引脚（DATA_RDY 中断输出）
 
 /* ================= Sensor Sensitivity ================= */
 #define MPU6050_GYRO_LSB_PER_DPS        131.0f          // 陀螺仪灵敏度 (±250°/s)
@@ -54,6 +52,14 @@
 #define MPU6050_DEFAULT_ACCEL_RANGE     MPU6050_ACCEL_RANGE_2G
 
 /* ================= Register Addresses ================= */
+#define MPU6050_REG_SMPLRT_DIV          0x19            // 采样率分频寄存器
+#define MPU6050_REG_FIFO_EN             0x23            // FIFO 使能寄存器
+#define MPU6050_REG_INT_PIN_CFG         0x37            // 中断引脚配置寄存器
+#define MPU6050_REG_INT_ENABLE          0x38            // 中断使能寄存器
+#define MPU6050_REG_INT_STATUS          0x3A            // 中断状态寄存器
+#define MPU6050_REG_FIFO_COUNTH         0x72            // FIFO 计数高字节
+#define MPU6050_REG_FIFO_COUNTL         0x73            // FIFO 计数低字节
+#define MPU6050_REG_FIFO_R_W            0x74            // FIFO 读写寄存器
 #define MPU6050_REG_PWR_MGMT_1          0x6B            // 电源管理寄存器
 #define MPU6050_REG_PWR_MGMT_2          0x6C            // 电源管理寄存器 2
 #define MPU6050_REG_CONFIG              0x1A            // 配置寄存器
@@ -82,9 +88,40 @@
 #define MPU6050_PWR_MGMT_1_WAKEUP       0x00            // 唤醒值
 #define MPU6050_PWR_MGMT_1_SLEEP        (1 << 6)        // 睡眠值
 #define MPU6050_WHO_AM_I_VALUE          0x68            // 设备 ID 预期值
+#define MPU6050_USER_CTRL_FIFO_EN       (1 << 6)        // FIFO 使能位
+#define MPU6050_USER_CTRL_FIFO_RESET    (1 << 2)        // FIFO 复位位
+#define MPU6050_FIFO_EN_GYRO_XYZ        (0x70)          // XG/YG/ZG 写入 FIFO
+#define MPU6050_FIFO_EN_ACCEL           (1 << 3)        // 加速度计写入 FIFO
+#define MPU6050_INT_STATUS_FIFO_OFLOW   (1 << 4)        // FIFO 溢出标志
+#define MPU6050_INT_STATUS_DATA_RDY     (1 << 0)        // 数据就绪标志
+#define MPU6050_INT_ENABLE_DATA_RDY     (1 << 0)        // 数据就绪中断使能
+#define MPU6050_INT_PIN_CFG_VALUE       0x00            // 高电平有效、推挽、50us 脉冲（不锁存）
+
+/* ================= Sample Rate ================= */
+#define MPU6050_DLPF_CFG                0x01            // 数字低通 184Hz（陀螺仪输出率 1kHz）
+#define MPU6050_GYRO_OUTPUT_RATE_HZ     1000            // DLPF 开启时的陀螺仪输出率
+
+/* ================= Runtime Profiles ================= */
+/* 运行时可切换的配置档位（采样率、DLPF 带宽、量程一起切换），DLPF 取 1-6（陀螺仪输出率 1kHz） */
+#define MPU6050_PROFILE_LOW_POWER_RATE_HZ       50              // 低功耗：低速率，窄带宽
+#define MPU6050_PROFILE_LOW_POWER_DLPF          0x04            // 20Hz
+#define MPU6050_PROFILE_LOW_POWER_GYRO_RANGE    MPU6050_GYRO_RANGE_250
+#define MPU6050_PROFILE_LOW_POWER_ACCEL_RANGE   MPU6050_ACCEL_RANGE_2G
+
+#define MPU6050_PROFILE_TRACKING_RATE_HZ        500             // 姿态跟踪（默认）
+#define MPU6050_PROFILE_TRACKING_DLPF           MPU6050_DLPF_CFG
+#define MPU6050_PROFILE_TRACKING_GYRO_RANGE     MPU6050_DEFAULT_GYRO_RANGE
+#define MPU6050_PROFILE_TRACKING_ACCEL_RANGE    MPU6050_DEFAULT_ACCEL_RANGE
+
+#define MPU6050_PROFILE_GESTURE_RATE_HZ         1000            // 手势：最高速率，大量程容纳快速甩动和敲击
+#define MPU6050_PROFILE_GESTURE_DLPF            0x01            // 184Hz
+#define MPU6050_PROFILE_GESTURE_GYRO_RANGE      MPU6050_GYRO_RANGE_2000
+#define MPU6050_PROFILE_GESTURE_ACCEL_RANGE     MPU6050_ACCEL_RANGE_8G
 
 /* ================= Data Format ================= */
 #define MPU6050_DATA_BYTES(x)           ((x) * 2)       // 数据字节数计算
 #define MPU6050_FULL_DATA_BYTES         14              // 完整数据字节数 (加速度6 + 温度2 + 陀螺仪6)
+#define MPU6050_FIFO_FRAME_BYTES        12              // FIFO 单帧字节数 (加速度6 + 陀螺仪6)
+#define MPU6050_FIFO_SIZE               1024            // 硬件 FIFO 容量
 
 #endif // __MPU6050_CONFIG_H__
@@ -2,18 +2,82 @@
 #define __MPU6050_TASK_H__
 
 #include "freertos/FreeRTOS.h"
-#include "freertos/queue.h"
+#include "spsc_ring.h"
 #include "mpu6050.h"
 #include "esp_err.h"
 
+/* ================= Acquisition Mode ================= */
+#define MPU6050_ACQ_MODE_POLL           0               // 逐次读取数据寄存器（每个采样一次 I2C 事务）
+#define MPU6050_ACQ_MODE_FIFO           1               // 硬件 FIFO 定期突发读取
+
+#ifndef MPU6050_ACQ_MODE
+#define MPU6050_ACQ_MODE                MPU6050_ACQ_MODE_FIFO
+#endif
+
 /* ================= Task Configuration ================= */
-#define MPU6050_QUEUE_LEN               (32)
-#define MPU6050_TASK_STACK_SIZE         (4096)
-#define MPU6050_PRODUCER_TASK_PRIORITY  (5)
-#define MPU6050_CONSUMER_TASK_PRIORITY  (4)
+#define MPU6050_RING_LEN                (128)           // 采样环形缓冲长度（2 的幂）
+#define MPU6050_SAMPLE_PERIOD_MS        (10)            // 轮询模式采样周期（100Hz，受 tick 限制）
+#define MPU6050_DEFAULT_PROFILE         MPU6050_PROFILE_TRACKING    // 启动档位（FIFO 模式 500Hz）
+#define MPU6050_FIFO_READ_PERIOD_MS     (20)            // FIFO 模式读取周期（500Hz 下每次约 10 帧）
+#define MPU6050_FIFO_READ_MAX           (64)            // 单次最多取出帧数（需容纳 1kHz 档位一个周期的帧数）
+
+/* ================= Interrupt Configuration ================= */
+#ifndef MPU6050_INT_ENABLE
+#define MPU6050_INT_ENABLE              1               // 1=INT 引脚 DATA_RDY 中断唤醒生产者，0=定时唤醒
+#endif
+#define MPU6050_INT_TIMEOUT_MS          (MPU6050_FIFO_READ_PERIOD_MS * 3 / 2)   // 超时未收到中断仍读取一次（INT 未接线时退化为定时读取，须在 FIFO 写满前读出）
+#define MPU6050_INT_TS_RING             (128)           // 中断时间戳环形缓冲长度（2 的幂）
+#define MPU6050_INT_RESYNC_TRIES        (4)             // FIFO 复位期间出现脉冲时重试复位的次数
+/* 任务核心/优先级/栈大小见 sys_task_config.h */
+
+/**
+ * @brief 带时间戳的采样（队列元素）
+ */
+typedef struct {
+    int64_t timestamp_us;       // 采样时间（esp_timer_get_time）
+    mpu6050_raw_data_t raw;     // 原始数据
+    uint8_t scale_id;           // 采集时的换算组编号（mpu6050_convert_data_scaled / mpu6050_get_scale_info）
+    uint8_t rate_gen;           // 采样率代号（输出采样率每变化一次递增，固定步长后级据此更新步长）
+} mpu6050_sample_t;
+
+/**
+ * @brief 采样回调（在消费者任务中按时间顺序逐个调用，不应长时间阻塞）
+ * @param sample 采样数据
+ */
+typedef void (*mpu6050_sample_cb_t)(const mpu6050_sample_t *sample);
+
+/**
+ * @brief 批量采样回调（消费者每次取出一段连续采样调用一次，附带已转换的物理量）
+ * @param samples 原始采样（时间顺序）
+ * @param data 与 samples 一一对应的物理量（各通道数组）
+ * @param count 个数
+ */
+typedef void (*mpu6050_batch_cb_t)(const mpu6050_sample_t *samples, const mpu6050_data_soa_t *data, size_t count);
+
+/**
+ * @brief 实时采样回调（在生产者任务中、采样入队前调用，只允许做极短的计算）
+ *
+ * 用于对时延敏感的路径（如姿态），不经过队列，直接拿到最新采样。
+ *
+ * @param sample 采样数据
+ */
+typedef void (*mpu6050_realtime_cb_t)(const mpu6050_sample_t *sample);
 
-/* ================= External Queue Handle ================= */
-extern QueueHandle_t g_mpu6050_queue;
+#define MPU6050_IDLE_WAIT_FOREVER       UINT32_MAX      // 空闲回调返回值：没有待处理的截止时间
+
+/**
+ * @brief 空闲回调（在消费者任务中、每轮等待新采样前调用，与采样回调同一任务，无需加锁）
+ *
+ * 用于在没有新采样时也能按时完成的工作（如按时间刷新部分批次）。
+ *
+ * @param now_us 当前时间（esp_timer_get_time）
+ * @return 距下次需要调用的毫秒数，MPU6050_IDLE_WAIT_FOREVER 表示只在有新采样时再调用
+ */
+typedef uint32_t (*mpu6050_idle_cb_t)(int64_t now_us);
+
+/* ================= External Ring Buffer ================= */
+/* 生产者 -> 消费者采样缓冲（单生产者/单消费者，消费者由任务通知唤醒后一次取完） */
+extern spsc_ring_t *g_mpu6050_ring;
 
 /**
  * @brief 初始化 MPU6050 任务（生产者-消费者模式）
@@ -22,4 +86,54 @@ extern QueueHandle_t g_mpu6050_queue;
  */
 esp_err_t mpu6050_task_init(void);
 
+/**
+ * @brief 设置采样回调（消费者每取出一个采样调用一次）
+ * @param cb 回调函数（NULL 取消）
+ */
+void mpu6050_task_set_sample_cb(mpu6050_sample_cb_t cb);
+
+/**
+ * @brief 设置批量采样回调（消费者按段批量转换后调用）
+ * @param cb 回调函数（NULL 取消）
+ */
+void mpu6050_task_set_batch_cb(mpu6050_batch_cb_t cb);
+
+/**
+ * @brief 设置实时采样回调（生产者每读到一个采样调用一次）
+ * @param cb 回调函数（NULL 取消）
+ */
+void mpu6050_task_set_realtime_cb(mpu6050_realtime_cb_t cb);
+
+/**
+ * @brief 设置空闲回调（消费者按回调返回的时间限时等待新采样，超时也会再次调用）
+ * @param cb 回调函数（NULL 取消）
+ */
+void mpu6050_task_set_idle_cb(mpu6050_idle_cb_t cb);
+
+/**
+ * @brief 切换配置档位（异步：由生产者在两次读取之间应用，之后的采样都带新的换算组编号）
+ *
+ * FIFO 模式下切换时复位 FIFO，旧配置下未读出的少量帧被丢弃。
+ *
+ * @param profile 档位
+ * @return ESP_OK 已提交，ESP_ERR_INVALID_ARG 档位无效，ESP_ERR_INVALID_STATE 任务未初始化
+ */
+esp_err_t mpu6050_task_set_profile(mpu6050_profile_t profile);
+
+/**
+ * @brief 获取当前生效的配置档位
+ */
+mpu6050_profile_t mpu6050_task_get_profile(void);
+
+/**
+ * @brief 获取当前输出采样率（Hz，随档位或回放变化；采样的 rate_gen 变化时重新读取）
+ */
+uint16_t mpu6050_task_get_rate_hz(void);
+
+/**
+ * @brief 获取采样缓冲统计（写入数、溢出丢弃数、最大占用）
+ * @param stats 输出
+ */
+void mpu6050_task_get_ring_stats(spsc_ring_stats_t *stats);
+
 #endif /* __MPU6050_TASK_H__ */
@@ -0,0 +1,143 @@
+#ifndef __MPU6050_TRACE_H__
+#define __MPU6050_TRACE_H__
+
+#include "mpu6050_task.h"
+#include "mpu6050_trace_format.h"
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * IMU 轨迹录制与回放（格式见 mpu6050_trace_format.h）：
+ *   - 录制：消费者每取出一段采样送入录制器，写入 PSRAM 缓冲，或按分片交给输出回调（如 MQTT 发布）
+ *   - 回放：生产者在回放期间不再向后级交付传感器数据，改为按录制时间节奏交付轨迹中的采样，
+ *           量程与零偏切换为轨迹头部记录的值，结束后恢复当前档位与零偏
+ * 回放期间暂停后台零偏校准，避免用回放数据更新零偏。
+ */
+
+/* ================= Recorder Config ================= */
+#define MPU6050_TRACE_CHUNK_RECORDS     (64)            // 流式录制每个分片的记录数（1KB）
+
+/**
+ * @brief 流式录制输出回调（在消费者任务中调用，返回后数据即失效）
+ *
+ * 第一次调用传入头部，之后每次传入一个分片的记录；依次拼接即为完整轨迹文件。
+ *
+ * @param data 数据
+ * @param len 长度
+ */
+typedef void (*mpu6050_trace_sink_cb_t)(const void *data, size_t len);
+
+/**
+ * @brief 录制状态
+ */
+typedef enum {
+    MPU6050_TRACE_REC_IDLE = 0,     // 未录制
+    MPU6050_TRACE_REC_ARMED,        // 已启动，等待下一个采样写入头部
+    MPU6050_TRACE_REC_RUNNING,      // 录制中
+    MPU6050_TRACE_REC_STOPPING,     // 已请求停止，等待消费者收尾
+    MPU6050_TRACE_REC_DONE,         // 已结束（PSRAM 录制可取出轨迹）
+} mpu6050_trace_rec_state_t;
+
+/**
+ * @brief 回放状态
+ */
+typedef enum {
+    MPU6050_TRACE_REPLAY_IDLE = 0,  // 未回放
+    MPU6050_TRACE_REPLAY_PENDING,   // 已提交，等待生产者切换
+    MPU6050_TRACE_REPLAY_ACTIVE,    // 回放中
+    MPU6050_TRACE_REPLAY_DONE,      // 已结束或被停止，等待生产者恢复
+} mpu6050_trace_replay_state_t;
+
+/**
+ * @brief 开始录制
+ *
+ * @param max_samples 最多录制的采样数（PSRAM 录制时决定缓冲大小，须大于 0；流式录制为 0 表示不限）
+ * @param sink 流式输出回调，NULL 表示录制到 PSRAM
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效，ESP_ERR_INVALID_STATE 正在录制，ESP_ERR_NO_MEM PSRAM 不足
+ */
+esp_err_t mpu6050_trace_record_start(uint32_t max_samples, mpu6050_trace_sink_cb_t sink);
+
+/**
+ * @brief 停止录制（异步：由消费者在下一段采样时收尾，流式录制会输出剩余分片）
+ *
+ * @return ESP_OK 已请求，ESP_ERR_INVALID_STATE 未在录制
+ */
+esp_err_t mpu6050_trace_record_stop(void);
+
+/**
+ * @brief 获取录制状态
+ */
+mpu6050_trace_rec_state_t mpu6050_trace_record_state(void);
+
+/**
+ * @brief 取出 PSRAM 录制结果（录制结束后有效，直到 mpu6050_trace_record_free 或下次录制）
+ *
+ * @param data 输出轨迹首地址（头部 sample_count 已填写）
+ * @param len 输出长度
+ * @return ESP_OK 成功，ESP_ERR_INVALID_STATE 未结束或为流式录制
+ */
+esp_err_t mpu6050_trace_record_get(const void **data, size_t *len);
+
+/**
+ * @brief 释放录制缓冲（录制中调用返回 ESP_ERR_INVALID_STATE）
+ */
+esp_err_t mpu6050_trace_record_free(void);
+
+/**
+ * @brief 送入一段连续采样（仅在消费者任务中调用）
+ *
+ * @param samples 采样（时间顺序）
+ * @param count 个数
+ */
+void mpu6050_trace_feed(const mpu6050_sample_t *samples, size_t count);
+
+/**
+ * @brief 开始回放（不拷贝数据，回放结束前 trace 须保持有效）
+ *
+ * @param trace 轨迹文件数据
+ * @param len 长度
+ * @param loop 播完后从头循环
+ * @return ESP_OK 已提交，ESP_ERR_INVALID_ARG 格式无效，ESP_ERR_INVALID_STATE 正在回放
+ */
+esp_err_t mpu6050_trace_replay_start(const void *trace, size_t len, bool loop);
+
+/**
+ * @brief 停止回放（异步：生产者下次唤醒时恢复传感器数据）
+ */
+void mpu6050_trace_replay_stop(void);
+
+/**
+ * @brief 获取回放状态
+ */
+mpu6050_trace_replay_state_t mpu6050_trace_replay_state(void);
+
+/**
+ * @brief 是否正在回放（含等待切换与恢复）
+ */
+bool mpu6050_trace_replay_active(void);
+
+/**
+ * @brief 切换到回放：按轨迹头部设置量程与零偏（仅在生产者任务中、状态为 PENDING 时调用）
+ *
+ * @param now_us 当前时间，作为回放时间起点
+ * @param rate_hz 输出轨迹采样率
+ * @return ESP_OK 成功，其他值表示量程设置失败（回放已取消）
+ */
+esp_err_t mpu6050_trace_replay_begin(int64_t now_us, uint16_t *rate_hz);
+
+/**
+ * @brief 取出下一个到期的回放采样（仅在生产者任务中调用）
+ *
+ * @param out 输出采样（时间戳换算为设备时间，换算组为当前换算组）
+ * @param now_us 当前时间
+ * @return true 有到期采样，false 尚未到期或已播完（播完后状态变为 DONE）
+ */
+bool mpu6050_trace_replay_next(mpu6050_sample_t *out, int64_t now_us);
+
+/**
+ * @brief 结束回放：恢复回放前的零偏（生产者恢复档位之后调用）
+ */
+void mpu6050_trace_replay_finish(void);
+
+#endif /* __MPU6050_TRACE_H__ */
@@ -0,0 +1,55 @@
+#ifndef __MPU6050_TRACE_FORMAT_H__
+#define __MPU6050_TRACE_FORMAT_H__
+
+/*
+ * IMU 轨迹文件格式（设备录制、设备回放与主机工具共用，只依赖 stdint）
+ *
+ * 小端序，文件 = 头部 + 连续记录：
+ *   - 头部记录录制时的量程、灵敏度、零偏与采样率，回放时据此恢复换算
+ *   - 记录为传感器原始值（未减零偏），时间为相对首个采样的偏移
+ *   - 一条轨迹只有一个换算组，录制中途切换量程会结束录制
+ *   - sample_count 为 0 表示流式录制（经 MQTT 分片发送），记录数由文件长度推算
+ */
+
+#include <stdint.h>
+
+#define MPU6050_TRACE_MAGIC             0x54554D49u     // "IMUT"
+#define MPU6050_TRACE_VERSION           1
+
+#define MPU6050_TRACE_FLAG_BIAS_VALID   (1U << 0)       // gyro_bias 有效
+
+/**
+ * @brief 轨迹头部（48 字节）
+ */
+typedef struct {
+    uint32_t magic;             // MPU6050_TRACE_MAGIC
+    uint16_t version;           // MPU6050_TRACE_VERSION
+    uint16_t header_bytes;      // 头部长度（新版本可追加字段，读取方按此跳过）
+    uint16_t record_bytes;      // 单条记录长度
+    uint16_t rate_hz;           // 录制时的输出采样率
+    uint8_t profile;            // 录制时的配置档位（mpu6050_profile_t）
+    uint8_t gyro_range;         // 陀螺仪量程寄存器值
+    uint8_t accel_range;        // 加速度计量程寄存器值
+    uint8_t reserved0;
+    float gyro_sensitivity;     // LSB/°/s
+    float accel_sensitivity;    // LSB/g
+    int16_t gyro_bias[3];       // 陀螺仪零偏（录制量程下的原始 LSB）
+    uint16_t flags;             // MPU6050_TRACE_FLAG_*
+    int64_t start_us;           // 首个采样的设备时间
+    uint32_t sample_count;      // 记录数（0 表示未知）
+    uint32_t reserved1;
+} mpu6050_trace_header_t;
+
+/**
+ * @brief 轨迹记录（16 字节）
+ */
+typedef struct {
+    uint32_t t_us;              // 相对 start_us 的偏移（约 71 分钟回绕）
+    int16_t accel[3];           // 加速度计 X/Y/Z 原始值
+    int16_t gyro[3];            // 陀螺仪 X/Y/Z 原始值
+} mpu6050_trace_record_t;
+
+_Static_assert(sizeof(mpu6050_trace_header_t) == 48, "轨迹头部布局变化需升级版本号");
+_Static_assert(sizeof(mpu6050_trace_record_t) == 16, "轨迹记录布局变化需升级版本号");
+
+#endif /* __MPU6050_TRACE_FORMAT_H__ */
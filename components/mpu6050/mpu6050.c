@@ -1,86 +1,206 @@
 #include "mpu6050.h"
 #include "mpu6050_config.h"
-#include "driver/i2c_master.h"
+#include "i2c_bus.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "esp_log.h"
 #include <math.h>
+#include <string.h>
+#include <stdatomic.h>
 
 static const char *TAG = "mpu6050";
 
 #define NUM_SENSOR_DATA 7  // 加速度计3轴 + 温度 + 陀螺仪3轴
+#define FIFO_BURST_FRAMES 32  // 单次 I2C 突发读取的最大帧数（384 字节）
 
-static i2c_master_bus_handle_t s_bus_handle = NULL;
-static i2c_master_dev_handle_t s_dev_handle = NULL;
+static i2c_bus_device_handle_t s_dev = NULL;
 static bool s_inited = false;
 
 // 灵敏度表
 static float s_gyro_sensitivity = MPU6050_GYRO_SENS_250;       // 默认 ±250°/s
 static float s_accel_sensitivity = MPU6050_ACCEL_SENS_2G;      // 默认 ±2g
+static uint8_t s_gyro_range = MPU6050_GYRO_RANGE_250;          // 当前量程寄存器值（上电默认）
+static uint8_t s_accel_range = MPU6050_ACCEL_RANGE_2G;
 
-// 陀螺仪零偏
-static mpu6050_gyro_bias_t s_gyro_bias = {0, 0, 0};
+// 量程/采样率配置锁：寄存器写入与灵敏度、换算系数更新作为一个整体
+static SemaphoreHandle_t s_cfg_lock = NULL;
+
+// 陀螺仪零偏（°/s，与量程无关；各换算组按自身灵敏度派生 LSB 零偏，切换量程不累积舍入误差）
+static float s_gyro_bias_dps[3] = {0.0f, 0.0f, 0.0f};
 static bool s_gyro_calibrated = false;
 
-static esp_err_t _i2c_bus_init(void)
+// 预计算换算系数（量程或零偏变化时更新），转换时只做乘加：out = raw * scale + offset
+typedef struct {
+    float accel_scale;          // (m/s²) / LSB
+    float gyro_scale;           // (°/s) / LSB
+    float gyro_offset[3];       // -bias * gyro_scale
+    int32_t accel_scale_q16;    // (mm/s²) / LSB，Q16
+    int32_t gyro_scale_q16;     // (m°/s) / LSB，Q16
+    int16_t gyro_bias[3];       // 本组量程下的零偏，未校准时为 0
+    float gyro_sens;            // 本组灵敏度（0 表示未使用）
+    float accel_sens;
+    uint8_t gyro_range;         // 本组量程寄存器值
+    uint8_t accel_range;
+} mpu6050_scale_t;
+
+/*
+ * 换算系数按组轮换：量程或零偏每变化一次写入下一组并递增编号，采样带着采集时的编号，
+ * 缓冲中尚未处理的旧采样仍按原组换算；已发布的组不再修改，读者不会看到半更新的系数。
+ * 组数只需覆盖缓冲期间的变化次数（零偏后台更新至少间隔一个静止检测窗口）。
+ */
+#define MPU6050_SCALE_SLOTS     4
+#define MPU6050_SCALE_MASK      (MPU6050_SCALE_SLOTS - 1)
+
+static mpu6050_scale_t s_scales[MPU6050_SCALE_SLOTS];
+static atomic_uint s_scale_id = 0;
+
+static inline const mpu6050_scale_t *_mpu6050_scale(uint8_t scale_id)
 {
-    if (s_bus_handle != NULL) {
-        ESP_LOGW(TAG, "I2C 总线已初始化");
-        return ESP_OK;
-    }
+    return &s_scales[scale_id & MPU6050_SCALE_MASK];
+}
 
-    i2c_master_bus_config_t bus_cfg = {
-        .i2c_port = MPU6050_I2C_PORT,
-        .sda_io_num = MPU6050_SDA_PIN,
-        .scl_io_num = MPU6050_SCL_PIN,
-        .clk_source = I2C_CLK_SRC_DEFAULT,
-        .glitch_ignore_cnt = MPU6050_I2C_GLITCH_IGNORE_CNT,
-        .flags.enable_internal_pullup = true
-    };
+static inline const mpu6050_scale_t *_mpu6050_current_scale(void)
+{
+    return _mpu6050_scale((uint8_t)atomic_load_explicit(&s_scale_id, memory_order_acquire));
+}
 
-    ESP_ERROR_CHECK(i2c_new_master_bus(&bus_cfg, &s_bus_handle));
+// °/s → LSB（限幅到 int16）
+static int16_t _mpu6050_dps_to_lsb(float dps, float sens)
+{
+    float v = roundf(dps * sens);
+    return (int16_t)fmaxf(fminf(v, INT16_MAX), INT16_MIN);
+}
 
-    return ESP_OK;
+// 物理零偏与量程无关，按本组灵敏度换算
+static void _mpu6050_fill_bias(mpu6050_scale_t *sc)
+{
+    for (int i = 0; i < 3; i++) {
+        float dps = s_gyro_calibrated ? s_gyro_bias_dps[i] : 0.0f;
+        sc->gyro_bias[i] = _mpu6050_dps_to_lsb(dps, sc->gyro_sens);
+        sc->gyro_offset[i] = -(float)sc->gyro_bias[i] * sc->gyro_scale;
+    }
 }
 
-static esp_err_t _mpu6050_device_init(void)
+// 量程或零偏变化：填好下一组再发布编号（需持有配置锁）
+static void _mpu6050_update_scale(void)
 {
-    if (s_dev_handle != NULL) {
-        ESP_LOGW(TAG, "MPU6050 设备已初始化");
-        return ESP_OK;
+    unsigned id = atomic_load_explicit(&s_scale_id, memory_order_relaxed);
+    mpu6050_scale_t next;
+
+    memset(&next, 0, sizeof(next));     // 填充字节清零，便于整体比较
+    next.gyro_sens = s_gyro_sensitivity;
+    next.accel_sens = s_accel_sensitivity;
+    next.gyro_range = s_gyro_range;
+    next.accel_range = s_accel_range;
+    next.accel_scale = MPU6050_GRAVITY_MS2 / s_accel_sensitivity;
+    next.gyro_scale = 1.0f / s_gyro_sensitivity;
+    next.accel_scale_q16 = (int32_t)(next.accel_scale * 1000.0f * 65536.0f + 0.5f);
+    next.gyro_scale_q16 = (int32_t)(next.gyro_scale * 1000.0f * 65536.0f + 0.5f);
+    _mpu6050_fill_bias(&next);
+
+    if (memcmp(&s_scales[id & MPU6050_SCALE_MASK], &next, sizeof(next)) == 0) {
+        return;
     }
 
-    if (s_bus_handle == NULL) {
-        ESP_LOGE(TAG, "I2C 总线未初始化");
-        return ESP_ERR_INVALID_STATE;
+    id++;
+    s_scales[id & MPU6050_SCALE_MASK] = next;
+    atomic_store_explicit(&s_scale_id, id, memory_order_release);
+}
+
+static esp_err_t _mpu6050_gyro_range_sens(uint8_t range, float *sens)
+{
+    switch (range) {
+        case MPU6050_GYRO_RANGE_250:  *sens = MPU6050_GYRO_SENS_250;  return ESP_OK;
+        case MPU6050_GYRO_RANGE_500:  *sens = MPU6050_GYRO_SENS_500;  return ESP_OK;
+        case MPU6050_GYRO_RANGE_1000: *sens = MPU6050_GYRO_SENS_1000; return ESP_OK;
+        case MPU6050_GYRO_RANGE_2000: *sens = MPU6050_GYRO_SENS_2000; return ESP_OK;
+        default: return ESP_ERR_INVALID_ARG;
     }
+}
 
-    i2c_device_config_t dev_cfg = {
-        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
-        .device_address = MPU6050_I2C_ADDR,
-        .scl_speed_hz = MPU6050_I2C_CLK_SPEED,
-    };
+static esp_err_t _mpu6050_accel_range_sens(uint8_t range, float *sens)
+{
+    switch (range) {
+        case MPU6050_ACCEL_RANGE_2G:  *sens = MPU6050_ACCEL_SENS_2G;  return ESP_OK;
+        case MPU6050_ACCEL_RANGE_4G:  *sens = MPU6050_ACCEL_SENS_4G;  return ESP_OK;
+        case MPU6050_ACCEL_RANGE_8G:  *sens = MPU6050_ACCEL_SENS_8G;  return ESP_OK;
+        case MPU6050_ACCEL_RANGE_16G: *sens = MPU6050_ACCEL_SENS_16G; return ESP_OK;
+        default: return ESP_ERR_INVALID_ARG;
+    }
+}
+
+// 更新陀螺仪灵敏度；零偏以 °/s 保存，无需换算（需持有配置锁）
+static void _mpu6050_set_gyro_sens(uint8_t range, float sens)
+{
+    s_gyro_sensitivity = sens;
+    s_gyro_range = range;
+}
 
-    ESP_ERROR_CHECK(i2c_master_bus_add_device(s_bus_handle, &dev_cfg, &s_dev_handle));
+static const mpu6050_profile_desc_t s_profiles[MPU6050_PROFILE_MAX] = {
+    [MPU6050_PROFILE_LOW_POWER] = {
+        "low_power", MPU6050_PROFILE_LOW_POWER_RATE_HZ, MPU6050_PROFILE_LOW_POWER_DLPF,
+        MPU6050_PROFILE_LOW_POWER_GYRO_RANGE, MPU6050_PROFILE_LOW_POWER_ACCEL_RANGE
+    },
+    [MPU6050_PROFILE_TRACKING] = {
+        "tracking", MPU6050_PROFILE_TRACKING_RATE_HZ, MPU6050_PROFILE_TRACKING_DLPF,
+        MPU6050_PROFILE_TRACKING_GYRO_RANGE, MPU6050_PROFILE_TRACKING_ACCEL_RANGE
+    },
+    [MPU6050_PROFILE_GESTURE] = {
+        "gesture", MPU6050_PROFILE_GESTURE_RATE_HZ, MPU6050_PROFILE_GESTURE_DLPF,
+        MPU6050_PROFILE_GESTURE_GYRO_RANGE, MPU6050_PROFILE_GESTURE_ACCEL_RANGE
+    },
+};
+
+static uint8_t s_fifo_buf[FIFO_BURST_FRAMES * MPU6050_FIFO_FRAME_BYTES];   // FIFO 突发读取缓冲
+
+static esp_err_t _mpu6050_write_reg(uint8_t reg, uint8_t value)
+{
+    return i2c_bus_write_reg(s_dev, reg, value);
+}
 
-    return ESP_OK;
+static esp_err_t _mpu6050_read_regs(uint8_t reg, uint8_t *data, size_t len)
+{
+    return i2c_bus_read_regs(s_dev, reg, data, len);
 }
 
-static esp_err_t _mpu6050_verify_device(void)
+// 读 FIFO 数据寄存器会弹出数据，失败重试会导致帧错位，因此不重试，由调用方复位 FIFO
+static esp_err_t _mpu6050_read_fifo_data(uint8_t *data, size_t len)
 {
-    if (s_dev_handle == NULL) {
-        ESP_LOGE(TAG, "MPU6050 设备未初始化");
-        return ESP_ERR_INVALID_STATE;
+    uint8_t reg = MPU6050_REG_FIFO_R_W;
+    i2c_bus_txn_t txn = {
+        .dev = s_dev,
+        .wr = &reg,
+        .wr_len = 1,
+        .rd = data,
+        .rd_len = len,
+        .flags = I2C_BUS_FLAG_NO_RETRY,
+    };
+    return i2c_bus_transfer(&txn);
+}
+
+static esp_err_t _mpu6050_device_init(void)
+{
+    if (s_dev != NULL) {
+        return ESP_OK;
     }
 
-    uint8_t who_am_i = 0;
-    uint8_t reg_addr = MPU6050_REG_WHO_AM_I;
+    // 总线由 i2c_bus 统一管理，其他传感器可挂载在同一总线
+    esp_err_t err = i2c_bus_init();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    return i2c_bus_add_device("mpu6050", MPU6050_I2C_ADDR, MPU6050_I2C_CLK_SPEED, &s_dev);
+}
 
-    ESP_ERROR_CHECK(i2c_master_transmit_receive(
-        s_dev_handle,
-        &reg_addr, 1,
-        &who_am_i, 1,
-        100  // 100ms 超时
-    ));
+static esp_err_t _mpu6050_verify_device(void)
+{
+    uint8_t who_am_i = 0;
+    esp_err_t err = _mpu6050_read_regs(MPU6050_REG_WHO_AM_I, &who_am_i, 1);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "读取设备 ID 失败: %s", esp_err_to_name(err));
+        return err;
+    }
 
     if (who_am_i != MPU6050_WHO_AM_I_VALUE) {
         ESP_LOGE(TAG, "设备 ID 不匹配，期望: 0x%02X，实际: 0x%02X",
@@ -94,15 +214,7 @@ static esp_err_t _mpu6050_verify_device(void)
 
 static esp_err_t _mpu6050_wakeup(void)
 {
-    if (s_dev_handle == NULL) {
-        ESP_LOGE(TAG, "MPU6050 设备未初始化");
-        return ESP_ERR_INVALID_STATE;
-    }
-
-    uint8_t wakeup_cmd[] = {MPU6050_REG_PWR_MGMT_1, MPU6050_PWR_MGMT_1_WAKEUP};
-    ESP_ERROR_CHECK(i2c_master_transmit(s_dev_handle, wakeup_cmd, sizeof(wakeup_cmd), -1));
-
-    return ESP_OK;
+    return _mpu6050_write_reg(MPU6050_REG_PWR_MGMT_1, MPU6050_PWR_MGMT_1_WAKEUP);
 }
 
 esp_err_t mpu6050_init(void)
@@ -112,17 +224,33 @@ esp_err_t mpu6050_init(void)
         return ESP_OK;
     }
 
-    // 初始化 I2C 总线
-    ESP_ERROR_CHECK(_i2c_bus_init());
-
-    // 初始化 MPU6050 设备
-    ESP_ERROR_CHECK(_mpu6050_device_init());
+    // 挂载到共享 I2C 总线
+    esp_err_t err = _mpu6050_device_init();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "挂载 I2C 设备失败: %s", esp_err_to_name(err));
+        return err;
+    }
 
     // 验证设备是否正确连接
-    ESP_ERROR_CHECK(_mpu6050_verify_device());
+    err = _mpu6050_verify_device();
+    if (err != ESP_OK) {
+        return err;
+    }
 
     // 唤醒 MPU6050
-    ESP_ERROR_CHECK(_mpu6050_wakeup());
+    err = _mpu6050_wakeup();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "唤醒失败: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    if (s_cfg_lock == NULL) {
+        s_cfg_lock = xSemaphoreCreateMutex();
+        if (s_cfg_lock == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    _mpu6050_update_scale();
 
     s_inited = true;
     ESP_LOGI(TAG, "MPU6050 初始化成功");
@@ -146,20 +274,12 @@ esp_err_t mpu6050_read_raw_data(mpu6050_raw_data_t *data)
         return ESP_ERR_INVALID_ARG;
     }
 
-    if (s_dev_handle == NULL) {
-        ESP_LOGE(TAG, "设备句柄无效");
-        return ESP_ERR_INVALID_STATE;
-    }
-
-    uint8_t reg_addr = MPU6050_REG_ACCEL_XOUT_H;
     uint8_t raw_data[MPU6050_DATA_BYTES(NUM_SENSOR_DATA)];
 
-    ESP_ERROR_CHECK(i2c_master_transmit_receive(
-        s_dev_handle,
-        &reg_addr, 1,
-        raw_data, sizeof(raw_data),
-        100  // 100ms 超时
-    ));
+    esp_err_t err = _mpu6050_read_regs(MPU6050_REG_ACCEL_XOUT_H, raw_data, sizeof(raw_data));
+    if (err != ESP_OK) {
+        return err;
+    }
 
     // 解析原始数据（注意：加速度和陀螺仪之间有2字节温度数据）
     data->accel_x = (int16_t)((raw_data[0] << 8) | raw_data[1]);
@@ -173,40 +293,115 @@ esp_err_t mpu6050_read_raw_data(mpu6050_raw_data_t *data)
     return ESP_OK;
 }
 
-esp_err_t mpu6050_convert_data(const mpu6050_raw_data_t *raw_data, mpu6050_data_t *data)
+esp_err_t mpu6050_convert_data_scaled(const mpu6050_raw_data_t *raw_data, uint8_t scale_id, mpu6050_data_t *data)
 {
     if (raw_data == NULL || data == NULL) {
         ESP_LOGE(TAG, "数据指针为空");
         return ESP_ERR_INVALID_ARG;
     }
 
-    // 转换加速度计数据（原始值 → m/s²）
-    float accel_x_g = raw_data->accel_x / s_accel_sensitivity;
-    float accel_y_g = raw_data->accel_y / s_accel_sensitivity;
-    float accel_z_g = raw_data->accel_z / s_accel_sensitivity;
+    const mpu6050_scale_t *sc = _mpu6050_scale(scale_id);
+
+    // 加速度计：原始值 → m/s²
+    data->accel_x = raw_data->accel_x * sc->accel_scale;
+    data->accel_y = raw_data->accel_y * sc->accel_scale;
+    data->accel_z = raw_data->accel_z * sc->accel_scale;
 
-    data->accel_x = accel_x_g * MPU6050_GRAVITY_MS2;
-    data->accel_y = accel_y_g * MPU6050_GRAVITY_MS2;
-    data->accel_z = accel_z_g * MPU6050_GRAVITY_MS2;
+    // 陀螺仪：(原始值 - 零偏) → °/s
+    data->gyro_x = raw_data->gyro_x * sc->gyro_scale + sc->gyro_offset[0];
+    data->gyro_y = raw_data->gyro_y * sc->gyro_scale + sc->gyro_offset[1];
+    data->gyro_z = raw_data->gyro_z * sc->gyro_scale + sc->gyro_offset[2];
+
+    return ESP_OK;
+}
 
-    // 转换陀螺仪数据（原始值 - 零偏 → °/s）
-    int16_t gyro_x_corrected = raw_data->gyro_x;
-    int16_t gyro_y_corrected = raw_data->gyro_y;
-    int16_t gyro_z_corrected = raw_data->gyro_z;
+esp_err_t mpu6050_convert_data(const mpu6050_raw_data_t *raw_data, mpu6050_data_t *data)
+{
+    return mpu6050_convert_data_scaled(raw_data, mpu6050_get_scale_id(), data);
+}
 
-    if (s_gyro_calibrated) {
-        gyro_x_corrected -= s_gyro_bias.gyro_x_bias;
-        gyro_y_corrected -= s_gyro_bias.gyro_y_bias;
-        gyro_z_corrected -= s_gyro_bias.gyro_z_bias;
+// 按步长取第 i 个原始采样（支持直接遍历嵌有原始数据的结构体数组）
+#define RAW_AT(base, stride, i)  ((const mpu6050_raw_data_t *)((const uint8_t *)(base) + (size_t)(i) * (stride)))
+
+esp_err_t mpu6050_convert_batch_scaled(const mpu6050_raw_data_t *raw, size_t stride, size_t count,
+                                       uint8_t scale_id, const mpu6050_data_soa_t *out)
+{
+    if (raw == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (stride == 0) {
+        stride = sizeof(mpu6050_raw_data_t);
     }
 
-    data->gyro_x = gyro_x_corrected / s_gyro_sensitivity;
-    data->gyro_y = gyro_y_corrected / s_gyro_sensitivity;
-    data->gyro_z = gyro_z_corrected / s_gyro_sensitivity;
+    // 系数拷到局部变量，循环内不再访问全局状态
+    const mpu6050_scale_t *sc = _mpu6050_scale(scale_id);
+    const float as = sc->accel_scale;
+    const float gs = sc->gyro_scale;
+    const float gox = sc->gyro_offset[0];
+    const float goy = sc->gyro_offset[1];
+    const float goz = sc->gyro_offset[2];
+
+    // 每个输出通道连续写入，乘加（madd.s）无分支
+    for (size_t i = 0; i < count; i++) {
+        const mpu6050_raw_data_t *r = RAW_AT(raw, stride, i);
+        out->accel_x[i] = r->accel_x * as;
+        out->accel_y[i] = r->accel_y * as;
+        out->accel_z[i] = r->accel_z * as;
+        out->gyro_x[i] = r->gyro_x * gs + gox;
+        out->gyro_y[i] = r->gyro_y * gs + goy;
+        out->gyro_z[i] = r->gyro_z * gs + goz;
+    }
 
     return ESP_OK;
 }
 
+esp_err_t mpu6050_convert_batch(const mpu6050_raw_data_t *raw, size_t stride, size_t count,
+                                const mpu6050_data_soa_t *out)
+{
+    return mpu6050_convert_batch_scaled(raw, stride, count, mpu6050_get_scale_id(), out);
+}
+
+static inline int32_t _mpu6050_q16_mul(int32_t value, int32_t scale_q16)
+{
+    return (int32_t)(((int64_t)value * scale_q16 + 0x8000) >> 16);
+}
+
+esp_err_t mpu6050_convert_batch_fixed_scaled(const mpu6050_raw_data_t *raw, size_t stride, size_t count,
+                                             uint8_t scale_id, const mpu6050_data_fixed_soa_t *out)
+{
+    if (raw == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (stride == 0) {
+        stride = sizeof(mpu6050_raw_data_t);
+    }
+
+    const mpu6050_scale_t *sc = _mpu6050_scale(scale_id);
+    const int32_t as = sc->accel_scale_q16;
+    const int32_t gs = sc->gyro_scale_q16;
+    const int32_t bx = sc->gyro_bias[0];
+    const int32_t by = sc->gyro_bias[1];
+    const int32_t bz = sc->gyro_bias[2];
+
+    for (size_t i = 0; i < count; i++) {
+        const mpu6050_raw_data_t *r = RAW_AT(raw, stride, i);
+        out->accel_x[i] = _mpu6050_q16_mul(r->accel_x, as);
+        out->accel_y[i] = _mpu6050_q16_mul(r->accel_y, as);
+        out->accel_z[i] = _mpu6050_q16_mul(r->accel_z, as);
+        out->gyro_x[i] = _mpu6050_q16_mul(r->gyro_x - bx, gs);
+        out->gyro_y[i] = _mpu6050_q16_mul(r->gyro_y - by, gs);
+        out->gyro_z[i] = _mpu6050_q16_mul(r->gyro_z - bz, gs);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t mpu6050_convert_batch_fixed(const mpu6050_raw_data_t *raw, size_t stride, size_t count,
+                                      const mpu6050_data_fixed_soa_t *out)
+{
+    return mpu6050_convert_batch_fixed_scaled(raw, stride, count, mpu6050_get_scale_id(), out);
+}
+
 esp_err_t mpu6050_read_data(mpu6050_data_t *data)
 {
     if (data == NULL) {
@@ -217,7 +412,10 @@ esp_err_t mpu6050_read_data(mpu6050_data_t *data)
     mpu6050_raw_data_t raw_data;
 
     // 读取原始数据
-    ESP_ERROR_CHECK(mpu6050_read_raw_data(&raw_data));
+    esp_err_t err = mpu6050_read_raw_data(&raw_data);
+    if (err != ESP_OK) {
+        return err;
+    }
 
     // 转换为物理单位
     return mpu6050_convert_data(&raw_data, data);
@@ -243,7 +441,11 @@ esp_err_t mpu6050_calibrate_gyro(mpu6050_gyro_bias_t *bias, uint16_t samples)
     ESP_LOGI(TAG, "开始校准陀螺仪，采样次数: %u", samples);
 
     for (uint16_t i = 0; i < samples; i++) {
-        ESP_ERROR_CHECK(mpu6050_read_raw_data(&temp));
+        esp_err_t err = mpu6050_read_raw_data(&temp);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "校准读取失败: %s", esp_err_to_name(err));
+            return err;
+        }
 
         sum_x += temp.gyro_x;
         sum_y += temp.gyro_y;
@@ -252,64 +454,129 @@ esp_err_t mpu6050_calibrate_gyro(mpu6050_gyro_bias_t *bias, uint16_t samples)
         vTaskDelay(pdMS_TO_TICKS(10));
     }
 
-    s_gyro_bias.gyro_x_bias = sum_x / samples;
-    s_gyro_bias.gyro_y_bias = sum_y / samples;
-    s_gyro_bias.gyro_z_bias = sum_z / samples;
+    const int16_t avg[3] = {(int16_t)(sum_x / samples), (int16_t)(sum_y / samples), (int16_t)(sum_z / samples)};
+
+    xSemaphoreTake(s_cfg_lock, portMAX_DELAY);
+    for (int i = 0; i < 3; i++) {
+        s_gyro_bias_dps[i] = (float)avg[i] / s_gyro_sensitivity;
+    }
     s_gyro_calibrated = true;
+    _mpu6050_update_scale();
+    xSemaphoreGive(s_cfg_lock);
 
-    ESP_LOGI(TAG, "陀螺仪校准完成 - X: %d, Y: %d, Z: %d",
-             s_gyro_bias.gyro_x_bias, s_gyro_bias.gyro_y_bias, s_gyro_bias.gyro_z_bias);
+    ESP_LOGI(TAG, "陀螺仪校准完成 - X: %d, Y: %d, Z: %d", avg[0], avg[1], avg[2]);
 
     if (bias != NULL) {
-        bias->gyro_x_bias = s_gyro_bias.gyro_x_bias;
-        bias->gyro_y_bias = s_gyro_bias.gyro_y_bias;
-        bias->gyro_z_bias = s_gyro_bias.gyro_z_bias;
+        bias->gyro_x_bias = avg[0];
+        bias->gyro_y_bias = avg[1];
+        bias->gyro_z_bias = avg[2];
     }
 
     return ESP_OK;
 }
 
-esp_err_t mpu6050_set_gyro_range(uint8_t range)
+esp_err_t mpu6050_set_gyro_bias(const mpu6050_gyro_bias_t *bias)
+{
+    if (bias == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!s_inited) {
+        ESP_LOGE(TAG, "MPU6050 未初始化");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(s_cfg_lock, portMAX_DELAY);
+    s_gyro_bias_dps[0] = (float)bias->gyro_x_bias / s_gyro_sensitivity;
+    s_gyro_bias_dps[1] = (float)bias->gyro_y_bias / s_gyro_sensitivity;
+    s_gyro_bias_dps[2] = (float)bias->gyro_z_bias / s_gyro_sensitivity;
+    s_gyro_calibrated = true;
+    _mpu6050_update_scale();
+    xSemaphoreGive(s_cfg_lock);
+    return ESP_OK;
+}
+
+esp_err_t mpu6050_set_gyro_bias_dps(const float dps[3])
 {
+    if (dps == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
     if (!s_inited) {
         ESP_LOGE(TAG, "MPU6050 未初始化");
         return ESP_ERR_INVALID_STATE;
     }
 
-    if (s_dev_handle == NULL) {
-        ESP_LOGE(TAG, "设备句柄无效");
+    xSemaphoreTake(s_cfg_lock, portMAX_DELAY);
+    for (int i = 0; i < 3; i++) {
+        s_gyro_bias_dps[i] = dps[i];
+    }
+    s_gyro_calibrated = true;
+    _mpu6050_update_scale();
+    xSemaphoreGive(s_cfg_lock);
+    return ESP_OK;
+}
+
+esp_err_t mpu6050_clear_gyro_bias(void)
+{
+    if (!s_inited) {
+        ESP_LOGE(TAG, "MPU6050 未初始化");
         return ESP_ERR_INVALID_STATE;
     }
 
-    uint8_t config[] = {MPU6050_REG_GYRO_CONFIG, range};
-    ESP_ERROR_CHECK(i2c_master_transmit(s_dev_handle, config, sizeof(config), -1));
+    xSemaphoreTake(s_cfg_lock, portMAX_DELAY);
+    memset(s_gyro_bias_dps, 0, sizeof(s_gyro_bias_dps));
+    s_gyro_calibrated = false;
+    _mpu6050_update_scale();
+    xSemaphoreGive(s_cfg_lock);
+    return ESP_OK;
+}
 
-    // 更新灵敏度
-    switch (range) {
-        case MPU6050_GYRO_RANGE_250:
-            s_gyro_sensitivity = MPU6050_GYRO_SENS_250;
-            ESP_LOGI(TAG, "陀螺仪量程已设置为 ±%d°/s", MPU6050_GYRO_RANGE_250_VAL);
-            break;
-        case MPU6050_GYRO_RANGE_500:
-            s_gyro_sensitivity = MPU6050_GYRO_SENS_500;
-            ESP_LOGI(TAG, "陀螺仪量程已设置为 ±%d°/s", MPU6050_GYRO_RANGE_500_VAL);
-            break;
-        case MPU6050_GYRO_RANGE_1000:
-            s_gyro_sensitivity = MPU6050_GYRO_SENS_1000;
-            ESP_LOGI(TAG, "陀螺仪量程已设置为 ±%d°/s", MPU6050_GYRO_RANGE_1000_VAL);
-            break;
-        case MPU6050_GYRO_RANGE_2000:
-            s_gyro_sensitivity = MPU6050_GYRO_SENS_2000;
-            ESP_LOGI(TAG, "陀螺仪量程已设置为 ±%d°/s", MPU6050_GYRO_RANGE_2000_VAL);
-            break;
-        default:
-            ESP_LOGW(TAG, "陀螺仪量程设置值错误");
-            return ESP_ERR_INVALID_ARG;
+esp_err_t mpu6050_get_gyro_bias(mpu6050_gyro_bias_t *bias)
+{
+    if (bias == NULL) {
+        return ESP_ERR_INVALID_ARG;
     }
 
+    if (!s_gyro_calibrated) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // 当前换算组已按当前量程派生好 LSB 零偏
+    const mpu6050_scale_t *sc = _mpu6050_current_scale();
+    bias->gyro_x_bias = sc->gyro_bias[0];
+    bias->gyro_y_bias = sc->gyro_bias[1];
+    bias->gyro_z_bias = sc->gyro_bias[2];
     return ESP_OK;
 }
 
+esp_err_t mpu6050_set_gyro_range(uint8_t range)
+{
+    if (!s_inited) {
+        ESP_LOGE(TAG, "MPU6050 未初始化");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    float sens;
+    if (_mpu6050_gyro_range_sens(range, &sens) != ESP_OK) {
+        ESP_LOGW(TAG, "陀螺仪量程设置值错误");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(s_cfg_lock, portMAX_DELAY);
+    esp_err_t err = _mpu6050_write_reg(MPU6050_REG_GYRO_CONFIG, range);
+    if (err == ESP_OK) {
+        _mpu6050_set_gyro_sens(range, sens);
+        _mpu6050_update_scale();
+    }
+    xSemaphoreGive(s_cfg_lock);
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "陀螺仪量程已设置为 ±%d°/s", (int)(MPU6050_GYRO_RANGE_250_VAL << (range >> 3)));
+    }
+    return err;
+}
+
 esp_err_t mpu6050_set_accel_range(uint8_t range)
 {
     if (!s_inited) {
@@ -317,40 +584,302 @@ esp_err_t mpu6050_set_accel_range(uint8_t range)
         return ESP_ERR_INVALID_STATE;
     }
 
-    if (s_dev_handle == NULL) {
-        ESP_LOGE(TAG, "设备句柄无效");
+    float sens;
+    if (_mpu6050_accel_range_sens(range, &sens) != ESP_OK) {
+        ESP_LOGW(TAG, "加速度计量程设置值错误");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(s_cfg_lock, portMAX_DELAY);
+    esp_err_t err = _mpu6050_write_reg(MPU6050_REG_ACCEL_CONFIG, range);
+    if (err == ESP_OK) {
+        s_accel_sensitivity = sens;
+        s_accel_range = range;
+        _mpu6050_update_scale();
+    }
+    xSemaphoreGive(s_cfg_lock);
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "加速度计量程已设置为 ±%dg", (int)(MPU6050_ACCEL_RANGE_2G_VAL << (range >> 3)));
+    }
+    return err;
+}
+
+esp_err_t mpu6050_set_sample_rate(uint16_t rate_hz)
+{
+    if (!s_inited) {
+        ESP_LOGE(TAG, "MPU6050 未初始化");
         return ESP_ERR_INVALID_STATE;
     }
 
-    uint8_t config[] = {MPU6050_REG_ACCEL_CONFIG, range};
-    ESP_ERROR_CHECK(i2c_master_transmit(s_dev_handle, config, sizeof(config), -1));
+    if (rate_hz < 4 || rate_hz > MPU6050_GYRO_OUTPUT_RATE_HZ) {
+        ESP_LOGE(TAG, "采样率超出范围: %u", rate_hz);
+        return ESP_ERR_INVALID_ARG;
+    }
 
-    // 更新灵敏度
-    switch (range) {
-        case MPU6050_ACCEL_RANGE_2G:
-            s_accel_sensitivity = MPU6050_ACCEL_SENS_2G;
-            ESP_LOGI(TAG, "加速度计量程已设置为 ±%dg", MPU6050_ACCEL_RANGE_2G_VAL);
-            break;
-        case MPU6050_ACCEL_RANGE_4G:
-            s_accel_sensitivity = MPU6050_ACCEL_SENS_4G;
-            ESP_LOGI(TAG, "加速度计量程已设置为 ±%dg", MPU6050_ACCEL_RANGE_4G_VAL);
-            break;
-        case MPU6050_ACCEL_RANGE_8G:
-            s_accel_sensitivity = MPU6050_ACCEL_SENS_8G;
-            ESP_LOGI(TAG, "加速度计量程已设置为 ±%dg", MPU6050_ACCEL_RANGE_8G_VAL);
-            break;
-        case MPU6050_ACCEL_RANGE_16G:
-            s_accel_sensitivity = MPU6050_ACCEL_SENS_16G;
-            ESP_LOGI(TAG, "加速度计量程已设置为 ±%dg", MPU6050_ACCEL_RANGE_16G_VAL);
-            break;
-        default:
-            ESP_LOGW(TAG, "加速度设计值错误");
-            return ESP_ERR_INVALID_ARG;
+    esp_err_t err = _mpu6050_write_reg(MPU6050_REG_CONFIG, MPU6050_DLPF_CFG);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    uint8_t div = (uint8_t)(MPU6050_GYRO_OUTPUT_RATE_HZ / rate_hz - 1);
+    err = _mpu6050_write_reg(MPU6050_REG_SMPLRT_DIV, div);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    ESP_LOGI(TAG, "采样率已设置为 %u Hz (SMPLRT_DIV=%u)", MPU6050_GYRO_OUTPUT_RATE_HZ / (div + 1), div);
+    return ESP_OK;
+}
+
+const mpu6050_profile_desc_t *mpu6050_get_profile_desc(mpu6050_profile_t profile)
+{
+    if (profile < 0 || profile >= MPU6050_PROFILE_MAX) {
+        return NULL;
+    }
+    return &s_profiles[profile];
+}
+
+esp_err_t mpu6050_apply_profile(mpu6050_profile_t profile)
+{
+    const mpu6050_profile_desc_t *p = mpu6050_get_profile_desc(profile);
+    if (p == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!s_inited) {
+        ESP_LOGE(TAG, "MPU6050 未初始化");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // DLPF_CFG 为 0/7 时陀螺仪输出率为 8kHz，分频公式不再成立
+    float gyro_sens, accel_sens;
+    if (p->dlpf_cfg < 1 || p->dlpf_cfg > 6 ||
+        p->rate_hz < 4 || p->rate_hz > MPU6050_GYRO_OUTPUT_RATE_HZ ||
+        _mpu6050_gyro_range_sens(p->gyro_range, &gyro_sens) != ESP_OK ||
+        _mpu6050_accel_range_sens(p->accel_range, &accel_sens) != ESP_OK) {
+        ESP_LOGE(TAG, "配置档位 %s 参数无效", p->name);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t div = (uint8_t)(MPU6050_GYRO_OUTPUT_RATE_HZ / p->rate_hz - 1);
+
+    xSemaphoreTake(s_cfg_lock, portMAX_DELAY);
+    esp_err_t err = _mpu6050_write_reg(MPU6050_REG_CONFIG, p->dlpf_cfg);
+    if (err == ESP_OK) {
+        err = _mpu6050_write_reg(MPU6050_REG_SMPLRT_DIV, div);
+    }
+    if (err == ESP_OK) {
+        err = _mpu6050_write_reg(MPU6050_REG_GYRO_CONFIG, p->gyro_range);
+    }
+    if (err == ESP_OK) {
+        err = _mpu6050_write_reg(MPU6050_REG_ACCEL_CONFIG, p->accel_range);
+    }
+    if (err == ESP_OK) {
+        // 寄存器全部写入后一次性切换灵敏度与换算系数
+        _mpu6050_set_gyro_sens(p->gyro_range, gyro_sens);
+        s_accel_sensitivity = accel_sens;
+        s_accel_range = p->accel_range;
+        _mpu6050_update_scale();
+    }
+    xSemaphoreGive(s_cfg_lock);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "配置档位 %s 写入失败: %s", p->name, esp_err_to_name(err));
+        return err;
+    }
+
+    ESP_LOGI(TAG, "配置档位 %s：%u Hz, DLPF %u, ±%d°/s, ±%dg", p->name,
+             MPU6050_GYRO_OUTPUT_RATE_HZ / (div + 1), p->dlpf_cfg,
+             (int)(MPU6050_GYRO_RANGE_250_VAL << (p->gyro_range >> 3)),
+             (int)(MPU6050_ACCEL_RANGE_2G_VAL << (p->accel_range >> 3)));
+    return ESP_OK;
+}
+
+uint8_t mpu6050_get_scale_id(void)
+{
+    return (uint8_t)atomic_load_explicit(&s_scale_id, memory_order_acquire);
+}
+
+esp_err_t mpu6050_get_scale_info(uint8_t scale_id, mpu6050_scale_info_t *info)
+{
+    if (info == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const mpu6050_scale_t *sc = _mpu6050_scale(scale_id);
+    if (sc->gyro_sens == 0.0f) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    info->gyro_range = sc->gyro_range;
+    info->accel_range = sc->accel_range;
+    info->gyro_sensitivity = sc->gyro_sens;
+    info->accel_sensitivity = sc->accel_sens;
+    return ESP_OK;
+}
+
+bool mpu6050_scale_same_range(uint8_t a, uint8_t b)
+{
+    if (a == b) {
+        return true;
+    }
+
+    const mpu6050_scale_t *sa = _mpu6050_scale(a);
+    const mpu6050_scale_t *sb = _mpu6050_scale(b);
+    return sa->gyro_range == sb->gyro_range && sa->accel_range == sb->accel_range;
+}
+
+esp_err_t mpu6050_fifo_reset(void)
+{
+    if (!s_inited) {
+        ESP_LOGE(TAG, "MPU6050 未初始化");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // 复位需在 FIFO 关闭时进行，复位后重新开启
+    esp_err_t err = _mpu6050_write_reg(MPU6050_REG_USER_CTRL, 0);
+    if (err == ESP_OK) {
+        err = _mpu6050_write_reg(MPU6050_REG_USER_CTRL, MPU6050_USER_CTRL_FIFO_RESET);
+    }
+    if (err == ESP_OK) {
+        err = _mpu6050_write_reg(MPU6050_REG_USER_CTRL, MPU6050_USER_CTRL_FIFO_EN);
+    }
+    return err;
+}
+
+esp_err_t mpu6050_fifo_enable(bool enable)
+{
+    if (!s_inited) {
+        ESP_LOGE(TAG, "MPU6050 未初始化");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t err;
+    if (!enable) {
+        err = _mpu6050_write_reg(MPU6050_REG_FIFO_EN, 0);
+        if (err == ESP_OK) {
+            err = _mpu6050_write_reg(MPU6050_REG_USER_CTRL, 0);
+        }
+        return err;
+    }
+
+    err = _mpu6050_write_reg(MPU6050_REG_FIFO_EN, MPU6050_FIFO_EN_GYRO_XYZ | MPU6050_FIFO_EN_ACCEL);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    err = mpu6050_fifo_reset();
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "FIFO 已开启（加速度计 + 陀螺仪）");
+    }
+    return err;
+}
+
+esp_err_t mpu6050_fifo_get_count(uint16_t *count)
+{
+    if (!s_inited) {
+        ESP_LOGE(TAG, "MPU6050 未初始化");
+        return ESP_ERR_INVALID_STATE;
     }
 
+    if (count == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t buf[2];
+    esp_err_t err = _mpu6050_read_regs(MPU6050_REG_FIFO_COUNTH, buf, sizeof(buf));
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    *count = (uint16_t)((buf[0] << 8) | buf[1]);
     return ESP_OK;
 }
 
+esp_err_t mpu6050_fifo_read(mpu6050_raw_data_t *data, size_t max_count, size_t *out_count)
+{
+    if (data == NULL || out_count == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out_count = 0;
+
+    uint16_t count = 0;
+    esp_err_t err = mpu6050_fifo_get_count(&count);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // 写满或帧未对齐说明已经溢出，旧数据的帧边界不可信，只能复位
+    if (count >= MPU6050_FIFO_SIZE || (count % MPU6050_FIFO_FRAME_BYTES) != 0) {
+        ESP_LOGW(TAG, "FIFO 溢出（%u 字节），复位", count);
+        mpu6050_fifo_reset();
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    size_t frames = count / MPU6050_FIFO_FRAME_BYTES;
+    if (frames > max_count) {
+        frames = max_count;
+    }
+
+    size_t done = 0;
+    while (done < frames) {
+        size_t n = frames - done;
+        if (n > FIFO_BURST_FRAMES) {
+            n = FIFO_BURST_FRAMES;
+        }
+
+        err = _mpu6050_read_fifo_data(s_fifo_buf, n * MPU6050_FIFO_FRAME_BYTES);
+        if (err != ESP_OK) {
+            break;
+        }
+
+        // FIFO 按寄存器顺序写入：ACCEL_XOUT..ACCEL_ZOUT, GYRO_XOUT..GYRO_ZOUT（大端）
+        for (size_t i = 0; i < n; i++) {
+            const uint8_t *f = &s_fifo_buf[i * MPU6050_FIFO_FRAME_BYTES];
+            mpu6050_raw_data_t *d = &data[done + i];
+            d->accel_x = (int16_t)((f[0] << 8) | f[1]);
+            d->accel_y = (int16_t)((f[2] << 8) | f[3]);
+            d->accel_z = (int16_t)((f[4] << 8) | f[5]);
+            d->gyro_x = (int16_t)((f[6] << 8) | f[7]);
+            d->gyro_y = (int16_t)((f[8] << 8) | f[9]);
+            d->gyro_z = (int16_t)((f[10] << 8) | f[11]);
+        }
+        done += n;
+    }
+
+    // 读取中途失败，FIFO 读指针位置未知，复位以重新对齐帧边界
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "FIFO 读取失败: %s", esp_err_to_name(err));
+        mpu6050_fifo_reset();
+    }
+
+    *out_count = done;
+    return err;
+}
+
+esp_err_t mpu6050_int_enable(bool enable)
+{
+    if (!s_inited) {
+        ESP_LOGE(TAG, "MPU6050 未初始化");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t err = _mpu6050_write_reg(MPU6050_REG_INT_PIN_CFG, MPU6050_INT_PIN_CFG_VALUE);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    err = _mpu6050_write_reg(MPU6050_REG_INT_ENABLE, enable ? MPU6050_INT_ENABLE_DATA_RDY : 0);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // 读一次 INT_STATUS 清除残留标志
+    uint8_t status;
+    return _mpu6050_read_regs(MPU6050_REG_INT_STATUS, &status, 1);
+}
+
 float mpu6050_calculate_angle(float prev_angle, float gyro_rate, float dt)
 {
     if (dt <= 0.0f) {
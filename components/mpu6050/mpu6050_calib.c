@@ -0,0 +1,217 @@
+#include "mpu6050_calib.h"
+#include "nvs_storage.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <math.h>
+#include <stdlib.h>
+
+static const char *TAG = "mpu6050_calib";
+
+#define CALIB_WINDOW_US         ((int64_t)MPU6050_CALIB_WINDOW_MS * 1000)
+#define CALIB_MIN_SAMPLES       (20)                    // 窗口内采样过少（如丢帧）不做判断
+#define CALIB_SAVE_INTERVAL_US  ((int64_t)MPU6050_CALIB_SAVE_INTERVAL_S * 1000000)
+
+// 静止检测窗口（原始 LSB 统计，结束时按窗口所属换算组的灵敏度换算阈值）
+typedef struct {
+    int64_t start_us;
+    uint32_t n;
+    uint8_t scale_id;           // 窗口内采样的换算组（量程切换时重新开窗）
+    int32_t gyro_sum[3];
+    int16_t gyro_min[3];
+    int16_t gyro_max[3];
+    int16_t accel_min[3];
+    int16_t accel_max[3];
+} mpu6050_calib_window_t;
+
+static mpu6050_calib_window_t s_win;
+static float s_bias_dps[3];             // 当前零偏（°/s，与量程无关）
+static bool s_valid = false;
+
+static int32_t s_saved_mdps[3];         // 上次写入 NVS 的值
+static bool s_saved_valid = false;
+static int64_t s_last_save_us = 0;
+
+static const char *const s_nvs_keys[3] = {
+    MPU6050_CALIB_NVS_KEY_X, MPU6050_CALIB_NVS_KEY_Y, MPU6050_CALIB_NVS_KEY_Z,
+};
+
+// 交给驱动（°/s，驱动在配置锁内按量程换算）
+static void _mpu6050_calib_apply(void)
+{
+    mpu6050_set_gyro_bias_dps(s_bias_dps);
+}
+
+static esp_err_t _mpu6050_calib_write(int64_t now_us)
+{
+    int32_t mdps[3];
+    for (int i = 0; i < 3; i++) {
+        mdps[i] = (int32_t)lroundf(s_bias_dps[i] * 1000.0f);
+        esp_err_t err = nvs_storage_set_i32(MPU6050_CALIB_NVS_NAMESPACE, s_nvs_keys[i], mdps[i]);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    for (int i = 0; i < 3; i++) {
+        s_saved_mdps[i] = mdps[i];
+    }
+    s_saved_valid = true;
+    s_last_save_us = now_us;
+
+    ESP_LOGI(TAG, "零偏已保存 - X: %ld, Y: %ld, Z: %ld m°/s",
+             (long)mdps[0], (long)mdps[1], (long)mdps[2]);
+    return ESP_OK;
+}
+
+// 变化足够大且距上次写入足够久才写 Flash；从未保存过则立即写入
+static void _mpu6050_calib_maybe_save(int64_t now_us)
+{
+    if (!g_nvs_initialized) {
+        return;
+    }
+
+    if (s_saved_valid) {
+        if (now_us - s_last_save_us < CALIB_SAVE_INTERVAL_US) {
+            return;
+        }
+
+        bool changed = false;
+        for (int i = 0; i < 3; i++) {
+            int32_t mdps = (int32_t)lroundf(s_bias_dps[i] * 1000.0f);
+            if (labs((long)(mdps - s_saved_mdps[i])) >= MPU6050_CALIB_SAVE_DELTA_MDPS) {
+                changed = true;
+            }
+        }
+        if (!changed) {
+            return;
+        }
+    }
+
+    esp_err_t err = _mpu6050_calib_write(now_us);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "零偏保存失败: %s", esp_err_to_name(err));
+    }
+}
+
+static void _mpu6050_calib_window_done(int64_t end_us)
+{
+    const mpu6050_calib_window_t *w = &s_win;
+    if (w->n < CALIB_MIN_SAMPLES) {
+        return;
+    }
+
+    mpu6050_scale_info_t info;
+    if (mpu6050_get_scale_info(w->scale_id, &info) != ESP_OK) {
+        return;
+    }
+
+    float gyro_sens = info.gyro_sensitivity;
+    float accel_sens = info.accel_sensitivity;
+    float mean_dps[3];
+
+    for (int i = 0; i < 3; i++) {
+        if ((w->gyro_max[i] - w->gyro_min[i]) > MPU6050_CALIB_GYRO_SPAN_DPS * gyro_sens ||
+            (w->accel_max[i] - w->accel_min[i]) > MPU6050_CALIB_ACCEL_SPAN_G * accel_sens) {
+            return;
+        }
+
+        mean_dps[i] = (float)w->gyro_sum[i] / (float)w->n / gyro_sens;
+        if (fabsf(mean_dps[i]) > MPU6050_CALIB_MAX_BIAS_DPS) {
+            return;
+        }
+    }
+
+    for (int i = 0; i < 3; i++) {
+        if (s_valid) {
+            s_bias_dps[i] += (mean_dps[i] - s_bias_dps[i]) * MPU6050_CALIB_BLEND;
+        } else {
+            s_bias_dps[i] = mean_dps[i];
+        }
+    }
+
+    if (!s_valid) {
+        ESP_LOGI(TAG, "检测到静止，零偏 X: %.3f, Y: %.3f, Z: %.3f °/s",
+                 s_bias_dps[0], s_bias_dps[1], s_bias_dps[2]);
+    }
+    s_valid = true;
+    _mpu6050_calib_apply();
+    _mpu6050_calib_maybe_save(end_us);
+}
+
+esp_err_t mpu6050_calib_load(void)
+{
+    int32_t mdps[3];
+    for (int i = 0; i < 3; i++) {
+        esp_err_t err = nvs_storage_get_i32(MPU6050_CALIB_NVS_NAMESPACE, s_nvs_keys[i], &mdps[i]);
+        if (err != ESP_OK) {
+            ESP_LOGI(TAG, "无已保存零偏（%s），静止后自动校准", esp_err_to_name(err));
+            return err;
+        }
+    }
+
+    for (int i = 0; i < 3; i++) {
+        s_bias_dps[i] = (float)mdps[i] / 1000.0f;
+        s_saved_mdps[i] = mdps[i];
+    }
+    s_saved_valid = true;
+    s_last_save_us = esp_timer_get_time();
+    s_valid = true;
+    _mpu6050_calib_apply();
+
+    ESP_LOGI(TAG, "已恢复零偏 - X: %ld, Y: %ld, Z: %ld m°/s",
+             (long)mdps[0], (long)mdps[1], (long)mdps[2]);
+    return ESP_OK;
+}
+
+void mpu6050_calib_feed(const mpu6050_sample_t *samples, size_t count)
+{
+    mpu6050_calib_window_t *w = &s_win;
+
+    for (size_t k = 0; k < count; k++) {
+        const mpu6050_raw_data_t *r = &samples[k].raw;
+        const int16_t g[3] = {r->gyro_x, r->gyro_y, r->gyro_z};
+        const int16_t a[3] = {r->accel_x, r->accel_y, r->accel_z};
+
+        if (w->n > 0 && samples[k].scale_id != w->scale_id) {
+            w->n = 0;
+        }
+
+        if (w->n == 0) {
+            w->start_us = samples[k].timestamp_us;
+            w->scale_id = samples[k].scale_id;
+            for (int i = 0; i < 3; i++) {
+                w->gyro_sum[i] = 0;
+                w->gyro_min[i] = w->gyro_max[i] = g[i];
+                w->accel_min[i] = w->accel_max[i] = a[i];
+            }
+        }
+
+        for (int i = 0; i < 3; i++) {
+            w->gyro_sum[i] += g[i];
+            if (g[i] < w->gyro_min[i]) w->gyro_min[i] = g[i];
+            if (g[i] > w->gyro_max[i]) w->gyro_max[i] = g[i];
+            if (a[i] < w->accel_min[i]) w->accel_min[i] = a[i];
+            if (a[i] > w->accel_max[i]) w->accel_max[i] = a[i];
+        }
+        w->n++;
+
+        // 按时间戳而非采样数划窗，采样率变化时窗口长度不变
+        if (samples[k].timestamp_us - w->start_us >= CALIB_WINDOW_US) {
+            _mpu6050_calib_window_done(samples[k].timestamp_us);
+            w->n = 0;
+        }
+    }
+}
+
+esp_err_t mpu6050_calib_save(void)
+{
+    if (!s_valid || !g_nvs_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return _mpu6050_calib_write(esp_timer_get_time());
+}
+
+bool mpu6050_calib_is_valid(void)
+{
+    return s_valid;
+}
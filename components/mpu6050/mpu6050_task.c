@@ -1,93 +1,570 @@
 #include "mpu6050_task.h"
+#include "mpu6050_config.h"
+#include "mpu6050_calib.h"
+#include "mpu6050_trace.h"
+#include "sys_task.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_heap_caps.h"
+#include <stdatomic.h>
+#include <string.h>
 
 static const char *TAG = "mpu6050_task";
 static bool s_task_inited = false;
-QueueHandle_t g_mpu6050_queue = NULL;
+spsc_ring_t *g_mpu6050_ring = NULL;
+static TaskHandle_t s_producer = NULL;
+static TaskHandle_t s_consumer = NULL;
 
+// 当前档位及由其决定的采样节拍（生产者写；ISR、后级只读）
+static volatile mpu6050_profile_t s_profile = MPU6050_DEFAULT_PROFILE;
+static volatile uint16_t s_rate_hz = 0;
+static volatile uint32_t s_period_us = 0;
+static uint8_t s_rate_gen = 0;                  // 采样率代号（只在生产者中修改，随采样交付）
+static volatile uint32_t s_int_batch = 1;       // 每多少个 DATA_RDY 脉冲唤醒一次生产者
+static atomic_int s_profile_req = -1;           // 待切换档位（-1 表示无）
+
+// 更新输出采样率（生产者中调用）：速率变化时递增代号，之后交付的采样带新代号
+static void _mpu6050_set_rate(uint16_t rate)
+{
+    if (rate != s_rate_hz) {
+        s_rate_gen++;
+    }
+    s_rate_hz = rate;
+    s_period_us = 1000000U / rate;
+}
+
+static volatile mpu6050_sample_cb_t s_sample_cb = NULL;
+static volatile mpu6050_realtime_cb_t s_realtime_cb = NULL;
+static volatile mpu6050_batch_cb_t s_batch_cb = NULL;
+static volatile mpu6050_idle_cb_t s_idle_cb = NULL;
+
+// 批量转换输出（结构体数组，单段最多 MPU6050_RING_LEN 个采样）
+static float s_soa_buf[6][MPU6050_RING_LEN];
+static const mpu6050_data_soa_t s_soa = {
+    s_soa_buf[0], s_soa_buf[1], s_soa_buf[2],
+    s_soa_buf[3], s_soa_buf[4], s_soa_buf[5],
+};
+
+// 采样交给实时回调和消费者环形缓冲（批量写完后再统一唤醒消费者）
+static void _mpu6050_dispatch(const mpu6050_sample_t *sample)
+{
+    // 时延敏感路径直接取最新采样，不排队
+    mpu6050_realtime_cb_t rt_cb = s_realtime_cb;
+    if (rt_cb) {
+        rt_cb(sample);
+    }
+
+    // 缓冲区满说明消费者跟不上，丢弃本次采样（计入溢出）而不阻塞采样节拍
+    spsc_ring_push(g_mpu6050_ring, sample);
+}
+
+static inline void _mpu6050_notify_consumer(void)
+{
+    if (s_consumer != NULL) {
+        xTaskNotifyGive(s_consumer);
+    }
+}
+
+#if (MPU6050_ACQ_MODE == MPU6050_ACQ_MODE_FIFO)
+#define MPU6050_WAKE_PERIOD_MS  MPU6050_FIFO_READ_PERIOD_MS
+#else
+#define MPU6050_WAKE_PERIOD_MS  MPU6050_SAMPLE_PERIOD_MS
+#endif
+
+#if MPU6050_INT_ENABLE
+#define MPU6050_INT_TS_MASK     (MPU6050_INT_TS_RING - 1)
+
+_Static_assert((MPU6050_INT_TS_RING & MPU6050_INT_TS_MASK) == 0, "MPU6050_INT_TS_RING 必须为 2 的幂");
+_Static_assert(MPU6050_INT_TS_RING >= 2 * MPU6050_FIFO_READ_MAX, "时间戳环形缓冲需覆盖单次读取的帧数");
+#if (MPU6050_ACQ_MODE == MPU6050_ACQ_MODE_FIFO)
+// INT 未接线时按超时周期读取：最快档位下一个周期的帧数既不能让 FIFO 溢出，也要一次读完
+#define MPU6050_INT_TIMEOUT_FRAMES  (MPU6050_PROFILE_GESTURE_RATE_HZ * (MPU6050_INT_TIMEOUT_MS + 1) / 1000)
+_Static_assert(MPU6050_PROFILE_GESTURE_RATE_HZ >= MPU6050_PROFILE_TRACKING_RATE_HZ &&
+               MPU6050_PROFILE_GESTURE_RATE_HZ >= MPU6050_PROFILE_LOW_POWER_RATE_HZ, "GESTURE 应为最快档位");
+_Static_assert(MPU6050_INT_TIMEOUT_FRAMES * MPU6050_FIFO_FRAME_BYTES < MPU6050_FIFO_SIZE,
+               "MPU6050_INT_TIMEOUT_MS 过长，INT 未接线时 FIFO 会溢出");
+_Static_assert(MPU6050_INT_TIMEOUT_FRAMES <= MPU6050_FIFO_READ_MAX, "MPU6050_FIFO_READ_MAX 不足以读完一个超时周期");
+#endif
+
+static int64_t s_int_ts[MPU6050_INT_TS_RING];   // 第 n 个 DATA_RDY 脉冲的时间戳（ISR 写）
+static atomic_uint s_int_pulses = 0;            // 累计脉冲数（ISR 写，生产者读）
+static uint32_t s_int_notified = 0;             // 上次通知时的脉冲数（仅 ISR 访问）
+
+// DATA_RDY：记录采样时刻，攒够一批再唤醒生产者（MPU6050 没有 FIFO 水位中断）
+static void IRAM_ATTR _mpu6050_int_isr(void *arg)
+{
+    (void)arg;
+
+    unsigned n = atomic_load_explicit(&s_int_pulses, memory_order_relaxed);
+    s_int_ts[n & MPU6050_INT_TS_MASK] = esp_timer_get_time();
+    atomic_store_explicit(&s_int_pulses, n + 1, memory_order_release);
+
+    if (n + 1 - s_int_notified >= s_int_batch && s_producer != NULL) {
+        s_int_notified = n + 1;
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(s_producer, &woken);
+        if (woken) {
+            portYIELD_FROM_ISR();
+        }
+    }
+}
+
+static esp_err_t _mpu6050_int_init(void)
+{
+    gpio_config_t io_cfg = {
+        .pin_bit_mask = 1ULL << MPU6050_INT_PIN,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_ENABLE,
+        .intr_type = GPIO_INTR_POSEDGE,
+    };
+    esp_err_t err = gpio_config(&io_cfg);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // ISR 服务可能已被其他模块安装
+    err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        return err;
+    }
+
+    err = gpio_isr_handler_add(MPU6050_INT_PIN, _mpu6050_int_isr, NULL);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    return mpu6050_int_enable(true);
+}
+
+// 第 k 个采样的时间戳：优先取对应脉冲的实测时刻
+static int64_t _mpu6050_sample_ts(uint32_t k)
+{
+    uint32_t pulses = atomic_load_explicit(&s_int_pulses, memory_order_acquire);
+    if (pulses == 0) {
+        return esp_timer_get_time();
+    }
+
+    uint32_t newest = pulses - 1;
+    int64_t newest_ts = s_int_ts[newest & MPU6050_INT_TS_MASK];
+    int32_t ahead = (int32_t)(k - newest);
+
+    if (ahead > 0) {
+        // 帧已进 FIFO 但 ISR 尚未执行
+        return newest_ts + (int64_t)ahead * s_period_us;
+    }
+    if ((uint32_t)(-ahead) < MPU6050_INT_TS_RING / 2) {
+        return s_int_ts[k & MPU6050_INT_TS_MASK];
+    }
+    // 积压过多，时间戳已被覆盖
+    return newest_ts + (int64_t)ahead * s_period_us;
+}
+
+static inline uint32_t _mpu6050_pulse_count(void)
+{
+    return atomic_load_explicit(&s_int_pulses, memory_order_acquire);
+}
+
+// 等待数据：中断通知或超时
+static void _mpu6050_wait_data(TickType_t *last_wake)
+{
+    (void)last_wake;
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MPU6050_INT_TIMEOUT_MS));
+}
+#else
+static void _mpu6050_wait_data(TickType_t *last_wake)
+{
+    vTaskDelayUntil(last_wake, pdMS_TO_TICKS(MPU6050_WAKE_PERIOD_MS));
+}
+#endif
+
+#if (MPU6050_ACQ_MODE == MPU6050_ACQ_MODE_FIFO)
+static mpu6050_raw_data_t s_fifo_frames[MPU6050_FIFO_READ_MAX];
+#if MPU6050_INT_ENABLE
+static uint32_t s_frame_index = 0;              // 下一个 FIFO 帧对应的脉冲序号
+
+/*
+ * 复位 FIFO 并对齐帧序号。复位经 I2C 完成，无法与中断计数放进同一临界区：
+ * 复位前后脉冲数不同时，无法判断那一帧是被清除还是已在复位后写入，重新复位直到期间没有脉冲。
+ */
+static void _mpu6050_fifo_resync(void)
+{
+    uint32_t after = 0;
+    for (int i = 0; i < MPU6050_INT_RESYNC_TRIES; i++) {
+        uint32_t before = _mpu6050_pulse_count();
+        mpu6050_fifo_reset();
+        after = _mpu6050_pulse_count();
+        if (after == before) {
+            break;
+        }
+    }
+    s_frame_index = after;
+}
+#endif
+#endif
+
+// 应用档位并更新采样节拍（初始化时或生产者两次读取之间调用）
+static esp_err_t _mpu6050_apply_profile(mpu6050_profile_t profile)
+{
+    esp_err_t err = mpu6050_apply_profile(profile);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+#if (MPU6050_ACQ_MODE == MPU6050_ACQ_MODE_FIFO) || MPU6050_INT_ENABLE
+    uint16_t rate = mpu6050_get_profile_desc(profile)->rate_hz;
+#else
+    // 定时轮询：输出率由任务周期决定，档位只改变传感器内部采样率与带宽
+    uint16_t rate = 1000 / MPU6050_SAMPLE_PERIOD_MS;
+#endif
+    _mpu6050_set_rate(rate);
+#if (MPU6050_ACQ_MODE == MPU6050_ACQ_MODE_FIFO)
+    uint32_t batch = (uint32_t)rate * MPU6050_FIFO_READ_PERIOD_MS / 1000;
+    s_int_batch = (batch > 0) ? batch : 1;
+#endif
+    s_profile = profile;
+
+#if (MPU6050_ACQ_MODE == MPU6050_ACQ_MODE_FIFO)
+    // 丢弃旧配置下的帧，之后读出的帧都属于新换算组
+    if (s_task_inited) {
+#if MPU6050_INT_ENABLE
+        _mpu6050_fifo_resync();
+#else
+        mpu6050_fifo_reset();
+#endif
+    }
+#endif
+    return ESP_OK;
+}
+
+static void _mpu6050_handle_profile_req(void)
+{
+    int req = atomic_exchange_explicit(&s_profile_req, -1, memory_order_acquire);
+    if (req < 0) {
+        return;
+    }
+
+    esp_err_t err = _mpu6050_apply_profile((mpu6050_profile_t)req);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "切换档位失败: %s", esp_err_to_name(err));
+    }
+}
+
+// 回放轨迹时由回放源代替传感器向后级供数（返回 true 表示本轮已处理，不再读取传感器）
+static bool _mpu6050_replay_step(void)
+{
+    mpu6050_trace_replay_state_t state = mpu6050_trace_replay_state();
+    if (state == MPU6050_TRACE_REPLAY_IDLE) {
+        return false;
+    }
+
+    int64_t now = esp_timer_get_time();
+    if (state == MPU6050_TRACE_REPLAY_PENDING) {
+        uint16_t rate = 0;
+        if (mpu6050_trace_replay_begin(now, &rate) == ESP_OK && rate > 0) {
+            _mpu6050_set_rate(rate);
+        }
+    }
+
+    // 按录制时间节奏交付到期采样，单轮数量与 FIFO 突发读取一致
+    mpu6050_sample_t sample;
+    size_t n = 0;
+    while (n < MPU6050_FIFO_READ_MAX && mpu6050_trace_replay_next(&sample, now)) {
+        sample.rate_gen = s_rate_gen;
+        _mpu6050_dispatch(&sample);
+        n++;
+    }
+    if (n > 0) {
+        _mpu6050_notify_consumer();
+    }
+
+    // 播完或被停止：恢复当前档位（同时复位 FIFO 丢弃回放期间积压的帧）与零偏
+    if (mpu6050_trace_replay_state() == MPU6050_TRACE_REPLAY_DONE) {
+        _mpu6050_apply_profile(s_profile);
+        mpu6050_trace_replay_finish();
+    }
+    return true;
+}
+
+#if (MPU6050_ACQ_MODE == MPU6050_ACQ_MODE_FIFO)
+
+static void _mpu6050_producer_task(void *arg)
+{
+    (void)arg;
+
+    mpu6050_sample_t sample;
+    size_t count = 0;
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (1) {
+        _mpu6050_wait_data(&last_wake);
+        if (_mpu6050_replay_step()) {
+            continue;
+        }
+
+        int64_t now = esp_timer_get_time();
+        esp_err_t err = mpu6050_fifo_read(s_fifo_frames, MPU6050_FIFO_READ_MAX, &count);
+        if (err != ESP_OK) {
+#if MPU6050_INT_ENABLE
+            // FIFO 已复位但序号未对齐，重新复位并从当前脉冲对齐
+            _mpu6050_fifo_resync();
+#endif
+            _mpu6050_handle_profile_req();
+            continue;
+        }
+
+        // 档位只在本任务中切换，FIFO 中的帧都属于当前换算组
+        sample.scale_id = mpu6050_get_scale_id();
+        sample.rate_gen = s_rate_gen;
+#if MPU6050_INT_ENABLE
+        // 从未收到脉冲（INT 未接线）：与定时唤醒一样推算时间戳
+        bool has_pulses = (_mpu6050_pulse_count() != 0);
+#endif
+
+        for (size_t i = 0; i < count; i++) {
+#if MPU6050_INT_ENABLE
+            if (has_pulses) {
+                sample.timestamp_us = _mpu6050_sample_ts(s_frame_index++);
+            } else
+#endif
+            {
+                // FIFO 不带时间戳：以读取时刻为最新一帧，按采样周期向前推算
+                sample.timestamp_us = now - (int64_t)(count - 1 - i) * s_period_us;
+            }
+            sample.raw = s_fifo_frames[i];
+            _mpu6050_dispatch(&sample);
+        }
+        _mpu6050_notify_consumer();
+
+        // 已读出的帧按旧档位交付后再切换
+        _mpu6050_handle_profile_req();
+    }
+}
+#else
 static void _mpu6050_producer_task(void *arg)
 {
     (void)arg;
 
-    mpu6050_raw_data_t raw_data;
-    const uint64_t read_interval = 1000000;  // 1000ms
-    uint64_t last_read_time = esp_timer_get_time();
-    
+    mpu6050_sample_t sample;
+    TickType_t last_wake = xTaskGetTickCount();
+
     while (1) {
-        uint64_t current_time = esp_timer_get_time();
-        if (current_time - last_read_time >= read_interval) {
-            ESP_ERROR_CHECK(mpu6050_read_raw_data(&raw_data));
-            last_read_time = current_time;
+        _mpu6050_wait_data(&last_wake);
+        if (_mpu6050_replay_step()) {
+            continue;
+        }
 
-            xQueueSend(g_mpu6050_queue, &raw_data, portMAX_DELAY);
+#if MPU6050_INT_ENABLE
+        sample.timestamp_us = _mpu6050_sample_ts(_mpu6050_pulse_count() - 1);
+#else
+        sample.timestamp_us = esp_timer_get_time();
+#endif
+        sample.scale_id = mpu6050_get_scale_id();
+        sample.rate_gen = s_rate_gen;
+        if (mpu6050_read_raw_data(&sample.raw) != ESP_OK) {
+            _mpu6050_handle_profile_req();
+            continue;
         }
 
-        vTaskDelay(pdMS_TO_TICKS(10));
+        _mpu6050_dispatch(&sample);
+        _mpu6050_notify_consumer();
+        _mpu6050_handle_profile_req();
     }
 }
+#endif
 
 static void _mpu6050_consumer_task(void *arg)
 {
     (void)arg;
 
-    mpu6050_raw_data_t raw_data;
-    mpu6050_data_t converted_data;
+    TickType_t wait = portMAX_DELAY;
 
     while (1) {
-        if (xQueueReceive(g_mpu6050_queue, &raw_data, portMAX_DELAY) == pdTRUE) {
-            ESP_ERROR_CHECK(mpu6050_convert_data(&raw_data, &converted_data));
+        ulTaskNotifyTake(pdTRUE, wait);
+
+        // 一次取完所有可用采样（回绕时分两段），逐段零拷贝处理
+        const void *span;
+        size_t n;
+        while ((n = spsc_ring_read_acquire(g_mpu6050_ring, &span)) > 0) {
+            const mpu6050_sample_t *samples = span;
+            mpu6050_sample_cb_t cb = s_sample_cb;
+            mpu6050_batch_cb_t batch_cb = s_batch_cb;
+            bool debug = esp_log_level_get(TAG) >= ESP_LOG_DEBUG;
+
+            for (size_t i = 0; i < n; i++) {
+                if (cb) {
+                    cb(&samples[i]);
+                }
+            }
+
+            // 轨迹录制（回放的数据同样可以再录制）
+            mpu6050_trace_feed(samples, n);
 
-            ESP_LOGI(TAG, "陀螺仪[dps]  X: %.2f  Y: %.2f  Z: %.2f",
-                     converted_data.gyro_x, converted_data.gyro_y, converted_data.gyro_z);
-            ESP_LOGI(TAG, "加速度[m/s²] X: %.2f  Y: %.2f  Z: %.2f",
-                     converted_data.accel_x, converted_data.accel_y, converted_data.accel_z);
+            // 后台静止检测，更新陀螺仪零偏（回放数据不参与）
+            if (!mpu6050_trace_replay_active()) {
+                mpu6050_calib_feed(samples, n);
+            }
+
+            // 按换算组分段，每段一次换算为物理量（直接跨步读取 samples[i].raw，无中间拷贝）
+            for (size_t off = 0, run; (batch_cb || debug) && off < n; off += run) {
+                uint8_t scale_id = samples[off].scale_id;
+                for (run = 1; off + run < n && samples[off + run].scale_id == scale_id; run++) {
+                }
+
+                mpu6050_convert_batch_scaled(&samples[off].raw, sizeof(mpu6050_sample_t), run,
+                                             scale_id, &s_soa);
+                if (batch_cb) {
+                    batch_cb(&samples[off], &s_soa, run);
+                }
+
+                if (debug) {
+                    ESP_LOGD(TAG, "陀螺仪[dps]  X: %.2f  Y: %.2f  Z: %.2f",
+                             s_soa.gyro_x[run - 1], s_soa.gyro_y[run - 1], s_soa.gyro_z[run - 1]);
+                    ESP_LOGD(TAG, "加速度[m/s²] X: %.2f  Y: %.2f  Z: %.2f",
+                             s_soa.accel_x[run - 1], s_soa.accel_y[run - 1], s_soa.accel_z[run - 1]);
+                }
+            }
+
+            spsc_ring_read_release(g_mpu6050_ring, n);
         }
+
+        // 空闲回调决定下一轮最长等待时间（超时醒来也会再调用一次）
+        mpu6050_idle_cb_t idle_cb = s_idle_cb;
+        wait = portMAX_DELAY;
+        if (idle_cb) {
+            uint32_t ms = idle_cb(esp_timer_get_time());
+            if (ms != MPU6050_IDLE_WAIT_FOREVER) {
+                TickType_t ticks = pdMS_TO_TICKS(ms);
+                wait = (ticks > 0) ? ticks : 1;
+            }
+        }
+    }
+}
+
+void mpu6050_task_set_sample_cb(mpu6050_sample_cb_t cb)
+{
+    s_sample_cb = cb;
+}
+
+void mpu6050_task_set_batch_cb(mpu6050_batch_cb_t cb)
+{
+    s_batch_cb = cb;
+}
+
+void mpu6050_task_set_realtime_cb(mpu6050_realtime_cb_t cb)
+{
+    s_realtime_cb = cb;
+}
+
+void mpu6050_task_set_idle_cb(mpu6050_idle_cb_t cb)
+{
+    s_idle_cb = cb;
+    _mpu6050_notify_consumer();     // 让消费者按新回调重新计算等待时间
+}
+
+esp_err_t mpu6050_task_set_profile(mpu6050_profile_t profile)
+{
+    if (mpu6050_get_profile_desc(profile) == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!s_task_inited) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    atomic_store_explicit(&s_profile_req, (int)profile, memory_order_release);
+#if MPU6050_INT_ENABLE
+    // 定时唤醒模式下最迟一个周期后生效
+    xTaskNotifyGive(s_producer);
+#endif
+    return ESP_OK;
+}
+
+mpu6050_profile_t mpu6050_task_get_profile(void)
+{
+    return s_profile;
+}
+
+uint16_t mpu6050_task_get_rate_hz(void)
+{
+    return s_rate_hz;
+}
+
+void mpu6050_task_get_ring_stats(spsc_ring_stats_t *stats)
+{
+    if (stats == NULL) return;
+
+    if (g_mpu6050_ring == NULL) {
+        memset(stats, 0, sizeof(*stats));
+        return;
     }
+    spsc_ring_get_stats(g_mpu6050_ring, stats);
 }
 
 esp_err_t mpu6050_task_init(void)
 {
+    if (s_task_inited) {
+        return ESP_OK;
+    }
+
     // 初始化 MPU6050 驱动
-    ESP_ERROR_CHECK(mpu6050_init());
+    esp_err_t ret = mpu6050_init();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "MPU6050 初始化失败: %s", esp_err_to_name(ret));
+        return ret;
+    }
 
-    // 校准陀螺仪（静止状态下进行）
-    ESP_LOGI(TAG, "请保持设备静止，正在校准...");
-    ESP_ERROR_CHECK(mpu6050_calibrate_gyro(NULL, 100));
+    // 恢复上次保存的陀螺仪零偏；没有时先按未校准数据输出，静止后由消费者后台校准
+    mpu6050_calib_load();
 
-    // 创建数据队列
-    g_mpu6050_queue = xQueueCreate(MPU6050_QUEUE_LEN, sizeof(mpu6050_raw_data_t));
-    if (g_mpu6050_queue == NULL) {
-        ESP_LOGE(TAG, "创建队列失败");
-        return ESP_ERR_NO_MEM;
+    // 启动档位：采样率、DLPF、量程（中断驱动轮询时传感器输出率即读取节拍）
+    ret = _mpu6050_apply_profile(MPU6050_DEFAULT_PROFILE);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "档位配置失败: %s", esp_err_to_name(ret));
+        return ret;
     }
 
+#if (MPU6050_ACQ_MODE == MPU6050_ACQ_MODE_FIFO)
+    // 开启 FIFO
+    ret = mpu6050_fifo_enable(true);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "FIFO 配置失败: %s", esp_err_to_name(ret));
+        return ret;
+    }
+#endif
+
+    // 创建采样环形缓冲
+    ret = spsc_ring_create(&g_mpu6050_ring, sizeof(mpu6050_sample_t), MPU6050_RING_LEN,
+                           MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "创建采样缓冲失败");
+        return ret;
+    }
+
+#if MPU6050_INT_ENABLE
+    // 生产者创建前挂好中断（句柄为空时 ISR 只记录时间戳）；FIFO 帧序号从当前脉冲开始对齐
+    ret = _mpu6050_int_init();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "INT 中断配置失败（%s），按 %d ms 超时轮询", esp_err_to_name(ret), MPU6050_INT_TIMEOUT_MS);
+    }
+#if (MPU6050_ACQ_MODE == MPU6050_ACQ_MODE_FIFO)
+    _mpu6050_fifo_resync();
+#endif
+#endif
+
     // 创建生产者任务
-    BaseType_t ret = xTaskCreate(
-        _mpu6050_producer_task,
-        "mpu6050_producer",
-        MPU6050_TASK_STACK_SIZE,
-        NULL,
-        MPU6050_PRODUCER_TASK_PRIORITY,
-        NULL
-    );
-    if (ret != pdPASS) {
+    ret = sys_task_create(SYS_TASK_ID_MPU6050_PRODUCER, _mpu6050_producer_task, NULL, &s_producer);
+    if (ret != ESP_OK) {
         ESP_LOGE(TAG, "创建生产者任务失败");
         return ESP_FAIL;
     }
 
     // 创建消费者任务
-    ret = xTaskCreate(
-        _mpu6050_consumer_task,
-        "mpu6050_consumer",
-        MPU6050_TASK_STACK_SIZE,
-        NULL,
-        MPU6050_CONSUMER_TASK_PRIORITY,
-        NULL
-    );
-    if (ret != pdPASS) {
+    ret = sys_task_create(SYS_TASK_ID_MPU6050_CONSUMER, _mpu6050_consumer_task, NULL, &s_consumer);
+    if (ret != ESP_OK) {
         ESP_LOGE(TAG, "创建消费者任务失败");
         return ESP_FAIL;
     }
@@ -95,4 +572,4 @@ esp_err_t mpu6050_task_init(void)
     s_task_inited = true;
     ESP_LOGI(TAG, "任务初始化完成");
     return ESP_OK;
-}
\ No newline at end of file
+}
@@ -0,0 +1,368 @@
+#include "mpu6050_trace.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *TAG = "mpu6050_trace";
+
+#define TRACE_HEADER_BYTES      (sizeof(mpu6050_trace_header_t))
+#define TRACE_RECORD_BYTES      (sizeof(mpu6050_trace_record_t))
+
+/* ================= 录制（状态机：控制方启动/停止，消费者写入与收尾） ================= */
+static atomic_int s_rec_state = MPU6050_TRACE_REC_IDLE;
+static mpu6050_trace_sink_cb_t s_rec_sink = NULL;
+static uint8_t *s_rec_buf = NULL;               // PSRAM 录制缓冲：头部 + 记录
+static uint32_t s_rec_max = 0;
+static uint32_t s_rec_count = 0;
+static uint8_t s_rec_scale_id = 0;
+static mpu6050_trace_header_t s_rec_header;
+static mpu6050_trace_record_t s_rec_chunk[MPU6050_TRACE_CHUNK_RECORDS];   // 流式录制分片
+static uint32_t s_rec_chunk_n = 0;
+
+/* ================= 回放（状态机：控制方提交/停止，生产者切换与供数） ================= */
+static atomic_int s_rp_state = MPU6050_TRACE_REPLAY_IDLE;
+static mpu6050_trace_header_t s_rp_header;
+static const uint8_t *s_rp_records = NULL;
+static uint32_t s_rp_count = 0;
+static uint32_t s_rp_pos = 0;
+static uint16_t s_rp_record_bytes = 0;
+static bool s_rp_loop = false;
+static int64_t s_rp_t0 = 0;                     // 轨迹时间零点对应的设备时间
+static mpu6050_gyro_bias_t s_rp_saved_bias;     // 回放前的零偏
+static bool s_rp_saved_valid = false;
+
+static void _mpu6050_trace_fill_header(mpu6050_trace_header_t *h, const mpu6050_sample_t *first)
+{
+    mpu6050_scale_info_t info = {0};
+    mpu6050_get_scale_info(first->scale_id, &info);
+
+    memset(h, 0, sizeof(*h));
+    h->magic = MPU6050_TRACE_MAGIC;
+    h->version = MPU6050_TRACE_VERSION;
+    h->header_bytes = TRACE_HEADER_BYTES;
+    h->record_bytes = TRACE_RECORD_BYTES;
+    h->rate_hz = mpu6050_task_get_rate_hz();
+    h->profile = (uint8_t)mpu6050_task_get_profile();
+    h->gyro_range = info.gyro_range;
+    h->accel_range = info.accel_range;
+    h->gyro_sensitivity = info.gyro_sensitivity;
+    h->accel_sensitivity = info.accel_sensitivity;
+    h->start_us = first->timestamp_us;
+
+    mpu6050_gyro_bias_t bias;
+    if (mpu6050_get_gyro_bias(&bias) == ESP_OK) {
+        h->gyro_bias[0] = bias.gyro_x_bias;
+        h->gyro_bias[1] = bias.gyro_y_bias;
+        h->gyro_bias[2] = bias.gyro_z_bias;
+        h->flags |= MPU6050_TRACE_FLAG_BIAS_VALID;
+    }
+}
+
+static inline mpu6050_trace_record_t *_mpu6050_trace_psram_records(void)
+{
+    return (mpu6050_trace_record_t *)(s_rec_buf + TRACE_HEADER_BYTES);
+}
+
+static void _mpu6050_trace_rec_finish(const char *reason)
+{
+    if (s_rec_sink) {
+        if (s_rec_chunk_n > 0) {
+            s_rec_sink(s_rec_chunk, s_rec_chunk_n * TRACE_RECORD_BYTES);
+            s_rec_chunk_n = 0;
+        }
+    } else {
+        s_rec_header.sample_count = s_rec_count;
+        memcpy(s_rec_buf, &s_rec_header, TRACE_HEADER_BYTES);
+    }
+
+    atomic_store_explicit(&s_rec_state, MPU6050_TRACE_REC_DONE, memory_order_release);
+    ESP_LOGI(TAG, "录制结束（%s），共 %lu 个采样", reason, (unsigned long)s_rec_count);
+}
+
+void mpu6050_trace_feed(const mpu6050_sample_t *samples, size_t count)
+{
+    int state = atomic_load_explicit(&s_rec_state, memory_order_acquire);
+    if (state == MPU6050_TRACE_REC_IDLE || state == MPU6050_TRACE_REC_DONE) {
+        return;
+    }
+
+    if (state == MPU6050_TRACE_REC_STOPPING) {
+        _mpu6050_trace_rec_finish("停止");
+        return;
+    }
+
+    if (state == MPU6050_TRACE_REC_ARMED) {
+        // 与 record_stop 竞争：取消成功则缓冲可能已释放，不能再访问
+        int expected = MPU6050_TRACE_REC_ARMED;
+        if (count == 0 || !atomic_compare_exchange_strong(&s_rec_state, &expected, MPU6050_TRACE_REC_RUNNING)) {
+            return;
+        }
+        _mpu6050_trace_fill_header(&s_rec_header, &samples[0]);
+        s_rec_scale_id = samples[0].scale_id;
+        if (s_rec_sink) {
+            s_rec_sink(&s_rec_header, TRACE_HEADER_BYTES);
+        }
+        ESP_LOGI(TAG, "开始录制（%u Hz）", s_rec_header.rate_hz);
+    }
+
+    for (size_t k = 0; k < count; k++) {
+        const mpu6050_sample_t *s = &samples[k];
+
+        // 头部只描述一种量程（零偏后台更新不中断录制，回放按头部记录的零偏）
+        if (!mpu6050_scale_same_range(s->scale_id, s_rec_scale_id)) {
+            _mpu6050_trace_rec_finish("量程切换");
+            return;
+        }
+
+        mpu6050_trace_record_t *rec = s_rec_sink ? &s_rec_chunk[s_rec_chunk_n++]
+                                                 : &_mpu6050_trace_psram_records()[s_rec_count];
+        rec->t_us = (uint32_t)(s->timestamp_us - s_rec_header.start_us);
+        rec->accel[0] = s->raw.accel_x;
+        rec->accel[1] = s->raw.accel_y;
+        rec->accel[2] = s->raw.accel_z;
+        rec->gyro[0] = s->raw.gyro_x;
+        rec->gyro[1] = s->raw.gyro_y;
+        rec->gyro[2] = s->raw.gyro_z;
+        s_rec_count++;
+
+        if (s_rec_sink && s_rec_chunk_n == MPU6050_TRACE_CHUNK_RECORDS) {
+            s_rec_sink(s_rec_chunk, sizeof(s_rec_chunk));
+            s_rec_chunk_n = 0;
+        }
+
+        if (s_rec_max > 0 && s_rec_count >= s_rec_max) {
+            _mpu6050_trace_rec_finish("达到上限");
+            return;
+        }
+    }
+}
+
+esp_err_t mpu6050_trace_record_start(uint32_t max_samples, mpu6050_trace_sink_cb_t sink)
+{
+    if (sink == NULL && max_samples == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = mpu6050_trace_record_free();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    if (sink == NULL) {
+        size_t bytes = TRACE_HEADER_BYTES + (size_t)max_samples * TRACE_RECORD_BYTES;
+        s_rec_buf = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+        if (s_rec_buf == NULL) {
+            ESP_LOGE(TAG, "录制缓冲分配失败（%u 字节）", (unsigned)bytes);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    s_rec_sink = sink;
+    s_rec_max = max_samples;
+    s_rec_count = 0;
+    s_rec_chunk_n = 0;
+    atomic_store_explicit(&s_rec_state, MPU6050_TRACE_REC_ARMED, memory_order_release);
+    return ESP_OK;
+}
+
+esp_err_t mpu6050_trace_record_stop(void)
+{
+    int expected = MPU6050_TRACE_REC_ARMED;
+    if (atomic_compare_exchange_strong(&s_rec_state, &expected, MPU6050_TRACE_REC_IDLE)) {
+        // 尚未写入任何采样，直接取消
+        heap_caps_free(s_rec_buf);
+        s_rec_buf = NULL;
+        return ESP_OK;
+    }
+
+    expected = MPU6050_TRACE_REC_RUNNING;
+    if (atomic_compare_exchange_strong(&s_rec_state, &expected, MPU6050_TRACE_REC_STOPPING)) {
+        return ESP_OK;
+    }
+    return ESP_ERR_INVALID_STATE;
+}
+
+mpu6050_trace_rec_state_t mpu6050_trace_record_state(void)
+{
+    return (mpu6050_trace_rec_state_t)atomic_load(&s_rec_state);
+}
+
+esp_err_t mpu6050_trace_record_get(const void **data, size_t *len)
+{
+    if (data == NULL || len == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (atomic_load_explicit(&s_rec_state, memory_order_acquire) != MPU6050_TRACE_REC_DONE ||
+        s_rec_buf == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    *data = s_rec_buf;
+    *len = TRACE_HEADER_BYTES + (size_t)s_rec_count * TRACE_RECORD_BYTES;
+    return ESP_OK;
+}
+
+esp_err_t mpu6050_trace_record_free(void)
+{
+    int state = atomic_load_explicit(&s_rec_state, memory_order_acquire);
+    if (state != MPU6050_TRACE_REC_IDLE && state != MPU6050_TRACE_REC_DONE) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    heap_caps_free(s_rec_buf);
+    s_rec_buf = NULL;
+    atomic_store_explicit(&s_rec_state, MPU6050_TRACE_REC_IDLE, memory_order_release);
+    return ESP_OK;
+}
+
+esp_err_t mpu6050_trace_replay_start(const void *trace, size_t len, bool loop)
+{
+    if (trace == NULL || len < TRACE_HEADER_BYTES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (atomic_load_explicit(&s_rp_state, memory_order_acquire) != MPU6050_TRACE_REPLAY_IDLE) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    mpu6050_trace_header_t h;
+    memcpy(&h, trace, sizeof(h));
+    if (h.magic != MPU6050_TRACE_MAGIC || h.version != MPU6050_TRACE_VERSION ||
+        h.header_bytes < TRACE_HEADER_BYTES || h.header_bytes > len ||
+        h.record_bytes < TRACE_RECORD_BYTES || h.rate_hz == 0) {
+        ESP_LOGE(TAG, "轨迹格式无效");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t count = (uint32_t)((len - h.header_bytes) / h.record_bytes);
+    if (h.sample_count > 0 && h.sample_count < count) {
+        count = h.sample_count;
+    }
+    if (count == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_rp_header = h;
+    s_rp_records = (const uint8_t *)trace + h.header_bytes;
+    s_rp_count = count;
+    s_rp_record_bytes = h.record_bytes;
+    s_rp_loop = loop;
+    s_rp_pos = 0;
+    atomic_store_explicit(&s_rp_state, MPU6050_TRACE_REPLAY_PENDING, memory_order_release);
+
+    ESP_LOGI(TAG, "提交回放：%lu 个采样 @ %u Hz%s", (unsigned long)count, h.rate_hz, loop ? "（循环）" : "");
+    return ESP_OK;
+}
+
+void mpu6050_trace_replay_stop(void)
+{
+    int expected = MPU6050_TRACE_REPLAY_PENDING;
+    if (atomic_compare_exchange_strong(&s_rp_state, &expected, MPU6050_TRACE_REPLAY_IDLE)) {
+        return;
+    }
+    expected = MPU6050_TRACE_REPLAY_ACTIVE;
+    atomic_compare_exchange_strong(&s_rp_state, &expected, MPU6050_TRACE_REPLAY_DONE);
+}
+
+mpu6050_trace_replay_state_t mpu6050_trace_replay_state(void)
+{
+    return (mpu6050_trace_replay_state_t)atomic_load_explicit(&s_rp_state, memory_order_acquire);
+}
+
+bool mpu6050_trace_replay_active(void)
+{
+    return mpu6050_trace_replay_state() != MPU6050_TRACE_REPLAY_IDLE;
+}
+
+esp_err_t mpu6050_trace_replay_begin(int64_t now_us, uint16_t *rate_hz)
+{
+    const mpu6050_trace_header_t *h = &s_rp_header;
+
+    s_rp_saved_valid = (mpu6050_get_gyro_bias(&s_rp_saved_bias) == ESP_OK);
+
+    esp_err_t err = mpu6050_set_gyro_range(h->gyro_range);
+    if (err == ESP_OK) {
+        err = mpu6050_set_accel_range(h->accel_range);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "回放量程设置失败: %s", esp_err_to_name(err));
+        atomic_store_explicit(&s_rp_state, MPU6050_TRACE_REPLAY_DONE, memory_order_release);
+        return err;
+    }
+
+    // 录制时未校准：回放期间也不扣零偏，与录制时的换算一致
+    if (h->flags & MPU6050_TRACE_FLAG_BIAS_VALID) {
+        mpu6050_gyro_bias_t bias = {h->gyro_bias[0], h->gyro_bias[1], h->gyro_bias[2]};
+        mpu6050_set_gyro_bias(&bias);
+    } else {
+        mpu6050_clear_gyro_bias();
+    }
+
+    s_rp_t0 = now_us;
+    s_rp_pos = 0;
+    if (rate_hz) {
+        *rate_hz = h->rate_hz;
+    }
+
+    // 切换期间被停止：交给生产者恢复
+    int expected = MPU6050_TRACE_REPLAY_PENDING;
+    if (!atomic_compare_exchange_strong(&s_rp_state, &expected, MPU6050_TRACE_REPLAY_ACTIVE)) {
+        atomic_store_explicit(&s_rp_state, MPU6050_TRACE_REPLAY_DONE, memory_order_release);
+    }
+    return ESP_OK;
+}
+
+bool mpu6050_trace_replay_next(mpu6050_sample_t *out, int64_t now_us)
+{
+    if (atomic_load_explicit(&s_rp_state, memory_order_acquire) != MPU6050_TRACE_REPLAY_ACTIVE) {
+        return false;
+    }
+
+    if (s_rp_pos >= s_rp_count) {
+        if (!s_rp_loop) {
+            int expected = MPU6050_TRACE_REPLAY_ACTIVE;
+            atomic_compare_exchange_strong(&s_rp_state, &expected, MPU6050_TRACE_REPLAY_DONE);
+            return false;
+        }
+
+        // 循环：下一轮接在最后一个采样之后一个采样周期
+        mpu6050_trace_record_t last;
+        memcpy(&last, s_rp_records + (size_t)(s_rp_count - 1) * s_rp_record_bytes, sizeof(last));
+        s_rp_t0 += (int64_t)last.t_us + 1000000 / s_rp_header.rate_hz;
+        s_rp_pos = 0;
+    }
+
+    mpu6050_trace_record_t rec;
+    memcpy(&rec, s_rp_records + (size_t)s_rp_pos * s_rp_record_bytes, sizeof(rec));
+
+    int64_t due = s_rp_t0 + rec.t_us;
+    if (due > now_us) {
+        return false;
+    }
+
+    out->timestamp_us = due;
+    out->raw.accel_x = rec.accel[0];
+    out->raw.accel_y = rec.accel[1];
+    out->raw.accel_z = rec.accel[2];
+    out->raw.gyro_x = rec.gyro[0];
+    out->raw.gyro_y = rec.gyro[1];
+    out->raw.gyro_z = rec.gyro[2];
+    out->scale_id = mpu6050_get_scale_id();
+    s_rp_pos++;
+    return true;
+}
+
+void mpu6050_trace_replay_finish(void)
+{
+    // 档位恢复时已把零偏换算回原量程，这里换回回放前的值；回放前未校准则清除，轨迹零偏不能带入实时数据
+    if (s_rp_saved_valid) {
+        mpu6050_set_gyro_bias(&s_rp_saved_bias);
+    } else {
+        mpu6050_clear_gyro_bias();
+    }
+
+    atomic_store_explicit(&s_rp_state, MPU6050_TRACE_REPLAY_IDLE, memory_order_release);
+    ESP_LOGI(TAG, "回放结束");
+}
@@ -1,6 +1,8 @@
 #ifndef __MYMQTT_H__
 #define __MYMQTT_H__
 
+#include "mymqtt_config.h"
+#include "st7789.h"
 #include "esp_err.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -8,21 +10,297 @@
 
 /**
  * @brief 图像帧接收完成回调
- * @param image_data RGB565 图像数据（240x240）
+ *
+ * 帧缓冲所有权随回调交给调用方（零拷贝），使用完毕后必须调用 mymqtt_image_release() 归还，
+ * 否则接收端没有空闲缓冲区，后续帧会被丢弃。
+ *
+ * @param image_data RGB565 图像数据（240x240，字节序由 MYMQTT_IMG_SWAP_BYTES 决定）
  */
 typedef void (*mymqtt_image_cb_t)(const uint16_t *image_data);
 
+/**
+ * @brief 分块图像帧（直通模式）
+ *
+ * 各块为内部 RAM 中的 DMA 内存，已是面板字节序，按顺序拼成整帧，可直接交给 st7789_draw_chunks。
+ */
+typedef struct {
+    st7789_chunk_t chunks[MYMQTT_IMG_CHUNK_COUNT];
+    size_t count;
+} mymqtt_img_frame_t;
+
+/**
+ * @brief 分块图像帧接收完成回调（在 esp-mqtt 任务中调用）
+ *
+ * 帧所有权随回调交给调用方，显示完成后必须调用 mymqtt_frame_release() 归还。
+ *
+ * @param frame 帧描述
+ */
+typedef void (*mymqtt_frame_cb_t)(const mymqtt_img_frame_t *frame);
+
+/**
+ * @brief 区域更新（若干完整行）
+ */
+typedef struct {
+    uint16_t x;                 // 起始列
+    uint16_t y;                 // 起始行
+    uint16_t w;                 // 宽度（像素）
+    uint16_t h;                 // 行数
+    const uint16_t *pixels;     // 像素（w*h，字节序由 MYMQTT_IMG_SWAP_BYTES 决定，回调返回后失效）
+} mymqtt_roi_t;
+
+/**
+ * @brief 区域更新回调（在 esp-mqtt 任务中调用）
+ *
+ * 一个区域可能分多次回调：每收齐若干行交付一次，各次的行依次相接。
+ *
+ * @param roi 区域
+ */
+typedef void (*mymqtt_roi_cb_t)(const mymqtt_roi_t *roi);
+
+/**
+ * @brief 入站消息分片
+ *
+ * 大消息按接收缓冲区大小分片到达，同一条消息的分片按顺序交给同一个处理函数：
+ * offset == 0 为首个分片，offset + len == total_len 为最后一个分片。
+ * data 为 NULL 表示消息中断（断线），处理函数应丢弃已收到的部分。
+ */
+typedef struct {
+    const char *topic;      // 主题（不以 0 结尾，只在首个分片有效，后续分片为 NULL）
+    size_t topic_len;
+    const uint8_t *data;    // 分片数据（回调返回后失效）
+    size_t len;             // 分片长度
+    size_t offset;          // 分片在整条消息中的偏移
+    size_t total_len;       // 整条消息长度
+} mymqtt_msg_frag_t;
+
+/**
+ * @brief 入站消息处理函数（在 esp-mqtt 任务中调用，不应阻塞）
+ * @param frag 分片
+ * @param arg 注册时的用户参数
+ */
+typedef void (*mymqtt_msg_handler_t)(const mymqtt_msg_frag_t *frag, void *arg);
+
 /**
  * @brief 初始化 MQTT 客户端
+ *
+ * 不阻塞等待网络：STA 尚未获取 IP 时，客户端在 IP_EVENT_STA_GOT_IP 到达后立即启动。
+ *
  * @param image_cb 图像帧完成回调（可为 NULL）
  * @return ESP_OK 成功
  */
 esp_err_t mymqtt_init(mymqtt_image_cb_t image_cb);
 
+/**
+ * @brief 设置区域更新回调，订阅 MYMQTT_TOPIC_IMAGE_ROI（须在 mymqtt_init 之前调用）
+ * @param roi_cb 区域更新回调
+ * @return ESP_OK 成功，ESP_ERR_INVALID_STATE 已初始化，ESP_ERR_NOT_SUPPORTED MYMQTT_ROI_ENABLE 为 0
+ */
+esp_err_t mymqtt_set_roi_cb(mymqtt_roi_cb_t roi_cb);
+
+/**
+ * @brief 设置分块帧回调，启用直通模式（须在 mymqtt_init 之前调用）
+ *
+ * 设置后帧缓冲按 DMA 块分配，完整帧交给 frame_cb，mymqtt_init 的 image_cb 不再使用。
+ * 要求 MYMQTT_IMG_SWAP_BYTES 为 1（块数据即面板字节序）。
+ *
+ * @param frame_cb 分块帧回调
+ * @return ESP_OK 成功，ESP_ERR_INVALID_STATE 已初始化，ESP_ERR_NOT_SUPPORTED 未开启字节序交换
+ */
+esp_err_t mymqtt_set_frame_cb(mymqtt_frame_cb_t frame_cb);
+
 bool mymqtt_is_inited(void);
 bool mymqtt_is_connected(void);
+
+/**
+ * @brief 等待 MQTT 连接建立
+ * @param timeout_ms 超时时间（毫秒）
+ * @return ESP_OK 已连接，ESP_ERR_TIMEOUT 超时，ESP_ERR_INVALID_STATE 未初始化
+ */
+esp_err_t mymqtt_wait_connected(uint32_t timeout_ms);
+
+/* 发布标志 */
+#define MYMQTT_PUB_FLAG_COALESCE        (1U << 0)      // 同一主题只保留最新一条未发出的消息（状态类数据，如姿态；主题须为常量字符串）
+
+/**
+ * @brief 拥塞状态变化回调（在发布方或 mqtt_tx 任务中调用，不应阻塞）
+ * @param congested true 进入拥塞（QoS 0 消息将被拒绝），false 解除拥塞
+ */
+typedef void (*mymqtt_backpressure_cb_t)(bool congested);
+
+/**
+ * @brief 消息交给 esp-mqtt 后的回调（在 mqtt_tx 任务中调用，不应阻塞）
+ * @param topic 主题
+ * @param data 数据
+ * @param len 长度
+ * @param enqueue_us esp_mqtt_client_enqueue 返回时间（esp_timer_get_time）
+ */
+typedef void (*mymqtt_sent_cb_t)(const char *topic, const void *data, size_t len, int64_t enqueue_us);
+
+/**
+ * @brief 发布队列统计
+ */
+typedef struct {
+    uint32_t queued;            // 入队消息数
+    uint32_t coalesced;         // 被同主题新消息覆盖的消息数
+    uint32_t sent;              // 交给 esp-mqtt 的消息数
+    uint32_t dropped_full;      // 队列满被拒绝的消息数
+    uint32_t dropped_congested; // 拥塞时被拒绝的 QoS 0 消息数
+    uint32_t dropped_offline;   // 断线期间出队时丢弃的 QoS 0 消息数
+    uint32_t dropped_outbox;    // 断线期间 outbox 已达上限而丢弃的 QoS 1 消息数
+    uint32_t enqueue_failed;    // esp_mqtt_client_enqueue 失败数
+    uint32_t outbox_stalls;     // 因 outbox 过大暂停交付的次数
+    uint32_t batches;           // 发送任务唤醒处理的批次数
+    uint32_t max_batch;         // 单批最多消息数
+    uint32_t peak_used_bytes;   // 队列最大占用（字节）
+    uint32_t peak_outbox_bytes; // esp-mqtt outbox 最大占用（字节）
+} mymqtt_tx_stats_t;
+
+/**
+ * @brief 发布消息（非阻塞：拷入发布队列后立即返回，由 mqtt_tx 任务交给 esp-mqtt）
+ *
+ * @param topic 主题
+ * @param data 数据（返回后即可复用）
+ * @param len 长度
+ * @param qos QoS
+ * @return 0 已入队，-1 未连接、参数无效、队列满或拥塞时的 QoS 0 消息
+ */
 int mymqtt_publish(const char *topic, const void *data, size_t len, int qos);
+
+/**
+ * @brief 带标志发布（见 MYMQTT_PUB_FLAG_*），其余同 mymqtt_publish
+ */
+int mymqtt_publish_ex(const char *topic, const void *data, size_t len, int qos, uint32_t flags);
+
+/**
+ * @brief 发布队列是否拥塞（发布方可据此降低发送频率）
+ */
+bool mymqtt_is_congested(void);
+
+/**
+ * @brief 设置拥塞状态变化回调（NULL 取消）
+ */
+void mymqtt_set_backpressure_cb(mymqtt_backpressure_cb_t cb);
+
+/**
+ * @brief 设置消息交给 esp-mqtt 后的回调（NULL 取消；用于统计发布方到 esp-mqtt 的端到端时延）
+ */
+void mymqtt_set_sent_cb(mymqtt_sent_cb_t cb);
+
+/**
+ * @brief 获取发布队列统计
+ * @param stats 输出
+ */
+void mymqtt_get_tx_stats(mymqtt_tx_stats_t *stats);
+
 esp_err_t mymqtt_subscribe(const char *topic, int qos);
 esp_err_t mymqtt_unsubscribe(const char *topic);
 
+/**
+ * @brief 注册主题处理函数并订阅（连接后立即订阅，重连后自动重新订阅）
+ *
+ * 主题过滤器支持 MQTT 通配符：'+' 匹配单层，'#' 匹配其后任意层（须为最后一层）。
+ * 不含通配符的过滤器按哈希精确匹配，含通配符的按层级前缀树匹配；精确匹配优先。
+ * 只在每条消息的首个分片查找一次，后续分片直接交给同一处理函数。
+ *
+ * @param filter 主题过滤器（常量字符串，路由表会长期引用其中的层级名）
+ * @param qos 订阅 QoS
+ * @param handler 处理函数
+ * @param arg 用户参数
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 过滤器无效，ESP_ERR_INVALID_STATE 未初始化或已注册，ESP_ERR_NO_MEM 路由表已满
+ */
+esp_err_t mymqtt_register_handler(const char *filter, int qos, mymqtt_msg_handler_t handler, void *arg);
+
+/**
+ * @brief 注销主题处理函数并取消订阅
+ *
+ * @param filter 注册时的过滤器
+ * @return ESP_OK 成功，ESP_ERR_NOT_FOUND 未注册
+ */
+esp_err_t mymqtt_unregister_handler(const char *filter);
+
+/**
+ * @brief 图像接收统计（自上次清零起）
+ */
+typedef struct {
+    uint32_t rx_buffer_size;    // 当前生效的接收缓冲区大小
+    uint32_t frames;            // 完整接收的帧数
+    uint32_t dropped;           // 无空闲缓冲区丢弃的帧数
+    uint32_t fragments;         // 完整帧的分片总数
+    uint64_t bytes;             // 完整帧的字节数
+    uint32_t frame_us_min;      // 单帧首个分片到最后一个分片的耗时
+    uint32_t frame_us_max;
+    uint64_t frame_us_sum;
+    uint32_t roi_updates;       // 完整接收的区域更新数
+    uint32_t roi_rejected;      // 头部无效或长度不符的区域更新数
+    uint64_t roi_bytes;         // 区域更新的字节数（含头部）
+    int64_t since_us;           // 统计起点（esp_timer 时间）
+} mymqtt_rx_stats_t;
+
+/**
+ * @brief 设置接收缓冲区大小（保存到 NVS，下次初始化客户端时生效）
+ *
+ * @param size 字节数（MYMQTT_RX_BUFFER_MIN ~ MYMQTT_RX_BUFFER_MAX）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 超出范围，ESP_ERR_INVALID_STATE NVS 未初始化，其他值表示写入失败
+ */
+esp_err_t mymqtt_set_rx_buffer_size(size_t size);
+
+/**
+ * @brief 获取当前生效的接收缓冲区大小
+ */
+size_t mymqtt_get_rx_buffer_size(void);
+
+/**
+ * @brief 获取图像接收统计
+ * @param stats 输出
+ */
+void mymqtt_get_rx_stats(mymqtt_rx_stats_t *stats);
+
+/**
+ * @brief 清零图像接收统计
+ */
+void mymqtt_reset_rx_stats(void);
+
+/**
+ * @brief 断线恢复耗时（最近一次，起点为 Wi-Fi 断开；仅 MQTT 断开时起点为 MQTT 断开）
+ */
+typedef struct {
+    uint32_t count;             // 已完成的恢复次数
+    uint32_t ip_ms;             // 起点 → 重新获取 IP（仅 MQTT 断开时为 0）
+    uint32_t connect_ms;        // 起点 → MQTT 重新连接
+    uint32_t first_frame_ms;    // 起点 → 第一帧完整接收并交给显示
+    bool session_present;       // 重连时代理是否保留了会话（订阅无需重建）
+} mymqtt_recovery_t;
+
+/**
+ * @brief 获取最近一次断线恢复耗时
+ * @param out 输出
+ */
+void mymqtt_get_recovery(mymqtt_recovery_t *out);
+
+/**
+ * @brief 获取累计显示帧数（由显示端提供，反馈据此计算显示帧率）
+ */
+typedef uint32_t (*mymqtt_frame_count_cb_t)(void);
+
+/**
+ * @brief 启动图像接收反馈（周期发布到 MYMQTT_TOPIC_IMG_FEEDBACK，协议见 mymqtt_config.h）
+ *
+ * @param displayed_cb 累计显示帧数（NULL 时以交付给消费者的帧数代替）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_STATE 未初始化或已启动，ESP_ERR_NOT_SUPPORTED MYMQTT_FEEDBACK_ENABLE 为 0，
+ *         其他值表示定时器创建失败
+ */
+esp_err_t mymqtt_feedback_start(mymqtt_frame_count_cb_t displayed_cb);
+
+/**
+ * @brief 归还图像帧缓冲区（与 mymqtt_image_cb_t 回调交出的帧一一对应，可在任意任务中调用）
+ * @param image_data 回调传入的图像数据指针
+ */
+void mymqtt_image_release(const uint16_t *image_data);
+
+/**
+ * @brief 归还分块帧（与 mymqtt_frame_cb_t 回调交出的帧一一对应，可在任意任务中调用）
+ * @param frame 回调传入的帧描述
+ */
+void mymqtt_frame_release(const mymqtt_img_frame_t *frame);
+
 #endif /* __MYMQTT_H__ */
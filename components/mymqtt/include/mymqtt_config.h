@@ -7,12 +7,76 @@
 #define MYMQTT_USERNAME            "RobiEcho"
 #define MYMQTT_PASSWORD            "123456"
 
+/* ================= Session / Reconnect ================= */
+/*
+ * 持久会话（clean_session=false）：代理在断线期间保留订阅与未确认的 QoS 1 消息，
+ * 重连时 CONNACK 带 session_present，无需重新订阅。
+ * 图像与区域更新以 QoS 0 订阅，代理不为离线会话排队：重连后直接从下一帧开始，
+ * 不会先回放断线期间的过期画面；只有命令类主题（QoS 1）依赖会话补发。
+ *
+ * Wi-Fi 断开时立即停止客户端（不等心跳超时才发现连接已死），获取 IP 后立即启动，
+ * 不经过 esp-mqtt 的重连等待；重连间隔只在 Wi-Fi 在线而代理不可达时生效。
+ */
+#define MYMQTT_PERSISTENT_SESSION  1
+#define MYMQTT_IMAGE_QOS           (0)            // 图像/区域更新订阅 QoS（过期帧无需补发）
+#define MYMQTT_KEEPALIVE_S         (15)           // 心跳周期（esp-mqtt 默认 120 秒，静默断链检测太慢）
+#define MYMQTT_RECONNECT_MS        (2000)         // 代理不可达时的重连间隔（esp-mqtt 默认 10 秒）
+#define MYMQTT_NETWORK_TIMEOUT_MS  (5000)         // 网络操作超时
+#define MYMQTT_STOP_ON_WIFI_LOSS   1              // Wi-Fi 断开时立即停止客户端，获取 IP 后立即重连
+
 /* ================= Buffer Config ================= */
-#define MYMQTT_RX_BUFFER_SIZE      (16 * 1024)    // 接收缓冲区大小（16KB）
+/*
+ * 接收缓冲区决定图像帧的分片大小：一帧 115200 字节按缓冲区大小切成若干 MQTT_EVENT_DATA，
+ * 缓冲区越大分片越少（每片一次事件回调与拼接调用），但占用更多内部 RAM。
+ * 运行时可由 NVS 覆盖（mymqtt_set_rx_buffer_size，重启后生效），便于按部署选择。
+ * TCP 接收窗口（CONFIG_LWIP_TCP_WND_DEFAULT）需与之配合，否则大缓冲区也会被窗口限速。
+ */
+#define MYMQTT_RX_BUFFER_SIZE      (16 * 1024)    // 默认接收缓冲区大小（16KB）
+#define MYMQTT_RX_BUFFER_MIN       (2 * 1024)     // 可配置下限
+#define MYMQTT_RX_BUFFER_MAX       (MYMQTT_IMG_BUF_SIZE)  // 可配置上限（一帧不再分片）
+#define MYMQTT_TX_BUFFER_SIZE      (2 * 1024)     // 发送缓冲区大小（出站消息都很小，不随接收缓冲区放大）
+
+/* ================= NVS ================= */
+#define MYMQTT_NVS_NAMESPACE       "mymqtt"
+#define MYMQTT_NVS_KEY_RX_BUF      "rx_buf"       // 接收缓冲区大小（字节）
+
+/* ================= Benchmark Commands ================= */
+/* 主机基准测试（tools/mqtt_rx_bench.py）通过命令主题切换缓冲区并读取接收统计。
+ * 命令无鉴权，任何能连上代理的客户端都可改写 NVS 并重启设备，默认关闭；
+ * 仅基准测试固件开启：在工程 CMakeLists.txt 的 project() 之前加入
+ *   idf_build_set_property(COMPILE_DEFINITIONS "MYMQTT_BENCH_CMD_ENABLE=1" APPEND) */
+#ifndef MYMQTT_BENCH_CMD_ENABLE
+#define MYMQTT_BENCH_CMD_ENABLE    0
+#endif
+#define MYMQTT_TOPIC_CMD_RX_BUF    "esp32/cmd/mqtt_rx_buf"    // 载荷：十进制字节数，保存后重启生效
+#define MYMQTT_TOPIC_CMD_RX_STATS  "esp32/cmd/mqtt_rx_stats"  // 载荷 "reset" 时回复后清零统计
+#define MYMQTT_TOPIC_RX_STATS      "esp32/mqtt_rx_stats"      // 接收统计回复（JSON）
+#define MYMQTT_RESTART_DELAY_MS    (500)          // 保存缓冲区配置后延时重启，让回复先发出
+
+/* ================= Outbound Queue Config ================= */
+/* mymqtt_publish 只把消息拷入发布队列，由 mqtt_tx 任务以 esp_mqtt_client_enqueue 交给 esp-mqtt 发送 */
+#define MYMQTT_OUT_QUEUE_BYTES          (8 * 1024)     // 发布队列容量（含每条消息头与主题）
+#define MYMQTT_OUT_HIGH_WATER_PCT       (75)           // 占用超过该比例进入拥塞：拒绝 QoS 0 新消息，为 QoS 1 留出空间
+#define MYMQTT_OUT_LOW_WATER_PCT        (25)           // 占用回落到该比例以下解除拥塞
+#define MYMQTT_OUT_OUTBOX_MAX_BYTES     (16 * 1024)    // esp-mqtt outbox 超过该值暂停交付（网络跟不上，压力回传到发布队列）；断线时超过则丢弃 QoS 1
+#define MYMQTT_OUT_STALL_POLL_MS        (10)           // outbox 过大时的重查间隔
+#define MYMQTT_OUT_COALESCE_SLOTS       (4)            // 合并槽数量（MYMQTT_PUB_FLAG_COALESCE 主题数上限）
+#define MYMQTT_OUT_COALESCE_MAX_BYTES   (64)           // 合并槽消息长度上限，更长的消息按普通消息排队
+#define MYMQTT_OUT_TOPIC_MAX_LEN        (63)           // 主题长度上限
+
+/* ================= Inbound Routing Config ================= */
+#define MYMQTT_ROUTE_MAX                (8)            // 可注册的主题处理函数数量
+#define MYMQTT_ROUTE_HASH_SIZE          (16)           // 精确主题哈希表槽数（2 的幂，不小于 2 倍 MYMQTT_ROUTE_MAX）
+#define MYMQTT_ROUTE_TRIE_NODES         (32)           // 通配符前缀树节点数（每个过滤器层级占一个，共享前缀复用）
 
 /* ================= Topic Config ================= */
 #define MYMQTT_TOPIC_MPU6050       "esp32/mpu6050_data"   // MPU6050 数据主题
+#define MYMQTT_TOPIC_POSE          "esp32/pose"           // 头部姿态主题（低时延）
+#define MYMQTT_TOPIC_GESTURE       "esp32/gesture"        // 动作事件主题（点头/摇头/敲击）
+#define MYMQTT_TOPIC_IMU_TRACE     "esp32/imu_trace"      // IMU 轨迹流式录制主题（按序拼接即为轨迹文件）
 #define MYMQTT_TOPIC_IMAGE         "esp32/image"     // 接收图像主题
+#define MYMQTT_TOPIC_IMAGE_ROI     "esp32/image_roi" // 接收区域更新主题（头部 + 子图像）
+#define MYMQTT_TOPIC_IMG_FEEDBACK  "esp32/image_feedback"  // 图像接收反馈主题（发布端据此调整帧率/质量）
 
 /* ================= Image Config ================= */
 #define MYMQTT_IMG_WIDTH           240
@@ -20,5 +84,48 @@
 #define MYMQTT_IMG_PIXEL_SIZE      2              // RGB565: 2字节/像素
 #define MYMQTT_IMG_BUF_SIZE        (MYMQTT_IMG_WIDTH * MYMQTT_IMG_HEIGHT * MYMQTT_IMG_PIXEL_SIZE)
 #define MYMQTT_IMG_TIMEOUT_US      (2000 * 1000)  // 图像接收超时（2秒）
+#define MYMQTT_IMG_BUF_COUNT       2              // 帧缓冲数量（2=双缓冲，消费者持有一帧，接收写另一帧）
+#define MYMQTT_IMG_SWAP_BYTES      1              // 拼接时交换字节序（1=输出与 LV_COLOR_16_SWAP 一致的大端 RGB565）
+
+/*
+ * 分块帧（mymqtt_set_frame_cb 直通模式）：帧按行切成若干 DMA 内存块，分片边拼接边交换字节序，
+ * 收满后块描述表直接交给 st7789_draw_chunks，省去整帧拷贝到 Ping-Pong 缓冲的一次搬运。
+ * 块在内部 RAM 中分配（MYMQTT_IMG_BUF_COUNT 帧共约 225KB），分块独立分配以适应碎片化的堆。
+ */
+#define MYMQTT_IMG_CHUNK_ROWS      24             // 每块行数（与屏幕单次 DMA 传输大小一致）
+#define MYMQTT_IMG_CHUNK_BYTES     (MYMQTT_IMG_WIDTH * MYMQTT_IMG_PIXEL_SIZE * MYMQTT_IMG_CHUNK_ROWS)
+#define MYMQTT_IMG_CHUNK_COUNT     (MYMQTT_IMG_BUF_SIZE / MYMQTT_IMG_CHUNK_BYTES)
+
+/*
+ * 区域更新（ROI）：只发送变化的矩形，适合界面镜像等大部分画面不变的场景。
+ * 载荷 = 8 字节头部（小端 uint16：x, y, w, h）+ w*h 个 RGB565 像素（行优先，字节序同整帧）。
+ * 像素边接收边交换字节序，每收齐若干行即交给回调输出，不等整条消息结束。
+ */
+#define MYMQTT_ROI_ENABLE          1              // 0=不订阅区域更新，不分配区域像素缓冲
+#define MYMQTT_ROI_HEADER_SIZE     8
+#define MYMQTT_ROI_BUF_SIZE        (MYMQTT_IMG_BUF_SIZE)  // 区域像素缓冲（最大为整屏）
+
+/* ================= Image Feedback ================= */
+/*
+ * 设备周期发布图像接收反馈（JSON，QoS 0），发布端按 target_fps 调整发送帧率：
+ *   {"seq":n,"period_ms":1000,"rx_fps":14.8,"disp_fps":14.0,"dropped":0,
+ *    "queue":0,"queue_cap":1,"target_fps":15,"level":0}
+ *   - rx_fps / disp_fps：本周期完整接收 / 实际显示的帧率
+ *   - dropped：本周期因无空闲帧缓冲丢弃的帧数
+ *   - queue / queue_cap：周期末等待显示的帧数 / 上限（帧缓冲总数减 1）；消费者一直持有屏幕上的一帧
+ *                        （LVGL 模式）或正在输出的一帧（直通模式），不计入，跟得上时为 0
+ *   - target_fps：建议发送帧率（加性增、乘性减：丢帧或积压时降为显示帧率的一定比例，
+ *                 连续若干周期无丢帧且不积压时加一档）
+ *   - level：0=跟得上，1=落后（丢帧或积压），2=严重落后（丢帧占一半以上）；
+ *            有压缩/降分辨率手段的发布端在 2 时降低质量，长时间为 0 时再恢复
+ * 发布端未收到反馈（设备离线或旧固件）时应保持原有帧率。
+ */
+#define MYMQTT_FEEDBACK_ENABLE         1          // 0=不提供 mymqtt_feedback_start
+#define MYMQTT_FEEDBACK_PERIOD_MS      (1000)     // 反馈周期
+#define MYMQTT_FEEDBACK_FPS_MIN        (1)        // 建议帧率下限
+#define MYMQTT_FEEDBACK_FPS_MAX        (30)       // 建议帧率上限
+#define MYMQTT_FEEDBACK_FPS_INIT       (10)       // 初始建议帧率
+#define MYMQTT_FEEDBACK_DECREASE_PCT   (80)       // 落后时建议帧率降为显示帧率的百分比
+#define MYMQTT_FEEDBACK_UP_PERIODS     (3)        // 连续无丢帧周期数达到后建议帧率加 1
 
 #endif /* __MYMQTT_CONFIG_H__ */
@@ -1,27 +1,296 @@
 #include "mymqtt.h"
 #include "mymqtt_config.h"
+#include "mymqtt_route.h"
 #include "mqtt_client.h"
+#include "sys_task.h"
+#include "nvs_storage.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_system.h"
 #include "esp_heap_caps.h"
+#include "esp_event.h"
+#include "esp_netif.h"
+#include "esp_wifi.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/ringbuf.h"
 #include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
 
 static const char *TAG = "mymqtt";
 
+/* esp-mqtt 内部任务由 esp-mqtt 创建，核心只能通过 Kconfig 选择，须与任务布局表一致 */
+#if !CONFIG_MQTT_TASK_CORE_SELECTION_ENABLED
+#error "请启用 CONFIG_MQTT_TASK_CORE_SELECTION_ENABLED，使 MQTT 任务绑定到 SYS_TASK_MQTT_CORE"
+#elif CONFIG_MQTT_USE_CORE_1
+_Static_assert(SYS_TASK_MQTT_CORE == 1, "SYS_TASK_MQTT_CORE 与 CONFIG_MQTT_USE_CORE_1 不一致");
+#else
+_Static_assert(SYS_TASK_MQTT_CORE == 0, "SYS_TASK_MQTT_CORE 与 CONFIG_MQTT_USE_CORE_0 不一致");
+#endif
+
 static esp_mqtt_client_handle_t s_hmqtt = NULL;
 static bool s_inited = false;
 static volatile bool s_connected = false;
+static atomic_bool s_started = false;       // 客户端是否已启动（等待获取 IP 后再启动）
+static EventGroupHandle_t s_mqtt_events = NULL;
+
+#define MYMQTT_CONNECTED_BIT    BIT0
+
+/* 订阅在离线期间有变化（持久会话恢复时仍需重新订阅）；初始为 true，
+ * 启动后第一次连接即使代理保留了上次运行的会话也要订阅（本次运行注册的主题可能不同） */
+static atomic_bool s_subs_dirty = true;
+
+#if MYMQTT_STOP_ON_WIFI_LOSS
+static atomic_bool s_stop_req = false;      // Wi-Fi 断开后待停止客户端（由发送任务执行）
+#endif
+
+/* 断线恢复计时（事件循环任务与 MQTT 任务都会更新） */
+static portMUX_TYPE s_rec_lock = portMUX_INITIALIZER_UNLOCKED;
+static int64_t s_rec_start_us = 0;          // 本次断线起点，0 表示未在恢复中
+static mymqtt_recovery_t s_rec_pending;     // 本次恢复进行中的各阶段耗时
+static mymqtt_recovery_t s_rec_last;        // 最近一次完成的恢复
 
 static mymqtt_image_cb_t s_image_cb = NULL;
+static mymqtt_frame_cb_t s_frame_cb = NULL;     // 非 NULL 时为分块直通模式
+static mymqtt_roi_cb_t s_roi_cb = NULL;
 
-static uint8_t *s_img_buf = NULL;           // 图像拼接缓冲区（115200 字节）
+/* ================= 发布队列 ================= */
+// 队列元素：头部 + 主题（含结尾 0）+ 数据，整体作为一个不可分割的环形缓冲项
+typedef struct {
+    uint8_t qos;
+    uint8_t topic_len;          // 不含结尾 0
+    uint16_t reserved;
+    uint32_t data_len;
+} mymqtt_tx_item_t;
+
+// 合并槽：同一主题只保留最新一条
+typedef struct {
+    const char *topic;          // 首次使用时绑定的主题（调用方常量字符串）
+    bool pending;
+    uint8_t qos;
+    uint16_t len;
+    uint8_t data[MYMQTT_OUT_COALESCE_MAX_BYTES];
+} mymqtt_tx_slot_t;
+
+static RingbufHandle_t s_tx_ring = NULL;
+static TaskHandle_t s_tx_task = NULL;
+static portMUX_TYPE s_tx_lock = portMUX_INITIALIZER_UNLOCKED;     // 保护合并槽与发布方统计
+static mymqtt_tx_slot_t s_tx_slots[MYMQTT_OUT_COALESCE_SLOTS];
+static mymqtt_tx_stats_t s_tx_stats;
+static atomic_bool s_tx_congested = false;
+static volatile mymqtt_backpressure_cb_t s_bp_cb = NULL;
+static volatile mymqtt_sent_cb_t s_sent_cb = NULL;
+
+_Static_assert(MYMQTT_IMG_BUF_SIZE % MYMQTT_IMG_CHUNK_BYTES == 0, "帧大小必须是分块大小的整数倍");
+_Static_assert(MYMQTT_IMG_CHUNK_BYTES % 2 == 0, "分块不能切开像素");
+_Static_assert(MYMQTT_IMG_CHUNK_BYTES <= ST7789_MAX_TRANS_BYTES, "分块超过屏幕单次传输上限");
+
+/*
+ * 帧缓冲池：拼接统一按块进行。连续模式下各块指向同一整帧缓冲（交给 LVGL），
+ * 直通模式下各块独立分配在 DMA 内存中（交给 st7789_draw_chunks）。
+ */
+static uint8_t *s_img_pool[MYMQTT_IMG_BUF_COUNT];           // 连续模式整帧缓冲（每帧 115200 字节）
+static mymqtt_img_frame_t s_img_frames[MYMQTT_IMG_BUF_COUNT];   // 各帧分块描述
+static atomic_bool s_img_pool_busy[MYMQTT_IMG_BUF_COUNT];   // 缓冲区是否被占用（拼接中或已交给消费者）
+static int s_img_cur = -1;                  // 当前拼接的帧（缓冲池下标，-1 表示无）
 static size_t s_img_buf_len = 0;            // 当前已接收字节数
-static bool s_receiving_image = false;      // 是否正在接收图像分片
+static uint32_t s_img_dropped = 0;          // 无空闲缓冲区而丢弃的帧数
+static uint32_t s_img_received = 0;         // 完整接收并交付的帧数
+
+#if MYMQTT_FEEDBACK_ENABLE
+/* 图像接收反馈（在 esp_timer 任务中计算并发布） */
+static esp_timer_handle_t s_fb_timer = NULL;
+static mymqtt_frame_count_cb_t s_fb_displayed_cb = NULL;
+static uint32_t s_fb_seq = 0;
+static uint32_t s_fb_last_rx = 0;
+static uint32_t s_fb_last_drop = 0;
+static uint32_t s_fb_last_disp = 0;
+static int64_t s_fb_last_us = 0;
+static uint32_t s_fb_target_fps = MYMQTT_FEEDBACK_FPS_INIT;
+static uint32_t s_fb_good_periods = 0;      // 连续无丢帧、无积压的周期数
+#endif
+
+#if MYMQTT_ROI_ENABLE
+/* 区域更新拼接状态（只在 MQTT 任务中访问） */
+static uint8_t *s_roi_buf = NULL;
+static mymqtt_roi_t s_roi;                  // 当前区域（pixels 指向 s_roi_buf）
+static bool s_roi_active = false;           // 正在接收有效区域
+static size_t s_roi_len = 0;                // 已接收像素字节数
+static uint16_t s_roi_rows_done = 0;        // 已交付行数
+#endif
+
+/* 接收缓冲区与接收统计（统计只在 MQTT 任务中更新，读取方加锁拷贝） */
+static size_t s_rx_buf_size = MYMQTT_RX_BUFFER_SIZE;
+static portMUX_TYPE s_rx_lock = portMUX_INITIALIZER_UNLOCKED;
+static mymqtt_rx_stats_t s_rx_stats;
+static int64_t s_img_start_us = 0;          // 当前帧首个分片的时间
+static uint32_t s_img_frags = 0;            // 当前帧已收到的分片数
+
+/* 当前入站消息的路由（首个分片查找一次，后续分片沿用） */
+static mymqtt_route_t s_rx_route;
+static bool s_rx_routed = false;
+
+// 从缓冲池取一个空闲帧，返回下标，没有空闲帧返回 -1
+static int _mymqtt_img_buf_acquire(void)
+{
+    for (int i = 0; i < MYMQTT_IMG_BUF_COUNT; i++) {
+        bool expected = false;
+        if (s_img_frames[i].count > 0 &&
+            atomic_compare_exchange_strong(&s_img_pool_busy[i], &expected, true)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// 分配帧缓冲池
+static esp_err_t _mymqtt_img_pool_init(void)
+{
+    for (int i = 0; i < MYMQTT_IMG_BUF_COUNT; i++) {
+        mymqtt_img_frame_t *frame = &s_img_frames[i];
+
+        if (s_frame_cb == NULL) {
+#if defined(CONFIG_GRAPHICS_USE_PSRAM)
+            s_img_pool[i] = heap_caps_malloc(MYMQTT_IMG_BUF_SIZE, MALLOC_CAP_SPIRAM);
+#else
+            s_img_pool[i] = heap_caps_malloc(MYMQTT_IMG_BUF_SIZE, MALLOC_CAP_DMA);
+#endif
+            if (s_img_pool[i] == NULL) {
+                ESP_LOGE(TAG, "图像缓冲区分配失败");
+                return ESP_ERR_NO_MEM;
+            }
+        }
+
+        for (int k = 0; k < MYMQTT_IMG_CHUNK_COUNT; k++) {
+            uint8_t *chunk = (s_frame_cb == NULL)
+                           ? s_img_pool[i] + (size_t)k * MYMQTT_IMG_CHUNK_BYTES
+                           : heap_caps_malloc(MYMQTT_IMG_CHUNK_BYTES, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+            if (chunk == NULL) {
+                ESP_LOGE(TAG, "图像分块分配失败（帧 %d 块 %d）", i, k);
+                return ESP_ERR_NO_MEM;
+            }
+            frame->chunks[k] = (st7789_chunk_t){ .data = chunk, .len = MYMQTT_IMG_CHUNK_BYTES };
+        }
+        frame->count = MYMQTT_IMG_CHUNK_COUNT;
+        atomic_init(&s_img_pool_busy[i], false);
+    }
+    return ESP_OK;
+}
+
+// 拼接分片到帧缓冲（可选交换字节序，分片边界落在像素中间时同样正确）
+static void _mymqtt_img_copy(uint8_t *dst, size_t offset, const uint8_t *src, size_t len)
+{
+#if MYMQTT_IMG_SWAP_BYTES
+    size_t i = 0;
+
+    // 上一分片结束在像素中间：当前首字节是该像素的高字节，放到前一个位置
+    if ((offset & 1) && len > 0) {
+        dst[offset - 1] = src[0];
+        i = 1;
+    }
+
+    for (; i + 1 < len; i += 2) {
+        dst[offset + i] = src[i + 1];
+        dst[offset + i + 1] = src[i];
+    }
+
+    // 本分片结束在像素中间：低字节放到后一个位置，等待下一分片补齐
+    if (i < len) {
+        dst[offset + i + 1] = src[i];
+    }
+#else
+    memcpy(dst + offset, src, len);
+#endif
+}
+
+// 断线：记录恢复起点（已在恢复中则保留更早的起点）
+static void _mymqtt_rec_link_down(void)
+{
+    int64_t now = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&s_rec_lock);
+    if (s_rec_start_us == 0) {
+        s_rec_start_us = now;
+        s_rec_pending = (mymqtt_recovery_t){ .count = s_rec_last.count };
+    }
+    taskEXIT_CRITICAL(&s_rec_lock);
+}
+
+static inline uint32_t _mymqtt_rec_elapsed_ms(int64_t now)
+{
+    return (uint32_t)((now - s_rec_start_us) / 1000);
+}
+
+static void _mymqtt_rec_got_ip(void)
+{
+    int64_t now = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&s_rec_lock);
+    if (s_rec_start_us != 0) {
+        s_rec_pending.ip_ms = _mymqtt_rec_elapsed_ms(now);
+    }
+    taskEXIT_CRITICAL(&s_rec_lock);
+}
+
+static void _mymqtt_rec_connected(bool session_present)
+{
+    int64_t now = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&s_rec_lock);
+    if (s_rec_start_us != 0) {
+        s_rec_pending.connect_ms = _mymqtt_rec_elapsed_ms(now);
+        s_rec_pending.session_present = session_present;
+    }
+    taskEXIT_CRITICAL(&s_rec_lock);
+}
+
+// 第一帧交给显示：恢复完成
+static void _mymqtt_rec_first_frame(void)
+{
+    int64_t now = esp_timer_get_time();
+    bool done = false;
+
+    taskENTER_CRITICAL(&s_rec_lock);
+    if (s_rec_start_us != 0 && s_connected) {
+        s_rec_pending.first_frame_ms = _mymqtt_rec_elapsed_ms(now);
+        s_rec_pending.count++;
+        s_rec_last = s_rec_pending;
+        s_rec_start_us = 0;
+        done = true;
+    }
+    taskEXIT_CRITICAL(&s_rec_lock);
+
+    if (done) {
+        ESP_LOGI(TAG, "断线恢复：IP %lu ms，MQTT %lu ms（会话%s），首帧 %lu ms",
+                 (unsigned long)s_rec_last.ip_ms, (unsigned long)s_rec_last.connect_ms,
+                 s_rec_last.session_present ? "保留" : "重建", (unsigned long)s_rec_last.first_frame_ms);
+    }
+}
+
+// 记录一帧完整接收
+static void _mymqtt_rx_stats_frame(int64_t elapsed_us)
+{
+    uint32_t us = (uint32_t)elapsed_us;
+
+    taskENTER_CRITICAL(&s_rx_lock);
+    s_rx_stats.frames++;
+    s_rx_stats.fragments += s_img_frags;
+    s_rx_stats.bytes += MYMQTT_IMG_BUF_SIZE;
+    s_rx_stats.frame_us_sum += us;
+    if (s_rx_stats.frames == 1 || us < s_rx_stats.frame_us_min) {
+        s_rx_stats.frame_us_min = us;
+    }
+    if (us > s_rx_stats.frame_us_max) {
+        s_rx_stats.frame_us_max = us;
+    }
+    taskEXIT_CRITICAL(&s_rx_lock);
+}
 
 // 处理图像分片数据
 static void _mymqtt_handle_image_data(const uint8_t *data, size_t data_len)
 {
-    if (s_img_buf == NULL) return;
-
     // 溢出检测
     if (s_img_buf_len + data_len > MYMQTT_IMG_BUF_SIZE) {
         ESP_LOGW(TAG, "图像数据溢出，重置");
@@ -29,18 +298,341 @@ static void _mymqtt_handle_image_data(const uint8_t *data, size_t data_len)
         return;
     }
 
-    // 拼接数据到缓冲区
-    memcpy(s_img_buf + s_img_buf_len, data, data_len);
+    // 按块边界拆分后拼接（块大小为偶数，像素不会跨块，跨片的半个像素仍落在同一块内）
+    const mymqtt_img_frame_t *frame = &s_img_frames[s_img_cur];
+    size_t done = 0;
+    while (done < data_len) {
+        size_t pos = s_img_buf_len + done;
+        size_t in_chunk = pos % MYMQTT_IMG_CHUNK_BYTES;
+        size_t n = MYMQTT_IMG_CHUNK_BYTES - in_chunk;
+        if (n > data_len - done) {
+            n = data_len - done;
+        }
+        _mymqtt_img_copy((uint8_t *)frame->chunks[pos / MYMQTT_IMG_CHUNK_BYTES].data, in_chunk, data + done, n);
+        done += n;
+    }
     s_img_buf_len += data_len;
+    s_img_frags++;
 
-    // 收满一帧，调用回调绘制
+    // 收满一帧，缓冲区所有权交给回调（零拷贝），由消费者 mymqtt_image_release() 归还
     if (s_img_buf_len == MYMQTT_IMG_BUF_SIZE) {
-        ESP_LOGI(TAG, "收到完整图像帧");
-        if (s_image_cb) {
-            s_image_cb((const uint16_t *)s_img_buf);
+        ESP_LOGD(TAG, "收到完整图像帧（%lu 个分片）", (unsigned long)s_img_frags);
+        _mymqtt_rx_stats_frame(esp_timer_get_time() - s_img_start_us);
+        int idx = s_img_cur;
+        s_img_cur = -1;
+        s_img_buf_len = 0;
+        s_img_received++;
+        _mymqtt_rec_first_frame();
+        if (s_frame_cb) {
+            s_frame_cb(&s_img_frames[idx]);
+        } else if (s_image_cb) {
+            s_image_cb((const uint16_t *)s_img_pool[idx]);
+        } else {
+            atomic_store(&s_img_pool_busy[idx], false);
         }
+    }
+}
+
+// 图像主题处理函数：首个分片取帧缓冲，逐片拼接，收满一帧交给回调
+static void _mymqtt_image_handler(const mymqtt_msg_frag_t *frag, void *arg)
+{
+    (void)arg;
+
+    if (frag->data == NULL) {
+        // 断线：丢弃拼接到一半的帧，缓冲区留给下一帧
         s_img_buf_len = 0;
-        s_receiving_image = false;
+        return;
+    }
+
+    if (frag->offset == 0) {
+        s_img_buf_len = 0;  // 新图像，重置缓冲区
+        if (frag->total_len != MYMQTT_IMG_BUF_SIZE) {
+            ESP_LOGW(TAG, "图像长度不符（%u 字节），忽略", (unsigned)frag->total_len);
+            return;
+        }
+        if (s_img_cur < 0) {
+            s_img_cur = _mymqtt_img_buf_acquire();
+        }
+        if (s_img_cur < 0) {
+            // 消费者仍持有全部缓冲区，丢弃本帧
+            s_img_dropped++;
+            taskENTER_CRITICAL(&s_rx_lock);
+            s_rx_stats.dropped++;
+            taskEXIT_CRITICAL(&s_rx_lock);
+            ESP_LOGW(TAG, "无空闲帧缓冲，丢帧（累计 %lu）", (unsigned long)s_img_dropped);
+            return;
+        }
+        s_img_start_us = esp_timer_get_time();
+        s_img_frags = 0;
+    }
+
+    // 本帧被丢弃或分片不连续时忽略，等待下一帧首个分片
+    if (s_img_cur < 0 || frag->offset != s_img_buf_len) {
+        return;
+    }
+    _mymqtt_handle_image_data(frag->data, frag->len);
+}
+
+// 读取 NVS 中的接收缓冲区大小（未配置或超出范围时使用默认值）
+static size_t _mymqtt_load_rx_buffer_size(void)
+{
+    int32_t size = 0;
+
+    if (!g_nvs_initialized ||
+        nvs_storage_get_i32(MYMQTT_NVS_NAMESPACE, MYMQTT_NVS_KEY_RX_BUF, &size) != ESP_OK) {
+        return MYMQTT_RX_BUFFER_SIZE;
+    }
+    if (size < MYMQTT_RX_BUFFER_MIN || size > MYMQTT_RX_BUFFER_MAX) {
+        ESP_LOGW(TAG, "NVS 接收缓冲区大小无效（%ld），使用默认值", (long)size);
+        return MYMQTT_RX_BUFFER_SIZE;
+    }
+    return (size_t)size;
+}
+
+#if MYMQTT_BENCH_CMD_ENABLE
+static void _mymqtt_restart_cb(void *arg)
+{
+    (void)arg;
+    esp_restart();
+}
+
+// 发布接收统计（JSON）
+static void _mymqtt_publish_rx_stats(void)
+{
+    mymqtt_rx_stats_t st;
+    char buf[448];
+
+    mymqtt_get_rx_stats(&st);
+    // 堆水位为开机以来的最小值（不随统计清零），主机工具按多轮测试取差观察
+    int n = snprintf(buf, sizeof(buf),
+                     "{\"rx_buf\":%lu,\"frames\":%lu,\"dropped\":%lu,\"fragments\":%lu,"
+                     "\"bytes\":%llu,\"frame_us_min\":%lu,\"frame_us_max\":%lu,"
+                     "\"frame_us_avg\":%lu,\"roi_updates\":%lu,\"roi_rejected\":%lu,"
+                     "\"roi_bytes\":%llu,\"elapsed_us\":%lld,"
+                     "\"int_free\":%lu,\"int_min\":%lu,\"heap_min\":%lu}",
+                     (unsigned long)st.rx_buffer_size, (unsigned long)st.frames,
+                     (unsigned long)st.dropped, (unsigned long)st.fragments,
+                     (unsigned long long)st.bytes, (unsigned long)st.frame_us_min,
+                     (unsigned long)st.frame_us_max,
+                     (unsigned long)(st.frames ? st.frame_us_sum / st.frames : 0),
+                     (unsigned long)st.roi_updates, (unsigned long)st.roi_rejected,
+                     (unsigned long long)st.roi_bytes,
+                     (long long)(esp_timer_get_time() - st.since_us),
+                     (unsigned long)heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT),
+                     (unsigned long)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT),
+                     (unsigned long)esp_get_minimum_free_heap_size());
+    if (n > 0 && n < (int)sizeof(buf)) {
+        mymqtt_publish(MYMQTT_TOPIC_RX_STATS, buf, (size_t)n, 1);
+    }
+}
+
+// 命令载荷很短，只处理单分片消息
+static bool _mymqtt_cmd_payload(const mymqtt_msg_frag_t *frag, char *buf, size_t buf_len)
+{
+    if (frag->offset != 0 || frag->len != frag->total_len || frag->len >= buf_len) {
+        return false;
+    }
+    memcpy(buf, frag->data, frag->len);
+    buf[frag->len] = '\0';
+    return true;
+}
+
+// 设置接收缓冲区：保存到 NVS 后延时重启，客户端以新的缓冲区重新初始化
+static void _mymqtt_cmd_rx_buf_handler(const mymqtt_msg_frag_t *frag, void *arg)
+{
+    (void)arg;
+    char buf[16];
+
+    if (frag->data == NULL || !_mymqtt_cmd_payload(frag, buf, sizeof(buf))) {
+        return;
+    }
+
+    long size = strtol(buf, NULL, 10);
+    if ((size_t)size == s_rx_buf_size) {
+        _mymqtt_publish_rx_stats();     // 已是该大小，直接回复，主机据此确认生效
+        return;
+    }
+
+    esp_err_t err = mymqtt_set_rx_buffer_size((size_t)size);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "设置接收缓冲区失败（%ld）: %s", size, esp_err_to_name(err));
+        return;
+    }
+
+    ESP_LOGI(TAG, "接收缓冲区改为 %ld 字节，%d ms 后重启", size, MYMQTT_RESTART_DELAY_MS);
+    const esp_timer_create_args_t args = {
+        .callback = _mymqtt_restart_cb,
+        .name = "mqtt_restart",
+    };
+    esp_timer_handle_t timer;
+    if (esp_timer_create(&args, &timer) == ESP_OK) {
+        esp_timer_start_once(timer, (uint64_t)MYMQTT_RESTART_DELAY_MS * 1000);
+    }
+}
+
+// 查询接收统计：载荷为 "reset" 时回复后清零
+static void _mymqtt_cmd_rx_stats_handler(const mymqtt_msg_frag_t *frag, void *arg)
+{
+    (void)arg;
+    char buf[16];
+
+    if (frag->data == NULL || !_mymqtt_cmd_payload(frag, buf, sizeof(buf))) {
+        return;
+    }
+
+    _mymqtt_publish_rx_stats();
+    if (strcmp(buf, "reset") == 0) {
+        mymqtt_reset_rx_stats();
+    }
+}
+
+static esp_err_t _mymqtt_bench_cmd_init(void)
+{
+    esp_err_t err = mymqtt_route_add(&(mymqtt_route_t){
+        .filter = MYMQTT_TOPIC_CMD_RX_BUF, .qos = 1, .handler = _mymqtt_cmd_rx_buf_handler,
+    });
+    if (err != ESP_OK) {
+        return err;
+    }
+    return mymqtt_route_add(&(mymqtt_route_t){
+        .filter = MYMQTT_TOPIC_CMD_RX_STATS, .qos = 1, .handler = _mymqtt_cmd_rx_stats_handler,
+    });
+}
+#endif
+
+#if MYMQTT_ROI_ENABLE
+static inline uint16_t _mymqtt_get_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// 解析区域头部并校验范围与载荷长度
+static bool _mymqtt_roi_begin(const uint8_t *hdr, size_t total_len)
+{
+    uint16_t x = _mymqtt_get_le16(hdr);
+    uint16_t y = _mymqtt_get_le16(hdr + 2);
+    uint16_t w = _mymqtt_get_le16(hdr + 4);
+    uint16_t h = _mymqtt_get_le16(hdr + 6);
+
+    if (w == 0 || h == 0 || (uint32_t)x + w > MYMQTT_IMG_WIDTH || (uint32_t)y + h > MYMQTT_IMG_HEIGHT ||
+        total_len != MYMQTT_ROI_HEADER_SIZE + (size_t)w * h * MYMQTT_IMG_PIXEL_SIZE) {
+        ESP_LOGW(TAG, "区域更新无效（%u,%u %ux%u，%u 字节）",
+                 (unsigned)x, (unsigned)y, (unsigned)w, (unsigned)h, (unsigned)total_len);
+        return false;
+    }
+
+    s_roi = (mymqtt_roi_t){ .x = x, .y = y, .w = w, .h = h, .pixels = (const uint16_t *)s_roi_buf };
+    s_roi_len = 0;
+    s_roi_rows_done = 0;
+    return true;
+}
+
+// 区域更新处理函数：拼接像素，每收齐若干行即交给回调输出
+static void _mymqtt_roi_handler(const mymqtt_msg_frag_t *frag, void *arg)
+{
+    (void)arg;
+
+    if (frag->data == NULL) {
+        s_roi_active = false;
+        return;
+    }
+
+    const uint8_t *data = frag->data;
+    size_t len = frag->len;
+
+    if (frag->offset == 0) {
+        // 首个分片至少为接收缓冲区大小（>= 2KB），头部不会被切开
+        s_roi_active = (len >= MYMQTT_ROI_HEADER_SIZE) && _mymqtt_roi_begin(data, frag->total_len);
+        if (!s_roi_active) {
+            taskENTER_CRITICAL(&s_rx_lock);
+            s_rx_stats.roi_rejected++;
+            taskEXIT_CRITICAL(&s_rx_lock);
+            return;
+        }
+        data += MYMQTT_ROI_HEADER_SIZE;
+        len -= MYMQTT_ROI_HEADER_SIZE;
+    } else if (!s_roi_active || frag->offset != MYMQTT_ROI_HEADER_SIZE + s_roi_len) {
+        s_roi_active = false;
+        return;
+    }
+
+    _mymqtt_img_copy(s_roi_buf, s_roi_len, data, len);
+    s_roi_len += len;
+
+    // 行长为偶数，收齐的行内不会残留半个像素
+    size_t row_bytes = (size_t)s_roi.w * MYMQTT_IMG_PIXEL_SIZE;
+    uint16_t rows = (uint16_t)(s_roi_len / row_bytes);
+    if (rows > s_roi_rows_done) {
+        mymqtt_roi_t part = {
+            .x = s_roi.x,
+            .y = (uint16_t)(s_roi.y + s_roi_rows_done),
+            .w = s_roi.w,
+            .h = (uint16_t)(rows - s_roi_rows_done),
+            .pixels = s_roi.pixels + (size_t)s_roi_rows_done * s_roi.w,
+        };
+        s_roi_rows_done = rows;
+        s_roi_cb(&part);
+    }
+
+    if (rows == s_roi.h) {
+        s_roi_active = false;
+        taskENTER_CRITICAL(&s_rx_lock);
+        s_rx_stats.roi_updates++;
+        s_rx_stats.roi_bytes += frag->total_len;
+        taskEXIT_CRITICAL(&s_rx_lock);
+    }
+}
+#endif
+
+// 重新订阅所有已注册主题（连接建立后调用，会话不保留时订阅随断线失效）
+static void _mymqtt_resubscribe(void)
+{
+    atomic_store(&s_subs_dirty, false);
+
+    mymqtt_route_t routes[MYMQTT_ROUTE_MAX];
+    size_t n = mymqtt_route_list(routes, MYMQTT_ROUTE_MAX);
+    for (size_t i = 0; i < n; i++) {
+        esp_mqtt_client_subscribe(s_hmqtt, routes[i].filter, routes[i].qos);
+    }
+}
+
+// 分发入站分片：第一个分片带主题名并查路由，后续分片 topic_len=0 沿用同一处理函数
+static void _mymqtt_dispatch(const esp_mqtt_event_handle_t event)
+{
+    mymqtt_msg_frag_t frag = {
+        .data = (const uint8_t *)event->data,
+        .len = (size_t)event->data_len,
+        .offset = (size_t)event->current_data_offset,
+        .total_len = (size_t)event->total_data_len,
+    };
+
+    if (event->topic_len > 0) {
+        s_rx_routed = mymqtt_route_lookup(event->topic, (size_t)event->topic_len, &s_rx_route);
+        if (!s_rx_routed) {
+            ESP_LOGD(TAG, "未注册的主题: %.*s", event->topic_len, event->topic);
+            return;
+        }
+        frag.topic = event->topic;
+        frag.topic_len = (size_t)event->topic_len;
+    }
+
+    if (s_rx_routed && frag.data != NULL) {
+        s_rx_route.handler(&frag, s_rx_route.arg);
+    }
+}
+
+// 连接断开：更新状态，开始恢复计时，通知正在接收的处理函数消息已中断
+// （在 MQTT 任务中调用；Wi-Fi 断开停止客户端后也在发送任务中调用）
+static void _mymqtt_on_disconnected(void)
+{
+    s_connected = false;
+    xEventGroupClearBits(s_mqtt_events, MYMQTT_CONNECTED_BIT);
+    _mymqtt_rec_link_down();
+
+    if (s_rx_routed) {
+        mymqtt_msg_frag_t abort_frag = {0};
+        s_rx_route.handler(&abort_frag, s_rx_route.arg);
+        s_rx_routed = false;
     }
 }
 
@@ -53,33 +645,23 @@ static void _mymqtt_event_handler(void *arg, esp_event_base_t base, int32_t even
 
     switch (event->event_id) {
     case MQTT_EVENT_CONNECTED:
-        ESP_LOGI(TAG, "已连接");
+        ESP_LOGI(TAG, "已连接（会话%s）", event->session_present ? "保留" : "新建");
         s_connected = true;
-        // 自动订阅图像主题
-        if (s_image_cb) {
-            esp_mqtt_client_subscribe(s_hmqtt, MYMQTT_TOPIC_IMAGE, 1);
+        xEventGroupSetBits(s_mqtt_events, MYMQTT_CONNECTED_BIT);
+        _mymqtt_rec_connected(event->session_present);
+        // 持久会话被代理保留时订阅仍然有效；离线期间新注册的主题仍需补订阅
+        if (!event->session_present || atomic_load(&s_subs_dirty)) {
+            _mymqtt_resubscribe();
         }
         break;
 
     case MQTT_EVENT_DISCONNECTED:
         ESP_LOGW(TAG, "已断开");
-        s_connected = false;
-        s_img_buf_len = 0;
-        s_receiving_image = false;
+        _mymqtt_on_disconnected();
         break;
 
     case MQTT_EVENT_DATA:
-        // 第一个分片带主题名，后续分片 topic_len=0
-        if (event->topic_len > 0) {
-            s_receiving_image = (strncmp(event->topic, MYMQTT_TOPIC_IMAGE, event->topic_len) == 0);
-            if (s_receiving_image) {
-                s_img_buf_len = 0;  // 新图像，重置缓冲区
-            }
-        }
-        // 正在接收图像，处理分片数据
-        if (s_receiving_image && event->data && event->data_len > 0) {
-            _mymqtt_handle_image_data((const uint8_t *)event->data, event->data_len);
-        }
+        _mymqtt_dispatch(event);
         break;
 
     case MQTT_EVENT_ERROR:
@@ -91,6 +673,319 @@ static void _mymqtt_event_handler(void *arg, esp_event_base_t base, int32_t even
     }
 }
 
+static inline size_t _mymqtt_tx_used(void)
+{
+    return MYMQTT_OUT_QUEUE_BYTES - xRingbufferGetCurFreeSize(s_tx_ring);
+}
+
+// 按水位更新拥塞状态，状态变化时通知回调（迟滞，避免在阈值附近来回切换）
+static void _mymqtt_tx_update_congestion(size_t used)
+{
+    bool congested = atomic_load(&s_tx_congested);
+    bool next = congested;
+
+    if (!congested && used * 100 >= (size_t)MYMQTT_OUT_QUEUE_BYTES * MYMQTT_OUT_HIGH_WATER_PCT) {
+        next = true;
+    } else if (congested && used * 100 <= (size_t)MYMQTT_OUT_QUEUE_BYTES * MYMQTT_OUT_LOW_WATER_PCT) {
+        next = false;
+    }
+
+    if (next == congested || !atomic_compare_exchange_strong(&s_tx_congested, &congested, next)) {
+        return;
+    }
+
+    ESP_LOGW(TAG, "发布队列%s（占用 %u 字节）", next ? "拥塞" : "恢复", (unsigned)used);
+    mymqtt_backpressure_cb_t cb = s_bp_cb;
+    if (cb) {
+        cb(next);
+    }
+}
+
+// 写入合并槽；槽已满或消息过长返回 false，改走普通队列
+static bool _mymqtt_tx_coalesce(const char *topic, const void *data, size_t len, int qos)
+{
+    if (len > MYMQTT_OUT_COALESCE_MAX_BYTES) {
+        return false;
+    }
+
+    bool stored = false;
+    taskENTER_CRITICAL(&s_tx_lock);
+    for (int i = 0; i < MYMQTT_OUT_COALESCE_SLOTS; i++) {
+        mymqtt_tx_slot_t *slot = &s_tx_slots[i];
+        if (slot->topic != NULL && slot->topic != topic && strcmp(slot->topic, topic) != 0) {
+            continue;
+        }
+
+        slot->topic = topic;
+        if (slot->pending) {
+            s_tx_stats.coalesced++;
+        }
+        memcpy(slot->data, data, len);
+        slot->len = (uint16_t)len;
+        slot->qos = (uint8_t)qos;
+        slot->pending = true;
+        s_tx_stats.queued++;
+        stored = true;
+        break;
+    }
+    taskEXIT_CRITICAL(&s_tx_lock);
+    return stored;
+}
+
+static esp_err_t _mymqtt_tx_push(const char *topic, size_t topic_len, const void *data, size_t len, int qos)
+{
+    // QoS 0 在拥塞时直接拒绝，队列余量留给需要确认的消息
+    if (qos == 0 && atomic_load(&s_tx_congested)) {
+        taskENTER_CRITICAL(&s_tx_lock);
+        s_tx_stats.dropped_congested++;
+        taskEXIT_CRITICAL(&s_tx_lock);
+        return ESP_ERR_NO_MEM;
+    }
+
+    size_t size = sizeof(mymqtt_tx_item_t) + topic_len + 1 + len;
+    void *ptr = NULL;
+    if (xRingbufferSendAcquire(s_tx_ring, &ptr, size, 0) != pdTRUE) {
+        taskENTER_CRITICAL(&s_tx_lock);
+        s_tx_stats.dropped_full++;
+        taskEXIT_CRITICAL(&s_tx_lock);
+        _mymqtt_tx_update_congestion(MYMQTT_OUT_QUEUE_BYTES);
+        return ESP_ERR_NO_MEM;
+    }
+
+    mymqtt_tx_item_t *item = ptr;
+    item->qos = (uint8_t)qos;
+    item->topic_len = (uint8_t)topic_len;
+    item->reserved = 0;
+    item->data_len = (uint32_t)len;
+    char *t = (char *)(item + 1);
+    memcpy(t, topic, topic_len + 1);
+    memcpy(t + topic_len + 1, data, len);
+    xRingbufferSendComplete(s_tx_ring, ptr);
+
+    size_t used = _mymqtt_tx_used();
+    taskENTER_CRITICAL(&s_tx_lock);
+    s_tx_stats.queued++;
+    if (used > s_tx_stats.peak_used_bytes) {
+        s_tx_stats.peak_used_bytes = (uint32_t)used;
+    }
+    taskEXIT_CRITICAL(&s_tx_lock);
+    _mymqtt_tx_update_congestion(used);
+    return ESP_OK;
+}
+
+// 交给 esp-mqtt：outbox 过大说明网络跟不上，等待其发出后再交付（只阻塞 mqtt_tx 任务）
+static void _mymqtt_tx_send(const char *topic, const void *data, size_t len, int qos)
+{
+    int outbox = esp_mqtt_client_get_outbox_size(s_hmqtt);
+    if (outbox > (int)s_tx_stats.peak_outbox_bytes) {
+        s_tx_stats.peak_outbox_bytes = (uint32_t)outbox;
+    }
+    if (s_connected && outbox > MYMQTT_OUT_OUTBOX_MAX_BYTES) {
+        s_tx_stats.outbox_stalls++;
+        do {
+            vTaskDelay(pdMS_TO_TICKS(MYMQTT_OUT_STALL_POLL_MS));
+        } while (s_connected && esp_mqtt_client_get_outbox_size(s_hmqtt) > MYMQTT_OUT_OUTBOX_MAX_BYTES);
+    }
+
+    // 断线期间 QoS 0 消息已无意义；QoS 1 留在 outbox，重连后由 esp-mqtt 重发，
+    // 但 outbox 同样受上限约束，离线太久时丢弃新的 QoS 1 消息，避免 outbox 无限增长
+    if (!s_connected) {
+        if (qos == 0) {
+            s_tx_stats.dropped_offline++;
+            return;
+        }
+        if (esp_mqtt_client_get_outbox_size(s_hmqtt) > MYMQTT_OUT_OUTBOX_MAX_BYTES) {
+            s_tx_stats.dropped_outbox++;
+            return;
+        }
+    }
+
+    // store=true：QoS 0 也进入 outbox，由 esp-mqtt 任务发送，本任务不等待网络
+    if (esp_mqtt_client_enqueue(s_hmqtt, topic, data, (int)len, qos, 0, true) < 0) {
+        s_tx_stats.enqueue_failed++;
+        return;
+    }
+    s_tx_stats.sent++;
+
+    mymqtt_sent_cb_t sent_cb = s_sent_cb;
+    if (sent_cb) {
+        sent_cb(topic, data, len, esp_timer_get_time());
+    }
+}
+
+// 发出合并槽中待发的消息，返回发出条数
+static uint32_t _mymqtt_tx_flush_slots(void)
+{
+    uint8_t data[MYMQTT_OUT_COALESCE_MAX_BYTES];
+    uint32_t n = 0;
+
+    for (int i = 0; i < MYMQTT_OUT_COALESCE_SLOTS; i++) {
+        mymqtt_tx_slot_t *slot = &s_tx_slots[i];
+        const char *topic = NULL;
+        size_t len = 0;
+        int qos = 0;
+
+        taskENTER_CRITICAL(&s_tx_lock);
+        if (slot->pending) {
+            topic = slot->topic;
+            len = slot->len;
+            qos = slot->qos;
+            memcpy(data, slot->data, len);
+            slot->pending = false;
+        }
+        taskEXIT_CRITICAL(&s_tx_lock);
+
+        if (topic != NULL) {
+            _mymqtt_tx_send(topic, data, len, qos);
+            n++;
+        }
+    }
+    return n;
+}
+
+// 启动客户端（只启动一次）
+static esp_err_t _mymqtt_start(void)
+{
+    // 事件循环任务与 mymqtt_init 可能同时调用
+    if (atomic_exchange(&s_started, true)) {
+        return ESP_OK;
+    }
+
+    esp_err_t err = esp_mqtt_client_start(s_hmqtt);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "客户端启动失败: %s", esp_err_to_name(err));
+        atomic_store(&s_started, false);
+        return err;
+    }
+    return ESP_OK;
+}
+
+// STA 网卡是否已有 IP
+static bool _mymqtt_netif_has_ip(void)
+{
+    esp_netif_t *netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+    esp_netif_ip_info_t ip_info;
+
+    if (netif == NULL || esp_netif_get_ip_info(netif, &ip_info) != ESP_OK) {
+        return false;
+    }
+    return ip_info.ip.addr != 0;
+}
+
+#if MYMQTT_STOP_ON_WIFI_LOSS
+// 在发送任务中停止客户端（TCP 连接已不可用，否则要等心跳超时才发现）；
+// 停止期间获取 IP 的事件看到客户端仍在运行而跳过，这里停止后补启动
+static void _mymqtt_stop_on_link_loss(void)
+{
+    if (!atomic_exchange(&s_stop_req, false)) {
+        return;
+    }
+
+    ESP_LOGW(TAG, "Wi-Fi 断开，停止客户端");
+    esp_mqtt_client_stop(s_hmqtt);
+    if (s_connected) {
+        _mymqtt_on_disconnected();      // MQTT 任务已退出，不会并发访问接收状态
+    }
+    atomic_store(&s_started, false);
+
+    if (_mymqtt_netif_has_ip()) {
+        ESP_LOGI(TAG, "已重新获取 IP，启动客户端");
+        _mymqtt_start();
+    }
+}
+#endif
+
+// 发送任务：每次唤醒取完队列中的所有消息一起交给 esp-mqtt，
+// 优先级低于传感器任务，发布方连续入队的小消息自然攒成一批，esp-mqtt 任务连续写出
+static void _mymqtt_tx_task(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+#if MYMQTT_STOP_ON_WIFI_LOSS
+        _mymqtt_stop_on_link_loss();
+#endif
+
+        uint32_t batch = _mymqtt_tx_flush_slots();
+        size_t size;
+        void *ptr;
+        while ((ptr = xRingbufferReceive(s_tx_ring, &size, 0)) != NULL) {
+            const mymqtt_tx_item_t *item = ptr;
+            const char *topic = (const char *)(item + 1);
+            const uint8_t *data = (const uint8_t *)topic + item->topic_len + 1;
+
+            _mymqtt_tx_send(topic, data, item->data_len, item->qos);
+            vRingbufferReturnItem(s_tx_ring, ptr);
+            batch++;
+
+            // 合并槽中的状态消息不排在长队列之后
+            batch += _mymqtt_tx_flush_slots();
+            _mymqtt_tx_update_congestion(_mymqtt_tx_used());
+        }
+
+        if (batch > 0) {
+            s_tx_stats.batches++;
+            if (batch > s_tx_stats.max_batch) {
+                s_tx_stats.max_batch = batch;
+            }
+        }
+        _mymqtt_tx_update_congestion(_mymqtt_tx_used());
+    }
+}
+
+static esp_err_t _mymqtt_tx_init(void)
+{
+    s_tx_ring = xRingbufferCreate(MYMQTT_OUT_QUEUE_BYTES, RINGBUF_TYPE_NOSPLIT);
+    if (s_tx_ring == NULL) {
+        ESP_LOGE(TAG, "发布队列创建失败");
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t err = sys_task_create(SYS_TASK_ID_MQTT_TX, _mymqtt_tx_task, NULL, &s_tx_task);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "发送任务创建失败");
+        vRingbufferDelete(s_tx_ring);
+        s_tx_ring = NULL;
+        return err;
+    }
+    return ESP_OK;
+}
+
+// 获取 IP 后立即启动客户端，避免未联网时连接失败进入重连等待（默认 10 秒）
+static void _mymqtt_ip_event_handler(void *arg, esp_event_base_t base, int32_t event_id, void *event_data)
+{
+    (void)arg;
+    (void)base;
+    (void)event_id;
+    (void)event_data;
+
+    _mymqtt_rec_got_ip();
+    if (!atomic_load(&s_started)) {
+        ESP_LOGI(TAG, "已获取 IP，启动客户端");
+        _mymqtt_start();
+    }
+}
+
+#if MYMQTT_STOP_ON_WIFI_LOSS
+// Wi-Fi 断开：请求发送任务停止客户端（esp_mqtt_client_stop 要等 MQTT 任务退出，不能阻塞默认事件循环）
+static void _mymqtt_wifi_event_handler(void *arg, esp_event_base_t base, int32_t event_id, void *event_data)
+{
+    (void)arg;
+    (void)base;
+    (void)event_id;
+    (void)event_data;
+
+    _mymqtt_rec_link_down();
+    if (!atomic_load(&s_started)) {
+        return;
+    }
+
+    atomic_store(&s_stop_req, true);
+    xTaskNotifyGive(s_tx_task);
+}
+#endif
+
 esp_err_t mymqtt_init(mymqtt_image_cb_t image_cb)
 {
     if (s_inited) {
@@ -99,18 +994,66 @@ esp_err_t mymqtt_init(mymqtt_image_cb_t image_cb)
 
     s_image_cb = image_cb;
 
-    // 如果需要接收图像，分配拼接缓冲区
-    if (image_cb) {
+    esp_err_t err = mymqtt_route_init();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "路由表初始化失败");
+        return err;
+    }
+
+    s_mqtt_events = xEventGroupCreate();
+    if (s_mqtt_events == NULL) {
+        ESP_LOGE(TAG, "创建事件组失败");
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 如果需要接收图像，分配帧缓冲池
+    if (image_cb || s_frame_cb) {
+        err = _mymqtt_img_pool_init();
+        if (err != ESP_OK) {
+            return err;
+        }
+
+        err = mymqtt_route_add(&(mymqtt_route_t){
+            .filter = MYMQTT_TOPIC_IMAGE, .qos = MYMQTT_IMAGE_QOS, .handler = _mymqtt_image_handler,
+        });
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+#if MYMQTT_ROI_ENABLE
+    // 区域更新：像素缓冲与整帧缓冲同类内存
+    if (s_roi_cb) {
 #if defined(CONFIG_GRAPHICS_USE_PSRAM)
-        s_img_buf = heap_caps_malloc(MYMQTT_IMG_BUF_SIZE, MALLOC_CAP_SPIRAM);
+        s_roi_buf = heap_caps_malloc(MYMQTT_ROI_BUF_SIZE, MALLOC_CAP_SPIRAM);
 #else
-        s_img_buf = heap_caps_malloc(MYMQTT_IMG_BUF_SIZE, MALLOC_CAP_DMA);
+        s_roi_buf = heap_caps_malloc(MYMQTT_ROI_BUF_SIZE, MALLOC_CAP_DMA);
 #endif
-        if (s_img_buf == NULL) {
-            ESP_LOGE(TAG, "图像缓冲区分配失败");
+        if (s_roi_buf == NULL) {
+            ESP_LOGE(TAG, "区域缓冲区分配失败");
             return ESP_ERR_NO_MEM;
         }
+
+        err = mymqtt_route_add(&(mymqtt_route_t){
+            .filter = MYMQTT_TOPIC_IMAGE_ROI, .qos = MYMQTT_IMAGE_QOS, .handler = _mymqtt_roi_handler,
+        });
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+#endif
+
+#if MYMQTT_BENCH_CMD_ENABLE
+    err = _mymqtt_bench_cmd_init();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "基准测试命令注册失败");
+        return err;
     }
+#endif
+
+    s_rx_buf_size = _mymqtt_load_rx_buffer_size();
+    mymqtt_reset_rx_stats();
+    ESP_LOGI(TAG, "接收缓冲区 %u 字节", (unsigned)s_rx_buf_size);
 
     // MQTT 客户端配置
     esp_mqtt_client_config_t cfg = {
@@ -118,8 +1061,15 @@ esp_err_t mymqtt_init(mymqtt_image_cb_t image_cb)
         .credentials.client_id = MYMQTT_CLIENT_ID,                 // 客户端ID
         .credentials.username = MYMQTT_USERNAME,                   // 用户名
         .credentials.authentication.password = MYMQTT_PASSWORD,    // 密码
-        .buffer.size = MYMQTT_RX_BUFFER_SIZE,                      // 接收缓冲区大小
+        .buffer.size = (int)s_rx_buf_size,                         // 接收缓冲区大小
+        .buffer.out_size = MYMQTT_TX_BUFFER_SIZE,                  // 发送缓冲区大小
         .network.disable_auto_reconnect = false,                   // 启用自动重连
+        .network.reconnect_timeout_ms = MYMQTT_RECONNECT_MS,       // 代理不可达时的重连间隔
+        .network.timeout_ms = MYMQTT_NETWORK_TIMEOUT_MS,           // 网络操作超时
+        .session.keepalive = MYMQTT_KEEPALIVE_S,                   // 心跳周期
+        .session.disable_clean_session = MYMQTT_PERSISTENT_SESSION, // 持久会话（clean_session=false）
+        .task.priority = SYS_TASK_MQTT_PRIORITY,                   // 任务优先级（核心由 CONFIG_MQTT_USE_CORE_x 决定，见文件头检查）
+        .task.stack_size = SYS_TASK_MQTT_STACK_SIZE,               // 任务栈大小
     };
 
     // 创建 MQTT 客户端
@@ -129,11 +1079,41 @@ esp_err_t mymqtt_init(mymqtt_image_cb_t image_cb)
         return ESP_FAIL;
     }
 
+    // 发布队列与发送任务
+    err = _mymqtt_tx_init();
+    if (err != ESP_OK) {
+        return err;
+    }
+
     // 注册事件回调
-    ESP_ERROR_CHECK(esp_mqtt_client_register_event(s_hmqtt, ESP_EVENT_ANY_ID, _mymqtt_event_handler, NULL));
+    err = esp_mqtt_client_register_event(s_hmqtt, ESP_EVENT_ANY_ID, _mymqtt_event_handler, NULL);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "注册事件失败: %s", esp_err_to_name(err));
+        return err;
+    }
 
-    // 启动客户端
-    ESP_ERROR_CHECK(esp_mqtt_client_start(s_hmqtt));
+    // 客户端在获取 IP 后启动：先注册 IP 事件，再检查是否已联网，避免漏掉事件
+    err = esp_event_handler_register(IP_EVENT, IP_EVENT_STA_GOT_IP, _mymqtt_ip_event_handler, NULL);
+    if (err != ESP_OK) {
+        // 默认事件循环未创建（未启动 WiFi），直接启动由 esp-mqtt 自行重连
+        ESP_LOGW(TAG, "无法注册 IP 事件，直接启动客户端");
+        err = _mymqtt_start();
+    } else {
+#if MYMQTT_STOP_ON_WIFI_LOSS
+        if (esp_event_handler_register(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED,
+                                       _mymqtt_wifi_event_handler, NULL) != ESP_OK) {
+            ESP_LOGW(TAG, "无法注册 Wi-Fi 事件，断线由心跳检测");
+        }
+#endif
+        if (_mymqtt_netif_has_ip()) {
+            err = _mymqtt_start();
+        } else {
+            ESP_LOGI(TAG, "等待获取 IP 后启动客户端");
+        }
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
 
     s_inited = true;
     ESP_LOGI(TAG, "初始化完成");
@@ -150,12 +1130,62 @@ bool mymqtt_is_connected(void)
     return s_connected;
 }
 
+esp_err_t mymqtt_wait_connected(uint32_t timeout_ms)
+{
+    if (s_mqtt_events == NULL) return ESP_ERR_INVALID_STATE;
+
+    EventBits_t bits = xEventGroupWaitBits(s_mqtt_events, MYMQTT_CONNECTED_BIT, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeout_ms));
+    return (bits & MYMQTT_CONNECTED_BIT) ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
 int mymqtt_publish(const char *topic, const void *data, size_t len, int qos)
+{
+    return mymqtt_publish_ex(topic, data, len, qos, 0);
+}
+
+int mymqtt_publish_ex(const char *topic, const void *data, size_t len, int qos, uint32_t flags)
 {
     if (!s_inited || !s_connected) return -1;
     if (topic == NULL || data == NULL) return -1;
 
-    return esp_mqtt_client_publish(s_hmqtt, topic, data, len, qos, 0);
+    size_t topic_len = strlen(topic);
+    if (topic_len == 0 || topic_len > MYMQTT_OUT_TOPIC_MAX_LEN) return -1;
+
+    if ((flags & MYMQTT_PUB_FLAG_COALESCE) && _mymqtt_tx_coalesce(topic, data, len, qos)) {
+        xTaskNotifyGive(s_tx_task);
+        return 0;
+    }
+
+    if (_mymqtt_tx_push(topic, topic_len, data, len, qos) != ESP_OK) {
+        return -1;
+    }
+    xTaskNotifyGive(s_tx_task);
+    return 0;
+}
+
+bool mymqtt_is_congested(void)
+{
+    return atomic_load(&s_tx_congested);
+}
+
+void mymqtt_set_backpressure_cb(mymqtt_backpressure_cb_t cb)
+{
+    s_bp_cb = cb;
+}
+
+void mymqtt_set_sent_cb(mymqtt_sent_cb_t cb)
+{
+    s_sent_cb = cb;
+}
+
+void mymqtt_get_tx_stats(mymqtt_tx_stats_t *stats)
+{
+    if (stats == NULL) return;
+
+    taskENTER_CRITICAL(&s_tx_lock);
+    *stats = s_tx_stats;
+    taskEXIT_CRITICAL(&s_tx_lock);
 }
 
 esp_err_t mymqtt_subscribe(const char *topic, int qos)
@@ -166,6 +1196,235 @@ esp_err_t mymqtt_subscribe(const char *topic, int qos)
     return (ret >= 0) ? ESP_OK : ESP_FAIL;
 }
 
+esp_err_t mymqtt_register_handler(const char *filter, int qos, mymqtt_msg_handler_t handler, void *arg)
+{
+    if (!s_inited) return ESP_ERR_INVALID_STATE;
+
+    mymqtt_route_t route = {
+        .filter = filter, .qos = qos, .handler = handler, .arg = arg,
+    };
+    esp_err_t err = mymqtt_route_add(&route);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // 未连接时由连接事件统一订阅
+    if (s_connected) {
+        esp_mqtt_client_subscribe(s_hmqtt, filter, qos);
+    } else {
+        atomic_store(&s_subs_dirty, true);
+    }
+    return ESP_OK;
+}
+
+esp_err_t mymqtt_unregister_handler(const char *filter)
+{
+    esp_err_t err = mymqtt_route_remove(filter);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // 离线时注销：持久会话中代理侧订阅仍在，之后到达的消息因无路由被忽略
+    if (s_inited && s_connected) {
+        esp_mqtt_client_unsubscribe(s_hmqtt, filter);
+    }
+    return ESP_OK;
+}
+
+esp_err_t mymqtt_set_rx_buffer_size(size_t size)
+{
+    if (size < MYMQTT_RX_BUFFER_MIN || size > MYMQTT_RX_BUFFER_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!g_nvs_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return nvs_storage_set_i32(MYMQTT_NVS_NAMESPACE, MYMQTT_NVS_KEY_RX_BUF, (int32_t)size);
+}
+
+size_t mymqtt_get_rx_buffer_size(void)
+{
+    return s_rx_buf_size;
+}
+
+void mymqtt_get_recovery(mymqtt_recovery_t *out)
+{
+    if (out == NULL) return;
+
+    taskENTER_CRITICAL(&s_rec_lock);
+    *out = s_rec_last;
+    taskEXIT_CRITICAL(&s_rec_lock);
+}
+
+void mymqtt_get_rx_stats(mymqtt_rx_stats_t *stats)
+{
+    if (stats == NULL) return;
+
+    taskENTER_CRITICAL(&s_rx_lock);
+    *stats = s_rx_stats;
+    taskEXIT_CRITICAL(&s_rx_lock);
+    stats->rx_buffer_size = (uint32_t)s_rx_buf_size;
+}
+
+void mymqtt_reset_rx_stats(void)
+{
+    taskENTER_CRITICAL(&s_rx_lock);
+    memset(&s_rx_stats, 0, sizeof(s_rx_stats));
+    s_rx_stats.since_us = esp_timer_get_time();
+    taskEXIT_CRITICAL(&s_rx_lock);
+}
+
+#if MYMQTT_FEEDBACK_ENABLE
+// 等待显示的帧数：被消费者持有的帧缓冲数（不含正在拼接的帧），减去屏幕上/正在输出的一帧
+static uint32_t _mymqtt_img_queue_depth(void)
+{
+    int cur = s_img_cur;
+    uint32_t n = 0;
+
+    for (int i = 0; i < MYMQTT_IMG_BUF_COUNT; i++) {
+        if (i != cur && atomic_load(&s_img_pool_busy[i])) {
+            n++;
+        }
+    }
+    return n > 0 ? n - 1 : 0;
+}
+
+// 反馈周期：统计本周期接收/显示/丢帧，按加性增、乘性减更新建议帧率并发布
+static void _mymqtt_feedback_cb(void *arg)
+{
+    (void)arg;
+
+    int64_t now = esp_timer_get_time();
+    uint32_t rx = s_img_received;
+    uint32_t drop = s_img_dropped;
+    uint32_t disp = s_fb_displayed_cb ? s_fb_displayed_cb() : rx;
+    uint32_t queue = _mymqtt_img_queue_depth();
+
+    uint32_t d_rx = rx - s_fb_last_rx;
+    uint32_t d_drop = drop - s_fb_last_drop;
+    uint32_t d_disp = disp - s_fb_last_disp;
+    float secs = (float)(now - s_fb_last_us) / 1e6f;
+    s_fb_last_rx = rx;
+    s_fb_last_drop = drop;
+    s_fb_last_disp = disp;
+    s_fb_last_us = now;
+    if (secs <= 0.0f) {
+        return;
+    }
+
+    float rx_fps = (float)d_rx / secs;
+    float disp_fps = (float)d_disp / secs;
+    bool backlog = (queue > 0 && queue >= MYMQTT_IMG_BUF_COUNT - 1);
+    int level = 0;
+
+    if (d_drop > 0 && d_drop * 2 >= d_rx + d_drop) {
+        level = 2;
+    } else if (d_drop > 0 || backlog) {
+        level = 1;
+    }
+
+    if (level > 0) {
+        // 乘性减：以实际显示能力为基准，而不是当前建议值
+        uint32_t target = (uint32_t)(disp_fps * MYMQTT_FEEDBACK_DECREASE_PCT / 100.0f);
+        if (target < s_fb_target_fps) {
+            s_fb_target_fps = target;
+        }
+        s_fb_good_periods = 0;
+    } else if (d_rx > 0 && ++s_fb_good_periods >= MYMQTT_FEEDBACK_UP_PERIODS) {
+        // 加性增：只在发布端确实在发且全部跟上时试探更高帧率
+        s_fb_target_fps++;
+        s_fb_good_periods = 0;
+    }
+    if (s_fb_target_fps < MYMQTT_FEEDBACK_FPS_MIN) s_fb_target_fps = MYMQTT_FEEDBACK_FPS_MIN;
+    if (s_fb_target_fps > MYMQTT_FEEDBACK_FPS_MAX) s_fb_target_fps = MYMQTT_FEEDBACK_FPS_MAX;
+
+    char buf[200];
+    int n = snprintf(buf, sizeof(buf),
+                     "{\"seq\":%lu,\"period_ms\":%d,\"rx_fps\":%.1f,\"disp_fps\":%.1f,"
+                     "\"dropped\":%lu,\"queue\":%lu,\"queue_cap\":%d,\"target_fps\":%lu,\"level\":%d}",
+                     (unsigned long)s_fb_seq++, MYMQTT_FEEDBACK_PERIOD_MS, (double)rx_fps, (double)disp_fps,
+                     (unsigned long)d_drop, (unsigned long)queue, MYMQTT_IMG_BUF_COUNT - 1,
+                     (unsigned long)s_fb_target_fps, level);
+    if (n > 0 && n < (int)sizeof(buf) && s_connected) {
+        mymqtt_publish(MYMQTT_TOPIC_IMG_FEEDBACK, buf, (size_t)n, 0);
+    }
+}
+
+esp_err_t mymqtt_feedback_start(mymqtt_frame_count_cb_t displayed_cb)
+{
+    if (!s_inited || s_fb_timer != NULL) return ESP_ERR_INVALID_STATE;
+
+    s_fb_displayed_cb = displayed_cb;
+    s_fb_last_rx = s_img_received;
+    s_fb_last_drop = s_img_dropped;
+    s_fb_last_disp = displayed_cb ? displayed_cb() : s_fb_last_rx;
+    s_fb_last_us = esp_timer_get_time();
+
+    const esp_timer_create_args_t args = {
+        .callback = _mymqtt_feedback_cb,
+        .name = "mqtt_feedback",
+    };
+    esp_err_t err = esp_timer_create(&args, &s_fb_timer);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return esp_timer_start_periodic(s_fb_timer, (uint64_t)MYMQTT_FEEDBACK_PERIOD_MS * 1000);
+}
+#else
+esp_err_t mymqtt_feedback_start(mymqtt_frame_count_cb_t displayed_cb)
+{
+    (void)displayed_cb;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+#endif
+
+esp_err_t mymqtt_set_roi_cb(mymqtt_roi_cb_t roi_cb)
+{
+#if MYMQTT_ROI_ENABLE
+    if (s_inited) return ESP_ERR_INVALID_STATE;
+
+    s_roi_cb = roi_cb;
+    return ESP_OK;
+#else
+    (void)roi_cb;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t mymqtt_set_frame_cb(mymqtt_frame_cb_t frame_cb)
+{
+    if (s_inited) return ESP_ERR_INVALID_STATE;
+    if (!MYMQTT_IMG_SWAP_BYTES) return ESP_ERR_NOT_SUPPORTED;
+
+    s_frame_cb = frame_cb;
+    return ESP_OK;
+}
+
+void mymqtt_image_release(const uint16_t *image_data)
+{
+    if (image_data == NULL) return;
+
+    for (int i = 0; i < MYMQTT_IMG_BUF_COUNT; i++) {
+        if (s_img_pool[i] == (const uint8_t *)image_data) {
+            atomic_store(&s_img_pool_busy[i], false);
+            return;
+        }
+    }
+
+    ESP_LOGW(TAG, "归还的图像缓冲区无效");
+}
+
+void mymqtt_frame_release(const mymqtt_img_frame_t *frame)
+{
+    if (frame == NULL) return;
+
+    if (frame < s_img_frames || frame >= s_img_frames + MYMQTT_IMG_BUF_COUNT) {
+        ESP_LOGW(TAG, "归还的图像帧无效");
+        return;
+    }
+    atomic_store(&s_img_pool_busy[frame - s_img_frames], false);
+}
+
 esp_err_t mymqtt_unsubscribe(const char *topic)
 {
     if (!s_inited || topic == NULL) return ESP_ERR_INVALID_ARG;
@@ -0,0 +1,346 @@
+#include "mymqtt_route.h"
+#include "mymqtt_config.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+#define ROUTE_HASH_MASK     (MYMQTT_ROUTE_HASH_SIZE - 1)
+#define HASH_EMPTY          (-1)
+#define HASH_DELETED        (-2)        // 删除标记，探测时跳过但不终止
+#define NODE_NONE           (-1)
+#define ROUTE_NONE          (-1)
+#define TRIE_ROOT           (0)
+
+_Static_assert((MYMQTT_ROUTE_HASH_SIZE & ROUTE_HASH_MASK) == 0, "MYMQTT_ROUTE_HASH_SIZE 必须为 2 的幂");
+_Static_assert(MYMQTT_ROUTE_HASH_SIZE >= 2 * MYMQTT_ROUTE_MAX, "哈希表负载过高");
+_Static_assert(MYMQTT_ROUTE_MAX < 127 && MYMQTT_ROUTE_TRIE_NODES < 127, "索引以 int8_t 存储");
+
+// 前缀树节点：一个过滤器层级
+typedef struct {
+    const char *level;      // 层级名（指向注册时的过滤器字符串）
+    uint8_t level_len;
+    int8_t child;           // 第一个子节点（精确层级在前，'+' 在后）
+    int8_t sibling;         // 下一个兄弟节点
+    int8_t route;           // 过滤器在本层结束的路由
+    int8_t multi_route;     // 本层之后为 '#' 的路由（匹配本层及以下任意层）
+} mymqtt_trie_node_t;
+
+static SemaphoreHandle_t s_lock = NULL;
+static mymqtt_route_t s_routes[MYMQTT_ROUTE_MAX];
+static bool s_route_used[MYMQTT_ROUTE_MAX];
+static int8_t s_hash[MYMQTT_ROUTE_HASH_SIZE];
+static mymqtt_trie_node_t s_nodes[MYMQTT_ROUTE_TRIE_NODES];
+static int s_node_count = 0;
+
+static uint32_t _mymqtt_route_hash(const char *s, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ (uint8_t)s[i]) * 16777619u;
+    }
+    return h;
+}
+
+// 校验过滤器：通配符必须独占一层，'#' 只能是最后一层
+static bool _mymqtt_route_filter_valid(const char *filter, bool *wildcard)
+{
+    size_t len = strlen(filter);
+    if (len == 0 || len > MYMQTT_OUT_TOPIC_MAX_LEN) {
+        return false;
+    }
+
+    *wildcard = false;
+    for (size_t i = 0; i < len; i++) {
+        char c = filter[i];
+        if (c != '+' && c != '#') {
+            continue;
+        }
+        bool starts = (i == 0 || filter[i - 1] == '/');
+        bool ends = (i + 1 == len || filter[i + 1] == '/');
+        if (!starts || !ends || (c == '#' && i + 1 != len)) {
+            return false;
+        }
+        *wildcard = true;
+    }
+    return true;
+}
+
+// 返回匹配的哈希槽下标，未找到返回 -1
+static int _mymqtt_route_hash_find(const char *topic, size_t len)
+{
+    uint32_t h = _mymqtt_route_hash(topic, len);
+    for (int probe = 0; probe < MYMQTT_ROUTE_HASH_SIZE; probe++) {
+        int slot = (int)((h + probe) & ROUTE_HASH_MASK);
+        int r = s_hash[slot];
+        if (r == HASH_EMPTY) {
+            return -1;
+        }
+        if (r >= 0 && strlen(s_routes[r].filter) == len && memcmp(s_routes[r].filter, topic, len) == 0) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+static esp_err_t _mymqtt_route_hash_insert(int route)
+{
+    const char *f = s_routes[route].filter;
+    uint32_t h = _mymqtt_route_hash(f, strlen(f));
+    for (int probe = 0; probe < MYMQTT_ROUTE_HASH_SIZE; probe++) {
+        int slot = (int)((h + probe) & ROUTE_HASH_MASK);
+        if (s_hash[slot] < 0) {
+            s_hash[slot] = (int8_t)route;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+static int _mymqtt_route_node_new(const char *level, size_t len)
+{
+    if (s_node_count >= MYMQTT_ROUTE_TRIE_NODES) {
+        return NODE_NONE;
+    }
+
+    int n = s_node_count++;
+    s_nodes[n] = (mymqtt_trie_node_t){
+        .level = level, .level_len = (uint8_t)len,
+        .child = NODE_NONE, .sibling = NODE_NONE,
+        .route = ROUTE_NONE, .multi_route = ROUTE_NONE,
+    };
+    return n;
+}
+
+// 查找或创建子节点（'+' 排在兄弟链表末尾，精确层级优先匹配）
+static int _mymqtt_route_node_child(int parent, const char *level, size_t len)
+{
+    int last = NODE_NONE;
+    for (int c = s_nodes[parent].child; c != NODE_NONE; c = s_nodes[c].sibling) {
+        if (s_nodes[c].level_len == len && memcmp(s_nodes[c].level, level, len) == 0) {
+            return c;
+        }
+        last = c;
+    }
+
+    int n = _mymqtt_route_node_new(level, len);
+    if (n == NODE_NONE) {
+        return NODE_NONE;
+    }
+
+    bool plus = (len == 1 && level[0] == '+');
+    if (plus || last == NODE_NONE) {
+        if (last == NODE_NONE) {
+            s_nodes[parent].child = (int8_t)n;
+        } else {
+            s_nodes[last].sibling = (int8_t)n;
+        }
+    } else {
+        s_nodes[n].sibling = s_nodes[parent].child;
+        s_nodes[parent].child = (int8_t)n;
+    }
+    return n;
+}
+
+static esp_err_t _mymqtt_route_trie_insert(int route)
+{
+    const char *f = s_routes[route].filter;
+    int node = TRIE_ROOT;
+
+    while (1) {
+        const char *sep = strchr(f, '/');
+        size_t len = sep ? (size_t)(sep - f) : strlen(f);
+
+        if (len == 1 && f[0] == '#') {
+            s_nodes[node].multi_route = (int8_t)route;
+            return ESP_OK;
+        }
+
+        node = _mymqtt_route_node_child(node, f, len);
+        if (node == NODE_NONE) {
+            return ESP_ERR_NO_MEM;
+        }
+
+        if (sep == NULL) {
+            s_nodes[node].route = (int8_t)route;
+            return ESP_OK;
+        }
+        f = sep + 1;
+    }
+}
+
+// 按仍在使用的通配符路由重建前缀树：释放只属于已删除路由的节点，层级字符串也不再指向已删除的过滤器
+static void _mymqtt_route_trie_rebuild(void)
+{
+    s_node_count = 0;
+    _mymqtt_route_node_new("", 0);
+
+    for (int i = 0; i < MYMQTT_ROUTE_MAX; i++) {
+        bool wildcard;
+        if (s_route_used[i] && _mymqtt_route_filter_valid(s_routes[i].filter, &wildcard) && wildcard) {
+            // 节点数不超过删除前，不会失败
+            _mymqtt_route_trie_insert(i);
+        }
+    }
+}
+
+// 在 node 的子节点中匹配剩余主题（topic 指向下一层开头）
+static int _mymqtt_route_trie_match(int node, const char *topic, size_t len)
+{
+    const char *sep = memchr(topic, '/', len);
+    size_t level_len = sep ? (size_t)(sep - topic) : len;
+
+    for (int c = s_nodes[node].child; c != NODE_NONE; c = s_nodes[c].sibling) {
+        const mymqtt_trie_node_t *n = &s_nodes[c];
+        bool hit = (n->level_len == level_len && memcmp(n->level, topic, level_len) == 0) ||
+                   (n->level_len == 1 && n->level[0] == '+');
+        if (!hit) {
+            continue;
+        }
+
+        int r;
+        if (sep == NULL) {
+            // 主题到此结束："a/#" 也匹配 "a"
+            r = (n->route != ROUTE_NONE) ? n->route : n->multi_route;
+        } else {
+            r = _mymqtt_route_trie_match(c, sep + 1, len - level_len - 1);
+        }
+        if (r != ROUTE_NONE) {
+            return r;
+        }
+    }
+
+    // 剩余至少一层，由本层之后的 '#' 兜底
+    return s_nodes[node].multi_route;
+}
+
+esp_err_t mymqtt_route_init(void)
+{
+    if (s_lock != NULL) {
+        return ESP_OK;
+    }
+
+    s_lock = xSemaphoreCreateMutex();
+    if (s_lock == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    memset(s_hash, HASH_EMPTY, sizeof(s_hash));
+    s_node_count = 0;
+    _mymqtt_route_node_new("", 0);
+    return ESP_OK;
+}
+
+esp_err_t mymqtt_route_add(const mymqtt_route_t *route)
+{
+    bool wildcard;
+    if (route == NULL || route->filter == NULL || route->handler == NULL ||
+        !_mymqtt_route_filter_valid(route->filter, &wildcard)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t err = ESP_ERR_NO_MEM;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+
+    for (int i = 0; i < MYMQTT_ROUTE_MAX; i++) {
+        if (s_route_used[i] && strcmp(s_routes[i].filter, route->filter) == 0) {
+            err = ESP_ERR_INVALID_STATE;
+            goto out;
+        }
+    }
+
+    for (int i = 0; i < MYMQTT_ROUTE_MAX; i++) {
+        if (s_route_used[i]) {
+            continue;
+        }
+
+        s_routes[i] = *route;
+        err = wildcard ? _mymqtt_route_trie_insert(i) : _mymqtt_route_hash_insert(i);
+        if (err == ESP_OK) {
+            s_route_used[i] = true;
+        }
+        break;
+    }
+
+out:
+    xSemaphoreGive(s_lock);
+    return err;
+}
+
+esp_err_t mymqtt_route_remove(const char *filter)
+{
+    if (filter == NULL || s_lock == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+
+    for (int i = 0; i < MYMQTT_ROUTE_MAX; i++) {
+        if (!s_route_used[i] || strcmp(s_routes[i].filter, filter) != 0) {
+            continue;
+        }
+
+        // 精确主题：哈希槽打删除标记；通配符：重建前缀树，反复注册/注销不会耗尽节点
+        bool wildcard = false;
+        _mymqtt_route_filter_valid(s_routes[i].filter, &wildcard);
+        s_route_used[i] = false;
+        if (wildcard) {
+            _mymqtt_route_trie_rebuild();
+        } else {
+            for (int k = 0; k < MYMQTT_ROUTE_HASH_SIZE; k++) {
+                if (s_hash[k] == i) {
+                    s_hash[k] = HASH_DELETED;
+                }
+            }
+        }
+        err = ESP_OK;
+        break;
+    }
+
+    xSemaphoreGive(s_lock);
+    return err;
+}
+
+bool mymqtt_route_lookup(const char *topic, size_t len, mymqtt_route_t *out)
+{
+    if (topic == NULL || len == 0 || s_lock == NULL) {
+        return false;
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+
+    int r = ROUTE_NONE;
+    int slot = _mymqtt_route_hash_find(topic, len);
+    if (slot >= 0) {
+        r = s_hash[slot];
+    } else if (topic[0] != '$') {
+        // '$' 开头的系统主题不参与通配符匹配
+        r = _mymqtt_route_trie_match(TRIE_ROOT, topic, len);
+    }
+    if (r != ROUTE_NONE) {
+        *out = s_routes[r];
+    }
+
+    xSemaphoreGive(s_lock);
+    return r != ROUTE_NONE;
+}
+
+size_t mymqtt_route_list(mymqtt_route_t *out, size_t max)
+{
+    if (out == NULL || s_lock == NULL) {
+        return 0;
+    }
+
+    size_t n = 0;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (int i = 0; i < MYMQTT_ROUTE_MAX && n < max; i++) {
+        if (s_route_used[i]) {
+            out[n++] = s_routes[i];
+        }
+    }
+    xSemaphoreGive(s_lock);
+    return n;
+}
@@ -0,0 +1,62 @@
+#ifndef __MYMQTT_ROUTE_H__
+#define __MYMQTT_ROUTE_H__
+
+/*
+ * 入站主题路由表（mymqtt 内部使用）：
+ *   - 精确主题：FNV-1a 哈希 + 线性探测，O(1) 查找
+ *   - 通配符主题：按 '/' 分层的前缀树，'+' 与 '#' 作为特殊层级节点，查找代价与主题层数成正比
+ * 注册/注销与查找由互斥锁串行化；查找只在每条消息的首个分片进行。
+ */
+
+#include "mymqtt.h"
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief 路由项
+ */
+typedef struct {
+    const char *filter;             // 主题过滤器
+    int qos;                        // 订阅 QoS
+    mymqtt_msg_handler_t handler;
+    void *arg;
+} mymqtt_route_t;
+
+/**
+ * @brief 初始化路由表
+ */
+esp_err_t mymqtt_route_init(void);
+
+/**
+ * @brief 添加路由
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 过滤器无效，ESP_ERR_INVALID_STATE 已存在，ESP_ERR_NO_MEM 表满
+ */
+esp_err_t mymqtt_route_add(const mymqtt_route_t *route);
+
+/**
+ * @brief 删除路由
+ * @return ESP_OK 成功，ESP_ERR_NOT_FOUND 不存在
+ */
+esp_err_t mymqtt_route_remove(const char *filter);
+
+/**
+ * @brief 按主题查找路由（精确匹配优先，其次通配符）
+ *
+ * @param topic 主题（不要求 0 结尾）
+ * @param len 主题长度
+ * @param out 输出路由项拷贝
+ * @return true 找到
+ */
+bool mymqtt_route_lookup(const char *topic, size_t len, mymqtt_route_t *out);
+
+/**
+ * @brief 拷贝所有路由（重连后重新订阅用）
+ *
+ * @param out 输出数组
+ * @param max 数组容量
+ * @return 路由数
+ */
+size_t mymqtt_route_list(mymqtt_route_t *out, size_t max);
+
+#endif /* __MYMQTT_ROUTE_H__ */
@@ -65,11 +65,18 @@ esp_err_t nvs_storage_get_str(const char *namespace_name, const char *key, char
         return ESP_ERR_INVALID_ARG;
     }
 
+    // 命名空间从未写入过时只读打开返回 ESP_ERR_NVS_NOT_FOUND，按“键不存在”返回而不是中止
     nvs_handle_t nvs_handle;
-    ESP_ERROR_CHECK(nvs_open(namespace_name, NVS_READONLY, &nvs_handle));
+    esp_err_t err = nvs_open(namespace_name, NVS_READONLY, &nvs_handle);
+    if (err != ESP_OK) {
+        if (err != ESP_ERR_NVS_NOT_FOUND) {
+            ESP_LOGE(TAG, "打开命名空间 '%s' 失败: %s", namespace_name, esp_err_to_name(err));
+        }
+        return err;
+    }
 
     size_t required_size = value_len;
-    esp_err_t err = nvs_get_str(nvs_handle, key, value, &required_size);
+    err = nvs_get_str(nvs_handle, key, value, &required_size);
     if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
         ESP_LOGE(TAG, "读取键 '%s' 失败: %s", key, esp_err_to_name(err));
     }
@@ -111,10 +118,17 @@ esp_err_t nvs_storage_get_i32(const char *namespace_name, const char *key, int32
         return ESP_ERR_INVALID_ARG;
     }
 
+    // 命名空间从未写入过时只读打开返回 ESP_ERR_NVS_NOT_FOUND，按“键不存在”返回而不是中止
     nvs_handle_t nvs_handle;
-    ESP_ERROR_CHECK(nvs_open(namespace_name, NVS_READONLY, &nvs_handle));
+    esp_err_t err = nvs_open(namespace_name, NVS_READONLY, &nvs_handle);
+    if (err != ESP_OK) {
+        if (err != ESP_ERR_NVS_NOT_FOUND) {
+            ESP_LOGE(TAG, "打开命名空间 '%s' 失败: %s", namespace_name, esp_err_to_name(err));
+        }
+        return err;
+    }
 
-    esp_err_t err = nvs_get_i32(nvs_handle, key, value);
+    err = nvs_get_i32(nvs_handle, key, value);
     if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
         ESP_LOGE(TAG, "读取键 '%s' 失败: %s", key, esp_err_to_name(err));
     }
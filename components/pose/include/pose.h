@@ -0,0 +1,51 @@
+#ifndef __POSE_H__
+#define __POSE_H__
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief 头部姿态
+ */
+typedef struct {
+    int64_t timestamp_us;   // 对应采样时间
+    float yaw;              // 偏航角（度，POSE_ANGLE_CENTER 为零位）
+    float pitch;            // 俯仰角（度，POSE_ANGLE_CENTER 为零位）
+} pose_t;
+
+/**
+ * @brief 发布统计；时延为采样到交给 esp-mqtt（esp_mqtt_client_enqueue）的时间（微秒，统计窗口内）
+ */
+typedef struct {
+    uint32_t published;         // 累计发布数
+    uint32_t skipped;           // 无新采样而跳过的周期数
+    uint32_t publish_failed;    // 发布失败数
+    uint32_t latency_min_us;
+    uint32_t latency_max_us;
+    uint32_t latency_avg_us;
+} pose_stats_t;
+
+/**
+ * @brief 启动姿态发布：在 MPU6050 生产者中逐采样融合姿态，定速发布最新值
+ *
+ * 需先调用 mpu6050_task_init()。
+ *
+ * @return ESP_OK 成功
+ */
+esp_err_t pose_start(void);
+
+/**
+ * @brief 读取最新姿态（可在任意任务中调用）
+ * @param pose 输出
+ * @return true 已有有效姿态
+ */
+bool pose_get_latest(pose_t *pose);
+
+/**
+ * @brief 获取发布统计（上一个完整统计窗口）
+ * @param stats 输出
+ */
+void pose_get_stats(pose_stats_t *stats);
+
+#endif /* __POSE_H__ */
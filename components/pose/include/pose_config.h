@@ -0,0 +1,34 @@
+#ifndef __POSE_CONFIG_H__
+#define __POSE_CONFIG_H__
+
+#include "mymqtt_config.h"
+#include "imu_fusion.h"
+
+/* ================= Publish Config ================= */
+#define POSE_TOPIC                  MYMQTT_TOPIC_POSE
+#define POSE_QOS                    0               // QoS 0：过期姿态没有重传价值
+#define POSE_PUBLISH_PERIOD_MS      (20)            // 定速发布周期（50Hz）
+#define POSE_STATS_WINDOW           (250)           // 每发布多少条输出一次时延统计
+
+/* ================= Fusion Config ================= */
+#define POSE_FUSION_ALGO            IMU_FUSION_MADGWICK     // 融合算法（见 imu_fusion.h）
+#define POSE_FUSION_GAIN            IMU_FUSION_DEFAULT_BETA // 融合增益（Madgwick beta / 互补 kp）
+
+/* ================= Angle Config ================= */
+#define POSE_ANGLE_CENTER           90.0f           // 姿态零位对应的输出角度（云台中位）
+#define POSE_ANGLE_MIN              0.0f            // 输出角度下限
+#define POSE_ANGLE_MAX              180.0f          // 输出角度上限
+
+/* ================= Packet Format =================
+ * 小端序，固定 20 字节：
+ *   [0]      u8   版本号 POSE_FORMAT_VERSION
+ *   [1]      u8   保留
+ *   [2..3]   u16  消息序号
+ *   [4..11]  u64  采样时间戳（us，设备时钟）
+ *   [12..15] f32  偏航角 yaw（度）
+ *   [16..19] f32  俯仰角 pitch（度）
+ */
+#define POSE_FORMAT_VERSION         1
+#define POSE_PACKET_BYTES           (20)
+
+#endif /* __POSE_CONFIG_H__ */
@@ -0,0 +1,210 @@
+#include "pose.h"
+#include "pose_config.h"
+#include "mpu6050_task.h"
+#include "imu_fusion.h"
+#include "mymqtt.h"
+#include "sys_task.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+#include <stdatomic.h>
+
+static const char *TAG = "pose";
+
+/* 最新姿态邮箱（seqlock）：生产者单写，发布任务等多读，只保留最新值 */
+static pose_t s_latest;
+static atomic_uint s_latest_seq = 0;        // 奇数表示正在写
+
+#define DEG_TO_RAD      0.01745329252f
+
+/* 融合状态（只在生产者任务中访问） */
+static imu_fusion_t s_fusion;
+static bool s_aligned = false;
+static uint8_t s_rate_gen = 0;              // 上一采样的采样率代号（变化说明输出采样率改变，需更新步长）
+static bool s_rate_known = false;           // 首个采样到达前步长按启动时读取的采样率
+
+static uint8_t s_packet[POSE_PACKET_BYTES];  // 预分配发布缓冲
+static uint16_t s_msg_seq = 0;
+static pose_stats_t s_stats;
+static bool s_started = false;
+
+/* 时延统计窗口（只在 mqtt_tx 任务中访问） */
+static uint32_t s_win_count = 0;
+static uint32_t s_win_min = UINT32_MAX;
+static uint32_t s_win_max = 0;
+static uint64_t s_win_sum = 0;
+
+static void _pose_mailbox_write(const pose_t *pose)
+{
+    unsigned seq = atomic_load_explicit(&s_latest_seq, memory_order_relaxed);
+    atomic_store_explicit(&s_latest_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    s_latest = *pose;
+    atomic_store_explicit(&s_latest_seq, seq + 2, memory_order_release);
+}
+
+bool pose_get_latest(pose_t *pose)
+{
+    if (pose == NULL) return false;
+
+    unsigned begin, end;
+    do {
+        begin = atomic_load_explicit(&s_latest_seq, memory_order_acquire);
+        *pose = s_latest;
+        atomic_thread_fence(memory_order_acquire);
+        end = atomic_load_explicit(&s_latest_seq, memory_order_relaxed);
+    } while ((begin & 1) || begin != end);
+
+    return begin != 0;
+}
+
+static inline float _pose_clamp(float angle)
+{
+    if (angle < POSE_ANGLE_MIN) return POSE_ANGLE_MIN;
+    if (angle > POSE_ANGLE_MAX) return POSE_ANGLE_MAX;
+    return angle;
+}
+
+// 生产者任务中调用：固定步长融合，覆盖邮箱中的旧姿态
+static void _pose_on_sample(const mpu6050_sample_t *sample)
+{
+    mpu6050_data_t data;
+    pose_t pose;
+    float yaw, pitch;
+
+    if (!s_rate_known || sample->rate_gen != s_rate_gen) {
+        s_rate_gen = sample->rate_gen;
+        s_rate_known = true;
+        imu_fusion_set_rate(&s_fusion, (float)mpu6050_task_get_rate_hz());
+    }
+
+    mpu6050_convert_data_scaled(&sample->raw, sample->scale_id, &data);
+
+    // 第一个采样用重力方向直接对齐俯仰/横滚
+    if (!s_aligned) {
+        imu_fusion_align(&s_fusion, data.accel_x, data.accel_y, data.accel_z);
+        s_aligned = true;
+    }
+
+    imu_fusion_update(&s_fusion,
+                      data.gyro_x * DEG_TO_RAD, data.gyro_y * DEG_TO_RAD, data.gyro_z * DEG_TO_RAD,
+                      data.accel_x, data.accel_y, data.accel_z);
+    imu_fusion_quat_to_euler(&s_fusion.q, &yaw, &pitch, NULL);
+
+    pose.timestamp_us = sample->timestamp_us;
+    pose.yaw = _pose_clamp(POSE_ANGLE_CENTER + yaw);
+    pose.pitch = _pose_clamp(POSE_ANGLE_CENTER + pitch);
+    _pose_mailbox_write(&pose);
+}
+
+static void _pose_encode(const pose_t *pose)
+{
+    uint64_t ts = (uint64_t)pose->timestamp_us;
+
+    s_packet[0] = POSE_FORMAT_VERSION;
+    s_packet[1] = 0;
+    s_packet[2] = (uint8_t)s_msg_seq;
+    s_packet[3] = (uint8_t)(s_msg_seq >> 8);
+    for (int i = 0; i < 8; i++) {
+        s_packet[4 + i] = (uint8_t)(ts >> (8 * i));
+    }
+    memcpy(&s_packet[12], &pose->yaw, sizeof(float));     // ESP32 为小端
+    memcpy(&s_packet[16], &pose->pitch, sizeof(float));
+}
+
+// mqtt_tx 任务中调用：姿态交给 esp-mqtt 时计算采样->发送时延（时间戳取自数据包本身）
+static void _pose_on_sent(const char *topic, const void *data, size_t len, int64_t enqueue_us)
+{
+    if (len != POSE_PACKET_BYTES || strcmp(topic, POSE_TOPIC) != 0) {
+        return;
+    }
+
+    const uint8_t *p = data;
+    uint16_t seq = (uint16_t)(p[2] | (p[3] << 8));
+    uint64_t ts = 0;
+    for (int i = 0; i < 8; i++) {
+        ts |= (uint64_t)p[4 + i] << (8 * i);
+    }
+
+    int64_t latency = enqueue_us - (int64_t)ts;
+    s_win_sum += (uint64_t)latency;
+    if ((uint32_t)latency < s_win_min) s_win_min = (uint32_t)latency;
+    if ((uint32_t)latency > s_win_max) s_win_max = (uint32_t)latency;
+    ESP_LOGV(TAG, "seq %u 时延 %lld us", seq, (long long)latency);
+
+    if (++s_win_count >= POSE_STATS_WINDOW) {
+        s_stats.latency_min_us = s_win_min;
+        s_stats.latency_max_us = s_win_max;
+        s_stats.latency_avg_us = (uint32_t)(s_win_sum / s_win_count);
+        ESP_LOGI(TAG, "采样->交给 esp-mqtt 时延 min %lu / avg %lu / max %lu us，跳过 %lu，失败 %lu",
+                 (unsigned long)s_win_min, (unsigned long)s_stats.latency_avg_us, (unsigned long)s_win_max,
+                 (unsigned long)s_stats.skipped, (unsigned long)s_stats.publish_failed);
+        s_win_count = 0;
+        s_win_sum = 0;
+        s_win_min = UINT32_MAX;
+        s_win_max = 0;
+    }
+}
+
+static void _pose_publish_task(void *arg)
+{
+    (void)arg;
+
+    pose_t pose;
+    int64_t last_sent_us = 0;
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(POSE_PUBLISH_PERIOD_MS));
+
+        // 只取最新姿态；两个周期之间的中间采样直接被覆盖
+        if (!pose_get_latest(&pose) || pose.timestamp_us == last_sent_us) {
+            s_stats.skipped++;
+            continue;
+        }
+
+        _pose_encode(&pose);
+        // 网络积压时队列中只保留最新姿态，旧姿态不再发送
+        if (mymqtt_publish_ex(POSE_TOPIC, s_packet, sizeof(s_packet), POSE_QOS, MYMQTT_PUB_FLAG_COALESCE) < 0) {
+            s_stats.publish_failed++;
+            continue;
+        }
+
+        last_sent_us = pose.timestamp_us;
+        s_msg_seq++;
+        s_stats.published++;
+    }
+}
+
+void pose_get_stats(pose_stats_t *stats)
+{
+    if (stats != NULL) {
+        *stats = s_stats;
+    }
+}
+
+esp_err_t pose_start(void)
+{
+    if (s_started) {
+        return ESP_OK;
+    }
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    imu_fusion_init(&s_fusion, POSE_FUSION_ALGO, (float)mpu6050_task_get_rate_hz());
+    imu_fusion_set_gain(&s_fusion, POSE_FUSION_GAIN);
+    s_aligned = false;
+    s_rate_known = false;
+    mpu6050_task_set_realtime_cb(_pose_on_sample);
+    mymqtt_set_sent_cb(_pose_on_sent);
+
+    esp_err_t ret = sys_task_create(SYS_TASK_ID_POSE, _pose_publish_task, NULL, NULL);
+    if (ret != ESP_OK) {
+        mpu6050_task_set_realtime_cb(NULL);
+        mymqtt_set_sent_cb(NULL);
+        return ret;
+    }
+
+    s_started = true;
+    return ESP_OK;
+}
@@ -0,0 +1,136 @@
+#ifndef __SPSC_RING_H__
+#define __SPSC_RING_H__
+
+/*
+ * 单生产者/单消费者无锁环形缓冲（定长元素）。
+ *
+ * - 生产者与消费者各自只写自己的索引，无需关中断或互斥锁，可跨核使用
+ * - 支持零拷贝：直接在缓冲区内写入/读取连续元素段，批量提交
+ * - 缓冲区满时丢弃新元素并计入溢出计数（生产者永不阻塞）
+ * - 不负责唤醒：阻塞等待由调用方用任务通知等机制实现
+ */
+
+#include "esp_err.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief 环形缓冲统计
+ */
+typedef struct {
+    uint32_t pushed;        // 累计写入元素数
+    uint32_t overruns;      // 缓冲区满而丢弃的元素数
+    uint32_t high_water;    // 最大占用元素数
+} spsc_ring_stats_t;
+
+/**
+ * @brief 环形缓冲（字段仅供内部使用）
+ */
+typedef struct {
+    uint8_t *buf;
+    size_t elem_size;
+    uint32_t capacity;          // 元素个数（2 的幂）
+    uint32_t mask;
+    bool owns_buf;
+
+    /* 生产者写 */
+    atomic_uint head;           // 下一个写入位置（自由增长）
+    atomic_uint overruns;
+    uint32_t pushed;
+    uint32_t high_water;
+
+    /* 消费者写 */
+    atomic_uint tail;           // 下一个读取位置（自由增长）
+} spsc_ring_t;
+
+/**
+ * @brief 用调用方提供的存储初始化
+ * @param ring 环形缓冲
+ * @param storage 存储区（elem_size * capacity 字节）
+ * @param elem_size 元素大小（字节）
+ * @param capacity 元素个数（必须为 2 的幂）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效
+ */
+esp_err_t spsc_ring_init(spsc_ring_t *ring, void *storage, size_t elem_size, uint32_t capacity);
+
+/**
+ * @brief 动态分配并初始化
+ * @param ring 输出环形缓冲指针
+ * @param elem_size 元素大小（字节）
+ * @param capacity 元素个数（必须为 2 的幂）
+ * @param caps 存储区内存属性（MALLOC_CAP_*）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效，ESP_ERR_NO_MEM 分配失败
+ */
+esp_err_t spsc_ring_create(spsc_ring_t **ring, size_t elem_size, uint32_t capacity, uint32_t caps);
+
+/**
+ * @brief 释放 spsc_ring_create 创建的环形缓冲
+ * @param ring 环形缓冲
+ */
+void spsc_ring_delete(spsc_ring_t *ring);
+
+/* ================= 生产者接口 ================= */
+
+/**
+ * @brief 写入一个元素（拷贝）
+ * @return true 成功，false 缓冲区满（计入溢出）
+ */
+bool spsc_ring_push(spsc_ring_t *ring, const void *elem);
+
+/**
+ * @brief 获取可直接写入的连续空闲段（零拷贝写）
+ * @param ring 环形缓冲
+ * @param ptr 输出段起始地址
+ * @return 连续可写元素数（到缓冲区末尾为止，可能小于总空闲数）
+ */
+size_t spsc_ring_write_acquire(spsc_ring_t *ring, void **ptr);
+
+/**
+ * @brief 提交已写入的元素（n 不得超过 write_acquire 的返回值）
+ */
+void spsc_ring_write_commit(spsc_ring_t *ring, size_t n);
+
+/**
+ * @brief 记录生产者主动丢弃的元素（例如 write_acquire 空间不足时）
+ */
+void spsc_ring_add_overruns(spsc_ring_t *ring, uint32_t n);
+
+/* ================= 消费者接口 ================= */
+
+/**
+ * @brief 获取可直接读取的连续元素段（零拷贝读）
+ * @param ring 环形缓冲
+ * @param ptr 输出段起始地址
+ * @return 连续可读元素数（到缓冲区末尾为止；回绕时需再调用一次）
+ */
+size_t spsc_ring_read_acquire(spsc_ring_t *ring, const void **ptr);
+
+/**
+ * @brief 释放已处理的元素（n 不得超过 read_acquire 的返回值）
+ */
+void spsc_ring_read_release(spsc_ring_t *ring, size_t n);
+
+/**
+ * @brief 批量读取（拷贝）
+ * @param ring 环形缓冲
+ * @param out 输出数组
+ * @param max 最多读取元素数
+ * @return 实际读取元素数
+ */
+size_t spsc_ring_pop_n(spsc_ring_t *ring, void *out, size_t max);
+
+/* ================= 通用接口 ================= */
+
+/**
+ * @brief 当前占用元素数（任意一端调用均可，结果为瞬时值）
+ */
+uint32_t spsc_ring_count(const spsc_ring_t *ring);
+
+/**
+ * @brief 获取统计（由生产者维护，其他任务读取为近似值）
+ */
+void spsc_ring_get_stats(const spsc_ring_t *ring, spsc_ring_stats_t *stats);
+
+#endif /* __SPSC_RING_H__ */
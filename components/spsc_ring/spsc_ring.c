@@ -0,0 +1,160 @@
+#include "spsc_ring.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+
+esp_err_t spsc_ring_init(spsc_ring_t *ring, void *storage, size_t elem_size, uint32_t capacity)
+{
+    if (ring == NULL || storage == NULL || elem_size == 0 ||
+        capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(ring, 0, sizeof(*ring));
+    ring->buf = storage;
+    ring->elem_size = elem_size;
+    ring->capacity = capacity;
+    ring->mask = capacity - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->overruns, 0);
+    return ESP_OK;
+}
+
+esp_err_t spsc_ring_create(spsc_ring_t **ring, size_t elem_size, uint32_t capacity, uint32_t caps)
+{
+    if (ring == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    spsc_ring_t *r = heap_caps_malloc(sizeof(spsc_ring_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    void *storage = heap_caps_malloc(elem_size * capacity, caps);
+    if (r == NULL || storage == NULL) {
+        heap_caps_free(r);
+        heap_caps_free(storage);
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t err = spsc_ring_init(r, storage, elem_size, capacity);
+    if (err != ESP_OK) {
+        heap_caps_free(r);
+        heap_caps_free(storage);
+        return err;
+    }
+
+    r->owns_buf = true;
+    *ring = r;
+    return ESP_OK;
+}
+
+void spsc_ring_delete(spsc_ring_t *ring)
+{
+    if (ring == NULL) return;
+
+    if (ring->owns_buf) {
+        heap_caps_free(ring->buf);
+    }
+    heap_caps_free(ring);
+}
+
+static inline void *_slot(const spsc_ring_t *ring, uint32_t index)
+{
+    return ring->buf + (size_t)(index & ring->mask) * ring->elem_size;
+}
+
+bool spsc_ring_push(spsc_ring_t *ring, const void *elem)
+{
+    void *slot;
+    if (spsc_ring_write_acquire(ring, &slot) == 0) {
+        atomic_fetch_add_explicit(&ring->overruns, 1, memory_order_relaxed);
+        return false;
+    }
+
+    memcpy(slot, elem, ring->elem_size);
+    spsc_ring_write_commit(ring, 1);
+    return true;
+}
+
+size_t spsc_ring_write_acquire(spsc_ring_t *ring, void **ptr)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint32_t free_cnt = ring->capacity - (head - tail);
+    uint32_t to_end = ring->capacity - (head & ring->mask);
+
+    *ptr = _slot(ring, head);
+    return (free_cnt < to_end) ? free_cnt : to_end;
+}
+
+void spsc_ring_write_commit(spsc_ring_t *ring, size_t n)
+{
+    if (n == 0) return;
+
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed) + (uint32_t)n;
+    atomic_store_explicit(&ring->head, head, memory_order_release);
+
+    ring->pushed += (uint32_t)n;
+    uint32_t used = head - atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    if (used > ring->high_water) {
+        ring->high_water = used;
+    }
+}
+
+void spsc_ring_add_overruns(spsc_ring_t *ring, uint32_t n)
+{
+    atomic_fetch_add_explicit(&ring->overruns, n, memory_order_relaxed);
+}
+
+size_t spsc_ring_read_acquire(spsc_ring_t *ring, const void **ptr)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t used = head - tail;
+    uint32_t to_end = ring->capacity - (tail & ring->mask);
+
+    *ptr = _slot(ring, tail);
+    return (used < to_end) ? used : to_end;
+}
+
+void spsc_ring_read_release(spsc_ring_t *ring, size_t n)
+{
+    if (n == 0) return;
+
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed) + (uint32_t)n;
+    atomic_store_explicit(&ring->tail, tail, memory_order_release);
+}
+
+size_t spsc_ring_pop_n(spsc_ring_t *ring, void *out, size_t max)
+{
+    size_t total = 0;
+    uint8_t *dst = out;
+
+    // 最多两段（回绕前后）
+    for (int seg = 0; seg < 2 && total < max; seg++) {
+        const void *src;
+        size_t n = spsc_ring_read_acquire(ring, &src);
+        if (n == 0) break;
+        if (n > max - total) n = max - total;
+
+        memcpy(dst + total * ring->elem_size, src, n * ring->elem_size);
+        spsc_ring_read_release(ring, n);
+        total += n;
+    }
+
+    return total;
+}
+
+uint32_t spsc_ring_count(const spsc_ring_t *ring)
+{
+    uint32_t tail = atomic_load_explicit(&((spsc_ring_t *)ring)->tail, memory_order_acquire);
+    uint32_t head = atomic_load_explicit(&((spsc_ring_t *)ring)->head, memory_order_acquire);
+    return head - tail;
+}
+
+void spsc_ring_get_stats(const spsc_ring_t *ring, spsc_ring_stats_t *stats)
+{
+    if (ring == NULL || stats == NULL) return;
+
+    stats->pushed = ring->pushed;
+    stats->overruns = atomic_load_explicit(&((spsc_ring_t *)ring)->overruns, memory_order_relaxed);
+    stats->high_water = ring->high_water;
+}
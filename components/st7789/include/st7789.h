@@ -22,6 +22,20 @@ typedef struct {
 } st7789_pingpong_t;
 #endif
 
+/**
+ * @brief 分块输出描述（一块对应一个 SPI DMA 事务）
+ */
+typedef struct {
+    const void *data;           // DMA 可访问内存，面板字节序（大端 RGB565）
+    size_t len;                 // 字节数（偶数，不超过 ST7789_MAX_TRANS_BYTES）
+} st7789_chunk_t;
+
+/**
+ * @brief 分块输出完成回调（最后一块传输完成后，在下一次访问屏幕的任务中调用）
+ * @param arg 提交时传入的用户参数
+ */
+typedef void (*st7789_chunks_done_cb_t)(void *arg);
+
 esp_err_t st7789_init(void);
 bool st7789_is_inited(void);
 void st7789_sleep(void);
@@ -54,4 +68,31 @@ void st7789_draw_image(const uint16_t *image_data);
  */
 void st7789_draw_area(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const uint16_t *color_map);
 
+/**
+ * @brief 按描述表把内存块直接 DMA 到指定区域（零拷贝，异步）
+ *
+ * 各块按顺序拼成区域内的像素流，块数据不做字节序转换。函数在全部事务排队后返回，
+ * 传输期间块内存必须保持有效；传输完成后，由下一次屏幕操作（或 st7789_wait_idle）
+ * 在其调用任务中执行 done_cb，调用方可在回调中归还块内存。
+ *
+ * @param x1 起始列
+ * @param y1 起始行
+ * @param x2 结束列
+ * @param y2 结束行
+ * @param chunks 块描述表（函数返回后即可释放描述表本身）
+ * @param count 块数（不超过 ST7789_CHUNK_MAX_COUNT）
+ * @param done_cb 完成回调（可为 NULL）
+ * @param arg 回调参数
+ * @return ESP_OK 已提交，ESP_ERR_INVALID_ARG 参数无效，ESP_ERR_INVALID_SIZE 块总长与区域不符，
+ *         ESP_ERR_INVALID_STATE 未初始化
+ */
+esp_err_t st7789_draw_chunks(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+                             const st7789_chunk_t *chunks, size_t count,
+                             st7789_chunks_done_cb_t done_cb, void *arg);
+
+/**
+ * @brief 等待所有已提交的传输完成（并执行待处理的分块完成回调）
+ */
+void st7789_wait_idle(void);
+
 #endif //__ST7789_DRIVER_H__
\ No newline at end of file
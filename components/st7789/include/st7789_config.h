@@ -11,7 +11,7 @@
 /* ================= SPI Config ================= */
 #define ST7789_SPI_MODE              3                   // SPI 模式 3 (CPOL=1, CPHA=1)
 #define ST7789_SPI_CLOCK_HZ          (20 * 1000 * 1000)  // SPI 时钟频率 20MHz
-#define ST7789_SPI_QUEUE_SIZE        7                   // SPI 事务队列大小
+#define ST7789_SPI_QUEUE_SIZE        7                   // SPI 事务队列大小（同时也是在途事务上限，超出时先取回结果）
 
 /* ================= Display Config ================= */
 #define ST7789_WIDTH                 240                 // 屏幕宽度
@@ -22,6 +22,10 @@
 #define ST7789_FRAME_BYTES           (ST7789_WIDTH * ST7789_HEIGHT * ST7789_PIXEL_BPP)  // 一帧大小 (字节)
 #define ST7789_MAX_TRANS_BYTES       (ST7789_FRAME_BYTES / 10)                          // 单次传输大小 (字节)
 
+/* ================= Chunk Output ================= */
+/* 分块直通输出（st7789_draw_chunks）：调用方提供已是面板字节序的 DMA 内存块，每块一个 SPI 事务，不经过中转缓冲 */
+#define ST7789_CHUNK_MAX_COUNT       (ST7789_FRAME_BYTES / ST7789_MAX_TRANS_BYTES)      // 单次最多块数（一帧）
+
 /* ================= DMA Config ================= */
 #define ST7789_PINGPONG_BUFFER_ENABLE  1               // Ping-Pong 双缓冲开关 (0=关闭, 1=开启)
 
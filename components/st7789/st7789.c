@@ -3,6 +3,7 @@
 #include "driver/gpio.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "esp_log.h"
 #include "esp_heap_caps.h"
 #include <string.h>
@@ -11,6 +12,59 @@ static const char *TAG = "st7789";
 
 static spi_device_handle_t s_hspi = NULL;
 static bool s_inited = false;
+static SemaphoreHandle_t s_lock = NULL;     // 串行化屏幕访问（LVGL 刷新与分块直通输出可能来自不同任务）
+
+/* 队列事务：排队后必须取回结果，在途数不能超过 SPI 队列深度 */
+#define ST7789_TRANS_USER_CHUNK       ((void *)(uintptr_t)0x80)   // 分块事务
+#define ST7789_TRANS_USER_CHUNK_LAST  ((void *)(uintptr_t)0x81)   // 一组分块的最后一个事务
+
+static int s_inflight = 0;                  // 已排队未取回结果的事务数
+static spi_transaction_t s_chunk_trans[ST7789_CHUNK_MAX_COUNT];
+static st7789_chunks_done_cb_t s_chunks_done_cb = NULL;
+static void *s_chunks_done_arg = NULL;
+
+// 取回一个事务结果；一组分块全部完成时执行完成回调
+static void _st7789_reap_one(void)
+{
+    spi_transaction_t *rtrans;
+
+    ESP_ERROR_CHECK(spi_device_get_trans_result(s_hspi, &rtrans, portMAX_DELAY));
+    s_inflight--;
+
+    if (rtrans->user == ST7789_TRANS_USER_CHUNK_LAST && s_chunks_done_cb != NULL) {
+        st7789_chunks_done_cb_t cb = s_chunks_done_cb;
+        s_chunks_done_cb = NULL;
+        cb(s_chunks_done_arg);
+    }
+}
+
+// 排队一个数据事务（在途已满时先取回最早的结果）
+static void _st7789_queue_trans(spi_transaction_t *trans)
+{
+    if (s_inflight >= ST7789_SPI_QUEUE_SIZE) {
+        _st7789_reap_one();
+    }
+    ESP_ERROR_CHECK(spi_device_queue_trans(s_hspi, trans, portMAX_DELAY));
+    s_inflight++;
+}
+
+// 等待所有队列事务完成（发送命令前必须调用，轮询事务不能与队列事务交错）
+static void _st7789_wait_all_idle(void)
+{
+    while (s_inflight > 0) {
+        _st7789_reap_one();
+    }
+}
+
+static inline void _st7789_lock(void)
+{
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+}
+
+static inline void _st7789_unlock(void)
+{
+    xSemaphoreGive(s_lock);
+}
 
 #if ST7789_PINGPONG_BUFFER_ENABLE
 #include "esp_attr.h"
@@ -40,14 +94,14 @@ static void _st7789_pingpong_init(void)
 // DMA 传输完成回调（ISR 上下文）
 static void IRAM_ATTR _st7789_pingpong_dma_done_cb(spi_transaction_t *trans)
 {
-    uint8_t idx = (uint8_t)(uintptr_t)trans->user;
-    s_pingpong.status[idx] = PINGPONG_BUF_IDLE;
+    uintptr_t idx = (uintptr_t)trans->user;
+    if (idx < ST7789_PINGPONG_BUF_COUNT) {
+        s_pingpong.status[idx] = PINGPONG_BUF_IDLE;
+    }
 }
 
 static int _st7789_pingpong_get_idle_buf(void)
 {
-    spi_transaction_t *rtrans;
-    
     while (1) {
         // 遍历查找空闲缓冲区
         for (int i = 0; i < ST7789_PINGPONG_BUF_COUNT; i++) {
@@ -56,7 +110,7 @@ static int _st7789_pingpong_get_idle_buf(void)
             }
         }
         // 没有空闲的，等待 DMA 完成
-        spi_device_get_trans_result(s_hspi, &rtrans, portMAX_DELAY);
+        _st7789_reap_one();
     }
 }
 
@@ -70,18 +124,7 @@ static void _st7789_pingpong_send_async(uint8_t idx, size_t pixels)
     s_trans[idx].user = (void *)(uintptr_t)idx;
     
     s_pingpong.status[idx] = PINGPONG_BUF_SENDING;
-    ESP_ERROR_CHECK(spi_device_queue_trans(s_hspi, &s_trans[idx], portMAX_DELAY));
-}
-
-// 等待所有 Ping-Pong 缓冲区空闲(阻塞)
-static void _st7789_pingpong_wait_all_idle(void)
-{
-    spi_transaction_t *rtrans;
-    for (int i = 0; i < ST7789_PINGPONG_BUF_COUNT; i++) {
-        while (s_pingpong.status[i] == PINGPONG_BUF_SENDING) {
-            spi_device_get_trans_result(s_hspi, &rtrans, portMAX_DELAY);
-        }
-    }
+    _st7789_queue_trans(&s_trans[idx]);
 }
 #endif
 
@@ -180,27 +223,39 @@ bool st7789_is_inited(void)
 void st7789_sleep(void)
 {
     if (!s_inited) return;
+    _st7789_lock();
+    _st7789_wait_all_idle();
     _st7789_send_cmd(ST7789_CMD_SLEEP_IN);
     vTaskDelay(pdMS_TO_TICKS(5));
+    _st7789_unlock();
 }
 
 void st7789_wakeup(void)
 {
     if (!s_inited) return;
+    _st7789_lock();
+    _st7789_wait_all_idle();
     _st7789_send_cmd(ST7789_CMD_SLEEP_OUT);
     vTaskDelay(pdMS_TO_TICKS(120));
+    _st7789_unlock();
 }
 
 void st7789_display_on(void)
 {
     if (!s_inited) return;
+    _st7789_lock();
+    _st7789_wait_all_idle();
     _st7789_send_cmd(ST7789_CMD_DISPLAY_ON);
+    _st7789_unlock();
 }
 
 void st7789_display_off(void)
 {
     if (!s_inited) return;
+    _st7789_lock();
+    _st7789_wait_all_idle();
     _st7789_send_cmd(ST7789_CMD_DISPLAY_OFF);
+    _st7789_unlock();
 }
 
 static esp_err_t _st7789_config_init(void)
@@ -235,6 +290,11 @@ esp_err_t st7789_init(void)
         return ESP_OK;
     }
 
+    s_lock = xSemaphoreCreateMutex();
+    if (s_lock == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
     ESP_ERROR_CHECK(_st7789_spi_bus_init());
 
     ESP_ERROR_CHECK(_st7789_spi_dev_init());
@@ -261,9 +321,8 @@ void st7789_fill_screen(uint16_t color)
 {
     if (!s_inited) return;
 
-#if ST7789_PINGPONG_BUFFER_ENABLE
-    _st7789_pingpong_wait_all_idle();
-#endif
+    _st7789_lock();
+    _st7789_wait_all_idle();
 
     _st7789_set_window(0, 0, ST7789_WIDTH - 1, ST7789_HEIGHT - 1);
     _st7789_send_cmd(ST7789_CMD_RAMWR);
@@ -278,6 +337,7 @@ void st7789_fill_screen(uint16_t color)
 #endif
     if (fill_buf == NULL) {
         ESP_LOGE(TAG, "清屏缓冲区分配失败");
+        _st7789_unlock();
         return;
     }
 
@@ -296,6 +356,7 @@ void st7789_fill_screen(uint16_t color)
     }
 
     heap_caps_free(fill_buf);
+    _st7789_unlock();
 }
 
 // 绘制图像
@@ -303,9 +364,8 @@ void st7789_draw_image(const uint16_t *image_data)
 {
     if (!s_inited || image_data == NULL) return;
 
-#if ST7789_PINGPONG_BUFFER_ENABLE
-    _st7789_pingpong_wait_all_idle();
-#endif
+    _st7789_lock();
+    _st7789_wait_all_idle();
 
     _st7789_set_window(0, 0, ST7789_WIDTH - 1, ST7789_HEIGHT - 1);
     _st7789_send_cmd(ST7789_CMD_RAMWR);
@@ -350,7 +410,10 @@ void st7789_draw_image(const uint16_t *image_data)
 #else
     uint16_t *swap_buf = (uint16_t *)heap_caps_malloc(ST7789_MAX_TRANS_BYTES, MALLOC_CAP_DMA);
 #endif
-    if (swap_buf == NULL) return;
+    if (swap_buf == NULL) {
+        _st7789_unlock();
+        return;
+    }
 
     size_t offset = 0;
     while (offset < total_pixels) {
@@ -369,6 +432,7 @@ void st7789_draw_image(const uint16_t *image_data)
 
     heap_caps_free(swap_buf);
 #endif
+    _st7789_unlock();
 }
 
 // 在指定区域绘制 RGB565 图像（适配 LVGL 刷新接口）
@@ -376,9 +440,8 @@ void st7789_draw_area(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const uint
 {
     if (!s_inited || color_map == NULL) return;
 
-#if ST7789_PINGPONG_BUFFER_ENABLE
-    _st7789_pingpong_wait_all_idle();
-#endif
+    _st7789_lock();
+    _st7789_wait_all_idle();
 
     _st7789_set_window((uint16_t)x1, (uint16_t)y1, (uint16_t)x2, (uint16_t)y2);
     _st7789_send_cmd(ST7789_CMD_RAMWR);
@@ -393,6 +456,61 @@ void st7789_draw_area(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const uint
         _st7789_send_data_dma((const uint8_t *)(color_map + offset), send_pixels * sizeof(uint16_t));
         offset += send_pixels;
     }
+    _st7789_unlock();
+}
+
+// 分块直通输出：每块直接作为一个 DMA 事务排队，不经过 Ping-Pong 中转
+esp_err_t st7789_draw_chunks(int32_t x1, int32_t y1, int32_t x2, int32_t y2,
+                             const st7789_chunk_t *chunks, size_t count,
+                             st7789_chunks_done_cb_t done_cb, void *arg)
+{
+    if (!s_inited) return ESP_ERR_INVALID_STATE;
+    if (chunks == NULL || count == 0 || count > ST7789_CHUNK_MAX_COUNT ||
+        x1 < 0 || y1 < 0 || x2 >= ST7789_WIDTH || y2 >= ST7789_HEIGHT || x1 > x2 || y1 > y2) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (chunks[i].data == NULL || chunks[i].len == 0 || (chunks[i].len & 1) ||
+            chunks[i].len > ST7789_MAX_TRANS_BYTES) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        total += chunks[i].len;
+    }
+    if (total != (size_t)(x2 - x1 + 1) * (size_t)(y2 - y1 + 1) * ST7789_PIXEL_BPP) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    _st7789_lock();
+    _st7789_wait_all_idle();       // 同时执行上一组分块的完成回调
+
+    _st7789_set_window((uint16_t)x1, (uint16_t)y1, (uint16_t)x2, (uint16_t)y2);
+    _st7789_send_cmd(ST7789_CMD_RAMWR);
+
+    gpio_set_level(ST7789_DC_PIN, 1);
+    s_chunks_done_cb = done_cb;
+    s_chunks_done_arg = arg;
+    for (size_t i = 0; i < count; i++) {
+        s_chunk_trans[i] = (spi_transaction_t){
+            .length = chunks[i].len * 8,
+            .tx_buffer = chunks[i].data,
+            .user = (i + 1 == count) ? ST7789_TRANS_USER_CHUNK_LAST : ST7789_TRANS_USER_CHUNK,
+        };
+        _st7789_queue_trans(&s_chunk_trans[i]);
+    }
+
+    _st7789_unlock();
+    return ESP_OK;
+}
+
+void st7789_wait_idle(void)
+{
+    if (!s_inited) return;
+
+    _st7789_lock();
+    _st7789_wait_all_idle();
+    _st7789_unlock();
 }
 
 
@@ -0,0 +1,68 @@
+#ifndef __SYS_TASK_H__
+#define __SYS_TASK_H__
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sys_task_config.h"
+#include "esp_err.h"
+
+/**
+ * @brief 应用任务编号（对应 sys_task_config.h 中的布局表）
+ */
+typedef enum {
+    SYS_TASK_ID_LVGL = 0,
+    SYS_TASK_ID_LVGL_WORKER,
+    SYS_TASK_ID_MQTT,
+    SYS_TASK_ID_MQTT_TX,
+    SYS_TASK_ID_MPU6050_PRODUCER,
+    SYS_TASK_ID_MPU6050_CONSUMER,
+    SYS_TASK_ID_POSE,
+    SYS_TASK_ID_I2C_BUS,
+    SYS_TASK_ID_STATS,
+    SYS_TASK_ID_MAX
+} sys_task_id_t;
+
+/**
+ * @brief 任务布局描述
+ */
+typedef struct {
+    const char *name;       // 任务名
+    uint32_t stack_size;    // 栈大小（字节）
+    UBaseType_t priority;   // 优先级
+    BaseType_t core_id;     // 绑定核心
+} sys_task_desc_t;
+
+/**
+ * @brief 获取任务布局描述
+ *
+ * @param id 任务编号
+ * @return 描述指针，编号无效时返回 NULL
+ */
+const sys_task_desc_t *sys_task_get_desc(sys_task_id_t id);
+
+/**
+ * @brief 按布局表创建任务（绑定核心、优先级、栈大小）
+ *
+ * @param id 任务编号
+ * @param func 任务函数
+ * @param arg 任务参数
+ * @param handle 输出任务句柄（可为 NULL）
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效，ESP_ERR_NO_MEM 创建失败
+ */
+esp_err_t sys_task_create(sys_task_id_t id, TaskFunction_t func, void *arg, TaskHandle_t *handle);
+
+/**
+ * @brief 启动周期性任务运行时统计（各任务 CPU 占用、所在核心、栈余量）
+ *
+ * 需要开启 CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS，否则返回 ESP_ERR_NOT_SUPPORTED。
+ *
+ * @return ESP_OK 成功，其他值表示失败
+ */
+esp_err_t sys_task_stats_start(void);
+
+/**
+ * @brief 立即输出一次任务运行时统计（相对上一次输出的增量）
+ */
+void sys_task_stats_dump(void);
+
+#endif /* __SYS_TASK_H__ */
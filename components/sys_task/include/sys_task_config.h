@@ -0,0 +1,82 @@
+#ifndef __SYS_TASK_CONFIG_H__
+#define __SYS_TASK_CONFIG_H__
+
+/*
+ * 全局任务布局表：所有应用任务的核心绑定、优先级、栈大小统一在此配置。
+ *
+ * ESP32-S3 双核分工：
+ *   - CORE 0（通信核）：Wi-Fi / lwIP / esp_timer（见 sdkconfig 亲和性配置）、MQTT、MPU6050
+ *   - CORE 1（渲染核）：LVGL 渲染任务独占，避免与协议栈抢占
+ *
+ * 系统任务（不在此表中创建）：
+ *   - Wi-Fi 任务：CONFIG_ESP_WIFI_TASK_PINNED_TO_CORE_0
+ *   - lwIP tcpip 任务：CONFIG_LWIP_TCPIP_TASK_AFFINITY_CPU0
+ *   - MQTT 任务核心：CONFIG_MQTT_USE_CORE_0（优先级/栈由下表提供给 esp-mqtt，核心与下表编译期校验）
+ */
+
+/* ================= Core Assignment ================= */
+#define SYS_TASK_CORE_COMMS                 0               // 通信核
+#define SYS_TASK_CORE_RENDER                1               // 渲染核
+
+/* ================= LVGL ================= */
+#define SYS_TASK_LVGL_NAME                  "lvgl_task"
+#define SYS_TASK_LVGL_CORE                  SYS_TASK_CORE_RENDER
+#define SYS_TASK_LVGL_PRIORITY              (5)
+#define SYS_TASK_LVGL_STACK_SIZE            (8192)
+
+/*
+ * LVGL 并行渲染协作任务：运行在另一核心，分担半个刷新区域的像素混合。
+ * 优先级低于通信核上的采样、姿态发布与 MQTT 任务，只用空闲时间；
+ * 协作核来不及领取时渲染核自行收回半区，不会阻塞刷新。
+ */
+#define SYS_TASK_LVGL_WORKER_NAME           "lvgl_worker"
+#define SYS_TASK_LVGL_WORKER_CORE           SYS_TASK_CORE_COMMS
+#define SYS_TASK_LVGL_WORKER_PRIORITY       (4)
+#define SYS_TASK_LVGL_WORKER_STACK_SIZE     (3072)
+
+/* ================= MQTT（esp-mqtt 内部任务） ================= */
+#define SYS_TASK_MQTT_NAME                  "mqtt_task"
+#define SYS_TASK_MQTT_CORE                  SYS_TASK_CORE_COMMS
+#define SYS_TASK_MQTT_PRIORITY              (5)
+#define SYS_TASK_MQTT_STACK_SIZE            (6144)
+
+/* 发布队列发送任务：把队列中的消息交给 esp-mqtt（可能等待 esp-mqtt 内部锁），传感器任务只入队不阻塞 */
+#define SYS_TASK_MQTT_TX_NAME               "mqtt_tx"
+#define SYS_TASK_MQTT_TX_CORE               SYS_TASK_CORE_COMMS
+#define SYS_TASK_MQTT_TX_PRIORITY           (5)
+#define SYS_TASK_MQTT_TX_STACK_SIZE         (3072)
+
+/* ================= MPU6050 ================= */
+#define SYS_TASK_MPU6050_PRODUCER_NAME      "mpu6050_producer"
+#define SYS_TASK_MPU6050_PRODUCER_CORE      SYS_TASK_CORE_COMMS
+#define SYS_TASK_MPU6050_PRODUCER_PRIORITY  (7)
+#define SYS_TASK_MPU6050_PRODUCER_STACK_SIZE (4096)
+
+#define SYS_TASK_MPU6050_CONSUMER_NAME      "mpu6050_consumer"
+#define SYS_TASK_MPU6050_CONSUMER_CORE      SYS_TASK_CORE_COMMS
+#define SYS_TASK_MPU6050_CONSUMER_PRIORITY  (6)
+#define SYS_TASK_MPU6050_CONSUMER_STACK_SIZE (4096)
+
+/* ================= Pose Publisher ================= */
+/* 定速发布最新姿态，优先级高于 MPU6050 消费者，保证发布节拍 */
+#define SYS_TASK_POSE_NAME                  "pose_pub"
+#define SYS_TASK_POSE_CORE                  SYS_TASK_CORE_COMMS
+#define SYS_TASK_POSE_PRIORITY              (7)
+#define SYS_TASK_POSE_STACK_SIZE            (3072)
+
+/* ================= I2C Bus ================= */
+/* 异步 I2C 事务执行任务；MPU6050 高速采样走同步接口，不经过该任务 */
+#define SYS_TASK_I2C_BUS_NAME               "i2c_bus"
+#define SYS_TASK_I2C_BUS_CORE               SYS_TASK_CORE_COMMS
+#define SYS_TASK_I2C_BUS_PRIORITY           (6)
+#define SYS_TASK_I2C_BUS_STACK_SIZE         (3072)
+
+/* ================= Run-time Stats ================= */
+#define SYS_TASK_STATS_NAME                 "sys_stats"
+#define SYS_TASK_STATS_CORE                 SYS_TASK_CORE_COMMS
+#define SYS_TASK_STATS_PRIORITY             (1)
+#define SYS_TASK_STATS_STACK_SIZE           (3072)
+#define SYS_TASK_STATS_PERIOD_MS            (10000)         // 统计输出周期
+#define SYS_TASK_STATS_MAX_TASKS            (32)            // 单次快照最多记录的任务数
+
+#endif /* __SYS_TASK_CONFIG_H__ */
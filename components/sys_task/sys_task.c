@@ -0,0 +1,179 @@
+#include "sys_task.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "sys_task";
+
+static const sys_task_desc_t s_task_table[SYS_TASK_ID_MAX] = {
+    [SYS_TASK_ID_LVGL] = {
+        SYS_TASK_LVGL_NAME, SYS_TASK_LVGL_STACK_SIZE,
+        SYS_TASK_LVGL_PRIORITY, SYS_TASK_LVGL_CORE
+    },
+    [SYS_TASK_ID_LVGL_WORKER] = {
+        SYS_TASK_LVGL_WORKER_NAME, SYS_TASK_LVGL_WORKER_STACK_SIZE,
+        SYS_TASK_LVGL_WORKER_PRIORITY, SYS_TASK_LVGL_WORKER_CORE
+    },
+    [SYS_TASK_ID_MQTT] = {
+        SYS_TASK_MQTT_NAME, SYS_TASK_MQTT_STACK_SIZE,
+        SYS_TASK_MQTT_PRIORITY, SYS_TASK_MQTT_CORE
+    },
+    [SYS_TASK_ID_MQTT_TX] = {
+        SYS_TASK_MQTT_TX_NAME, SYS_TASK_MQTT_TX_STACK_SIZE,
+        SYS_TASK_MQTT_TX_PRIORITY, SYS_TASK_MQTT_TX_CORE
+    },
+    [SYS_TASK_ID_MPU6050_PRODUCER] = {
+        SYS_TASK_MPU6050_PRODUCER_NAME, SYS_TASK_MPU6050_PRODUCER_STACK_SIZE,
+        SYS_TASK_MPU6050_PRODUCER_PRIORITY, SYS_TASK_MPU6050_PRODUCER_CORE
+    },
+    [SYS_TASK_ID_MPU6050_CONSUMER] = {
+        SYS_TASK_MPU6050_CONSUMER_NAME, SYS_TASK_MPU6050_CONSUMER_STACK_SIZE,
+        SYS_TASK_MPU6050_CONSUMER_PRIORITY, SYS_TASK_MPU6050_CONSUMER_CORE
+    },
+    [SYS_TASK_ID_POSE] = {
+        SYS_TASK_POSE_NAME, SYS_TASK_POSE_STACK_SIZE,
+        SYS_TASK_POSE_PRIORITY, SYS_TASK_POSE_CORE
+    },
+    [SYS_TASK_ID_I2C_BUS] = {
+        SYS_TASK_I2C_BUS_NAME, SYS_TASK_I2C_BUS_STACK_SIZE,
+        SYS_TASK_I2C_BUS_PRIORITY, SYS_TASK_I2C_BUS_CORE
+    },
+    [SYS_TASK_ID_STATS] = {
+        SYS_TASK_STATS_NAME, SYS_TASK_STATS_STACK_SIZE,
+        SYS_TASK_STATS_PRIORITY, SYS_TASK_STATS_CORE
+    },
+};
+
+const sys_task_desc_t *sys_task_get_desc(sys_task_id_t id)
+{
+    if (id < 0 || id >= SYS_TASK_ID_MAX) {
+        return NULL;
+    }
+    return &s_task_table[id];
+}
+
+esp_err_t sys_task_create(sys_task_id_t id, TaskFunction_t func, void *arg, TaskHandle_t *handle)
+{
+    const sys_task_desc_t *desc = sys_task_get_desc(id);
+    if (desc == NULL || func == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    BaseType_t ret = xTaskCreatePinnedToCore(
+        func,
+        desc->name,
+        desc->stack_size,
+        arg,
+        desc->priority,
+        handle,
+        desc->core_id
+    );
+
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "创建任务 %s 失败", desc->name);
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "任务 %s -> core %d, prio %u, stack %lu",
+             desc->name, (int)desc->core_id, (unsigned)desc->priority, (unsigned long)desc->stack_size);
+    return ESP_OK;
+}
+
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+/* 上一次快照：按任务句柄匹配计算增量 */
+typedef struct {
+    TaskHandle_t handle;
+    configRUN_TIME_COUNTER_TYPE run_time;
+} sys_task_snapshot_t;
+
+static sys_task_snapshot_t s_prev[SYS_TASK_STATS_MAX_TASKS];
+static UBaseType_t s_prev_count = 0;
+static configRUN_TIME_COUNTER_TYPE s_prev_total = 0;
+static TaskStatus_t s_status[SYS_TASK_STATS_MAX_TASKS];
+static TaskHandle_t s_stats_task = NULL;
+
+static configRUN_TIME_COUNTER_TYPE _sys_task_prev_run_time(TaskHandle_t handle)
+{
+    for (UBaseType_t i = 0; i < s_prev_count; i++) {
+        if (s_prev[i].handle == handle) {
+            return s_prev[i].run_time;
+        }
+    }
+    return 0;
+}
+
+void sys_task_stats_dump(void)
+{
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    UBaseType_t count = uxTaskGetSystemState(s_status, SYS_TASK_STATS_MAX_TASKS, &total);
+    if (count == 0) {
+        ESP_LOGW(TAG, "任务数超过 %d，无法统计", SYS_TASK_STATS_MAX_TASKS);
+        return;
+    }
+
+    // 运行时计数器以 esp_timer 为时基，elapsed 即单个核心在本周期内的可用时间
+    configRUN_TIME_COUNTER_TYPE elapsed = total - s_prev_total;
+    if (elapsed == 0) {
+        return;
+    }
+
+    ESP_LOGI(TAG, "%-16s %4s %4s %7s %6s", "task", "core", "prio", "cpu%", "stack");
+    for (UBaseType_t i = 0; i < count; i++) {
+        const TaskStatus_t *st = &s_status[i];
+        configRUN_TIME_COUNTER_TYPE delta = st->ulRunTimeCounter - _sys_task_prev_run_time(st->xHandle);
+        BaseType_t core = xTaskGetCoreID(st->xHandle);
+        uint32_t permille = (uint32_t)(((uint64_t)delta * 1000U) / elapsed);
+
+        ESP_LOGI(TAG, "%-16s %4s %4u %3lu.%lu%% %6lu",
+                 st->pcTaskName,
+                 (core == tskNO_AFFINITY) ? "any" : ((core == 0) ? "0" : "1"),
+                 (unsigned)st->uxCurrentPriority,
+                 (unsigned long)(permille / 10), (unsigned long)(permille % 10),
+                 (unsigned long)st->usStackHighWaterMark);
+    }
+
+    for (UBaseType_t i = 0; i < count; i++) {
+        s_prev[i].handle = s_status[i].xHandle;
+        s_prev[i].run_time = s_status[i].ulRunTimeCounter;
+    }
+    s_prev_count = count;
+    s_prev_total = total;
+}
+
+static void _sys_task_stats_task(void *arg)
+{
+    (void)arg;
+
+    TickType_t last_wake = xTaskGetTickCount();
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(SYS_TASK_STATS_PERIOD_MS));
+        sys_task_stats_dump();
+    }
+}
+
+esp_err_t sys_task_stats_start(void)
+{
+    if (s_stats_task != NULL) {
+        return ESP_OK;
+    }
+
+    // 记录基准快照，首次输出即为一个完整周期的增量
+    s_prev_count = uxTaskGetSystemState(s_status, SYS_TASK_STATS_MAX_TASKS, &s_prev_total);
+    for (UBaseType_t i = 0; i < s_prev_count; i++) {
+        s_prev[i].handle = s_status[i].xHandle;
+        s_prev[i].run_time = s_status[i].ulRunTimeCounter;
+    }
+
+    return sys_task_create(SYS_TASK_ID_STATS, _sys_task_stats_task, NULL, &s_stats_task);
+}
+#else
+void sys_task_stats_dump(void)
+{
+    ESP_LOGW(TAG, "未开启 CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS");
+}
+
+esp_err_t sys_task_stats_start(void)
+{
+    ESP_LOGW(TAG, "未开启 CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+#endif
@@ -0,0 +1,46 @@
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#include "esp_err.h"
+#include "mpu6050_task.h"
+#include <stdint.h>
+
+/**
+ * @brief 遥测统计
+ */
+typedef struct {
+    uint32_t messages;          // 已发布消息数
+    uint32_t samples;           // 已发布采样数
+    uint32_t bytes;             // 已发布负载字节数
+    uint32_t publish_failed;    // 发布失败（未连接等）丢弃的消息数
+} telemetry_stats_t;
+
+/**
+ * @brief 启动 MPU6050 遥测：注册采样回调，按批次编码后发布到 TELEMETRY_TOPIC
+ *
+ * 同时注册消费者空闲回调：采样中断时，未满的批次最迟在 TELEMETRY_FLUSH_INTERVAL_MS 后发出。
+ *
+ * 需先调用 mpu6050_task_init()。
+ *
+ * @return ESP_OK 成功
+ */
+esp_err_t telemetry_start(void);
+
+/**
+ * @brief 追加一个采样（批次满或超过刷新间隔时发布）
+ * @param sample 采样数据
+ */
+void telemetry_push(const mpu6050_sample_t *sample);
+
+/**
+ * @brief 立即发布当前批次（批次为空时不发送）
+ */
+void telemetry_flush(void);
+
+/**
+ * @brief 获取遥测统计
+ * @param stats 输出
+ */
+void telemetry_get_stats(telemetry_stats_t *stats);
+
+#endif /* __TELEMETRY_H__ */
@@ -0,0 +1,34 @@
+#ifndef __TELEMETRY_CONFIG_H__
+#define __TELEMETRY_CONFIG_H__
+
+#include "mymqtt_config.h"
+
+/* ================= Publish Config ================= */
+#define TELEMETRY_TOPIC                 MYMQTT_TOPIC_MPU6050    // 发布主题
+#define TELEMETRY_QOS                   0                       // QoS 0：丢包由下一批覆盖，不重传
+#define TELEMETRY_BATCH_SAMPLES         (25)                    // 每条消息最多采样数
+#define TELEMETRY_FLUSH_INTERVAL_MS     (250)                   // 批次最长停留时间（首个采样起算）
+
+/* ================= Packet Format =================
+ * 小端序，单条消息：
+ *   [0]     u8   版本号 TELEMETRY_FORMAT_VERSION
+ *   [1]     u8   采样数 n（>= 1）
+ *   [2..3]  u16  消息序号（丢包检测）
+ *   [4..11] u64  首个采样时间戳（us）
+ *   [12]    u8   陀螺仪量程 FS_SEL（0-3 对应 ±250/500/1000/2000°/s）
+ *   [13]    u8   加速度计量程 AFS_SEL（0-3 对应 ±2/4/8/16g）
+ *   [14..25] i16 x6 首个采样原始值（ax ay az gx gy gz）
+ *   其余 n-1 个采样依次为：
+ *           varint      距上一采样的时间差（us）
+ *           zigzag-varint x6 各通道相对上一采样的差值
+ * 同一批次内量程不变，量程切换时提前结束当前批次。
+ */
+#define TELEMETRY_FORMAT_VERSION        2
+#define TELEMETRY_CHANNELS              6
+#define TELEMETRY_HEADER_BYTES          (14)
+#define TELEMETRY_KEYFRAME_BYTES        (TELEMETRY_CHANNELS * 2)
+#define TELEMETRY_DELTA_MAX_BYTES       (5 + TELEMETRY_CHANNELS * 3)    // 时间差最多 5 字节，int16 差值最多 3 字节
+#define TELEMETRY_PACKET_MAX_BYTES      (TELEMETRY_HEADER_BYTES + TELEMETRY_KEYFRAME_BYTES + \
+                                         (TELEMETRY_BATCH_SAMPLES - 1) * TELEMETRY_DELTA_MAX_BYTES)
+
+#endif /* __TELEMETRY_CONFIG_H__ */
@@ -0,0 +1,183 @@
+#include "telemetry.h"
+#include "telemetry_config.h"
+#include "mymqtt.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "telemetry";
+
+static uint8_t s_packet[TELEMETRY_PACKET_MAX_BYTES];   // 当前批次编码缓冲（只在消费者任务中访问）
+static size_t s_packet_len = 0;
+static uint8_t s_count = 0;                 // 当前批次采样数
+static uint16_t s_seq = 0;                  // 消息序号
+static int64_t s_batch_start_us = 0;        // 当前批次首个采样时间
+static mpu6050_sample_t s_prev;             // 上一采样（差分基准）
+static telemetry_stats_t s_stats;
+static bool s_started = false;
+
+// 无符号 LEB128 变长编码
+static size_t _telemetry_put_varint(uint8_t *dst, uint32_t value)
+{
+    size_t n = 0;
+    while (value >= 0x80) {
+        dst[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    dst[n++] = (uint8_t)value;
+    return n;
+}
+
+// zigzag：小幅正负差值都编码为小的无符号数
+static inline uint32_t _telemetry_zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline void _telemetry_put_u16(uint8_t *dst, uint16_t value)
+{
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8);
+}
+
+static void _telemetry_channels(const mpu6050_raw_data_t *raw, int16_t out[TELEMETRY_CHANNELS])
+{
+    out[0] = raw->accel_x;
+    out[1] = raw->accel_y;
+    out[2] = raw->accel_z;
+    out[3] = raw->gyro_x;
+    out[4] = raw->gyro_y;
+    out[5] = raw->gyro_z;
+}
+
+// 开始新批次：写入头部与首个完整采样
+static void _telemetry_begin(const mpu6050_sample_t *sample)
+{
+    int16_t ch[TELEMETRY_CHANNELS];
+    uint64_t ts = (uint64_t)sample->timestamp_us;
+
+    s_packet[0] = TELEMETRY_FORMAT_VERSION;
+    s_packet[1] = 1;
+    _telemetry_put_u16(&s_packet[2], s_seq);
+    for (int i = 0; i < 8; i++) {
+        s_packet[4 + i] = (uint8_t)(ts >> (8 * i));
+    }
+
+    // 量程寄存器值的 bit[4:3] 即 FS_SEL / AFS_SEL
+    mpu6050_scale_info_t info = {0};
+    mpu6050_get_scale_info(sample->scale_id, &info);
+    s_packet[12] = (uint8_t)(info.gyro_range >> 3);
+    s_packet[13] = (uint8_t)(info.accel_range >> 3);
+
+    _telemetry_channels(&sample->raw, ch);
+    for (int i = 0; i < TELEMETRY_CHANNELS; i++) {
+        _telemetry_put_u16(&s_packet[TELEMETRY_HEADER_BYTES + i * 2], (uint16_t)ch[i]);
+    }
+
+    s_packet_len = TELEMETRY_HEADER_BYTES + TELEMETRY_KEYFRAME_BYTES;
+    s_count = 1;
+    s_batch_start_us = sample->timestamp_us;
+}
+
+// 追加差分采样
+static void _telemetry_append(const mpu6050_sample_t *sample)
+{
+    int16_t cur[TELEMETRY_CHANNELS];
+    int16_t prev[TELEMETRY_CHANNELS];
+    int64_t dt = sample->timestamp_us - s_prev.timestamp_us;
+
+    _telemetry_channels(&sample->raw, cur);
+    _telemetry_channels(&s_prev.raw, prev);
+
+    s_packet_len += _telemetry_put_varint(&s_packet[s_packet_len], (dt > 0) ? (uint32_t)dt : 0);
+    for (int i = 0; i < TELEMETRY_CHANNELS; i++) {
+        int32_t delta = (int32_t)cur[i] - (int32_t)prev[i];
+        s_packet_len += _telemetry_put_varint(&s_packet[s_packet_len], _telemetry_zigzag(delta));
+    }
+
+    s_count++;
+    s_packet[1] = s_count;
+}
+
+void telemetry_flush(void)
+{
+    if (s_count == 0) {
+        return;
+    }
+
+    int ret = mymqtt_publish(TELEMETRY_TOPIC, s_packet, s_packet_len, TELEMETRY_QOS);
+    if (ret < 0) {
+        s_stats.publish_failed++;
+    } else {
+        s_stats.messages++;
+        s_stats.samples += s_count;
+        s_stats.bytes += s_packet_len;
+    }
+
+    ESP_LOGD(TAG, "seq %u: %u 个采样, %u 字节", s_seq, s_count, (unsigned)s_packet_len);
+
+    s_seq++;
+    s_count = 0;
+    s_packet_len = 0;
+}
+
+void telemetry_push(const mpu6050_sample_t *sample)
+{
+    if (sample == NULL) {
+        return;
+    }
+
+    // 量程切换：旧批次按原量程发出（只有零偏不同的换算组不影响原始值）
+    if (s_count > 0 && !mpu6050_scale_same_range(sample->scale_id, s_prev.scale_id)) {
+        telemetry_flush();
+    }
+
+    if (s_count == 0) {
+        _telemetry_begin(sample);
+    } else {
+        _telemetry_append(sample);
+    }
+    s_prev = *sample;
+
+    if (s_count >= TELEMETRY_BATCH_SAMPLES ||
+        sample->timestamp_us - s_batch_start_us >= (int64_t)TELEMETRY_FLUSH_INTERVAL_MS * 1000) {
+        telemetry_flush();
+    }
+}
+
+// 没有新采样时按时刷新部分批次（消费者空闲回调），返回距刷新截止的剩余时间
+static uint32_t _telemetry_idle(int64_t now_us)
+{
+    if (s_count == 0) {
+        return MPU6050_IDLE_WAIT_FOREVER;
+    }
+
+    int64_t remain_us = (int64_t)TELEMETRY_FLUSH_INTERVAL_MS * 1000 - (now_us - s_batch_start_us);
+    if (remain_us <= 0) {
+        telemetry_flush();
+        return MPU6050_IDLE_WAIT_FOREVER;
+    }
+    return (uint32_t)((remain_us + 999) / 1000);
+}
+
+void telemetry_get_stats(telemetry_stats_t *stats)
+{
+    if (stats != NULL) {
+        *stats = s_stats;
+    }
+}
+
+esp_err_t telemetry_start(void)
+{
+    if (s_started) {
+        return ESP_OK;
+    }
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    mpu6050_task_set_sample_cb(telemetry_push);
+    mpu6050_task_set_idle_cb(_telemetry_idle);
+
+    s_started = true;
+    ESP_LOGI(TAG, "遥测已启动：%d 采样/批，刷新间隔 %d ms，最大 %d 字节/消息",
+             TELEMETRY_BATCH_SAMPLES, TELEMETRY_FLUSH_INTERVAL_MS, TELEMETRY_PACKET_MAX_BYTES);
+    return ESP_OK;
+}
@@ -24,6 +24,7 @@
 
 /* ================= Reconnect Config ================= */
 #define WIFI_RECONNECT_MAX_ATTEMPTS     5           // 最大重连次数
+#define WIFI_RECONNECT_FIRST_DELAY_MS   100         // 首次重连延迟（短暂掉线快速恢复）
 #define WIFI_RECONNECT_BASE_DELAY_MS    1000        // 基础延迟 1 秒
 #define WIFI_RECONNECT_MAX_DELAY_MS     30000       // 最大延迟 30 秒
 
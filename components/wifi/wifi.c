@@ -47,10 +47,13 @@ static void _start_reconnect_timer(void)
         xTimerDelete(s_reconnect_timer, 0);
     }
     
-    // 指数退避：1s, 2s, 4s, 8s, 16s, 30s(上限)
-    uint32_t delay_ms = WIFI_RECONNECT_BASE_DELAY_MS * (1 << s_reconnect_attempts);
-    if (delay_ms > WIFI_RECONNECT_MAX_DELAY_MS) {
-        delay_ms = WIFI_RECONNECT_MAX_DELAY_MS;
+    // 首次快速重连，之后指数退避：2s, 4s, 8s, 16s, 30s(上限)
+    uint32_t delay_ms = WIFI_RECONNECT_FIRST_DELAY_MS;
+    if (s_reconnect_attempts > 0) {
+        delay_ms = WIFI_RECONNECT_BASE_DELAY_MS * (1 << s_reconnect_attempts);
+        if (delay_ms > WIFI_RECONNECT_MAX_DELAY_MS) {
+            delay_ms = WIFI_RECONNECT_MAX_DELAY_MS;
+        }
     }
     
     ESP_LOGI(TAG, "延迟 %lu ms 后重连", delay_ms);
@@ -33,7 +33,10 @@ esp_err_t wifi_credentials_load_sta(char *ssid, size_t ssid_len, char *password,
         return ESP_ERR_INVALID_ARG;
     }
 
-    ESP_ERROR_CHECK(nvs_storage_get_str(WIFI_STA_NAMESPACE, SSID_KEY, ssid, ssid_len));
+    esp_err_t ret = nvs_storage_get_str(WIFI_STA_NAMESPACE, SSID_KEY, ssid, ssid_len);
+    if (ret != ESP_OK) {
+        return ret;
+    }
 
     if (password != NULL && pass_len > 0) {
         esp_err_t err = nvs_storage_get_str(WIFI_STA_NAMESPACE, PASSWORD_KEY, password, pass_len);
@@ -69,7 +72,10 @@ esp_err_t wifi_credentials_load_ap(char *ssid, size_t ssid_len, char *password,
         return ESP_ERR_INVALID_ARG;
     }
 
-    ESP_ERROR_CHECK(nvs_storage_get_str(WIFI_AP_NAMESPACE, SSID_KEY, ssid, ssid_len));
+    esp_err_t ret = nvs_storage_get_str(WIFI_AP_NAMESPACE, SSID_KEY, ssid, ssid_len);
+    if (ret != ESP_OK) {
+        return ret;
+    }
 
     if (password != NULL && pass_len > 0) {
         esp_err_t err = nvs_storage_get_str(WIFI_AP_NAMESPACE, PASSWORD_KEY, password, pass_len);
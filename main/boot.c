@@ -0,0 +1,81 @@
+#include "boot.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+
+static const char *TAG = "boot";
+
+static EventGroupHandle_t s_boot_events = NULL;
+static int64_t s_stage_time_us[BOOT_STAGE_MAX];     // 各阶段完成时间（esp_timer 时间戳）
+
+static const char *s_stage_names[BOOT_STAGE_MAX] = {
+    [BOOT_STAGE_START]       = "app_main",
+    [BOOT_STAGE_NVS]         = "nvs",
+    [BOOT_STAGE_DISPLAY]     = "display",
+    [BOOT_STAGE_WIFI]        = "wifi_got_ip",
+    [BOOT_STAGE_MQTT]        = "mqtt_connected",
+    [BOOT_STAGE_FIRST_FRAME] = "first_frame",
+};
+
+esp_err_t boot_init(void)
+{
+    if (s_boot_events != NULL) {
+        return ESP_OK;
+    }
+
+    s_boot_events = xEventGroupCreate();
+    if (s_boot_events == NULL) {
+        ESP_LOGE(TAG, "创建事件组失败");
+        return ESP_ERR_NO_MEM;
+    }
+
+    boot_stage_done(BOOT_STAGE_START);
+    return ESP_OK;
+}
+
+void boot_stage_done(boot_stage_t stage)
+{
+    if (s_boot_events == NULL || stage >= BOOT_STAGE_MAX) {
+        return;
+    }
+
+    // 先写时间戳再置位，等待方看到事件位时时间戳已有效
+    int64_t now = esp_timer_get_time();
+    if ((xEventGroupGetBits(s_boot_events) & BOOT_STAGE_BIT(stage)) == 0) {
+        s_stage_time_us[stage] = now;
+        xEventGroupSetBits(s_boot_events, BOOT_STAGE_BIT(stage));
+        ESP_LOGI(TAG, "[%lld us] %s", (long long)now, s_stage_names[stage]);
+    }
+}
+
+bool boot_wait(uint32_t stage_bits, uint32_t timeout_ms)
+{
+    if (s_boot_events == NULL) {
+        return false;
+    }
+
+    EventBits_t bits = xEventGroupWaitBits(s_boot_events, stage_bits, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeout_ms));
+    return (bits & stage_bits) == stage_bits;
+}
+
+void boot_timeline_dump(void)
+{
+    if (s_boot_events == NULL) {
+        return;
+    }
+
+    EventBits_t bits = xEventGroupGetBits(s_boot_events);
+    int64_t base = s_stage_time_us[BOOT_STAGE_START];
+
+    ESP_LOGI(TAG, "启动时间线:");
+    for (int i = 0; i < BOOT_STAGE_MAX; i++) {
+        if (bits & BOOT_STAGE_BIT(i)) {
+            ESP_LOGI(TAG, "  %-16s %10lld us  (+%lld us)", s_stage_names[i],
+                     (long long)s_stage_time_us[i], (long long)(s_stage_time_us[i] - base));
+        } else {
+            ESP_LOGI(TAG, "  %-16s %10s", s_stage_names[i], "pending");
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef __BOOT_H__
+#define __BOOT_H__
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief 启动阶段（各阶段并行推进，完成时各自上报）
+ */
+typedef enum {
+    BOOT_STAGE_START = 0,       // app_main 开始
+    BOOT_STAGE_NVS,             // NVS 就绪（凭证/校准数据可读）
+    BOOT_STAGE_DISPLAY,         // LVGL 与屏幕初始化完成
+    BOOT_STAGE_WIFI,            // 已获取 IP
+    BOOT_STAGE_MQTT,            // MQTT 已连接
+    BOOT_STAGE_FIRST_FRAME,     // 第一帧图像已显示
+    BOOT_STAGE_MAX
+} boot_stage_t;
+
+#define BOOT_STAGE_BIT(stage)   (1U << (stage))
+
+/**
+ * @brief 初始化启动时间线（在 app_main 最开始调用）
+ * @return ESP_OK 成功，ESP_ERR_NO_MEM 创建事件组失败
+ */
+esp_err_t boot_init(void);
+
+/**
+ * @brief 标记某阶段完成（可在任意任务中调用，只记录第一次）
+ * @param stage 阶段
+ */
+void boot_stage_done(boot_stage_t stage);
+
+/**
+ * @brief 等待一组阶段全部完成
+ * @param stage_bits BOOT_STAGE_BIT() 组合
+ * @param timeout_ms 超时时间（毫秒）
+ * @return true 全部完成，false 超时
+ */
+bool boot_wait(uint32_t stage_bits, uint32_t timeout_ms);
+
+/**
+ * @brief 输出启动时间线（微秒时间戳及相对 app_main 的耗时）
+ */
+void boot_timeline_dump(void);
+
+#endif /* __BOOT_H__ */
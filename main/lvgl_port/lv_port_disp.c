@@ -10,6 +10,7 @@
  *      包含头文件
  *********************/
 #include "lv_port_disp.h"
+#include "lv_port_draw.h"
 #include <stdbool.h>
 #include "st7789.h"
 #include "esp_log.h"
@@ -152,6 +153,11 @@ void lv_port_disp_init(void)
      * 如果你使用的是其他 GPU，可通过此回调进行集成。*/
     //disp_drv.gpu_fill_cb = gpu_fill;
 
+    /* 使用双核并行绘制上下文（基于 lv_draw_sw，像素混合拆分到两个核心） */
+    disp_drv.draw_ctx_init = lv_port_draw_ctx_init;
+    disp_drv.draw_ctx_deinit = lv_port_draw_ctx_deinit;
+    disp_drv.draw_ctx_size = sizeof(lv_draw_sw_ctx_t);
+
     /* 最后，注册该显示驱动 */
     lv_disp_drv_register(&disp_drv);
 }
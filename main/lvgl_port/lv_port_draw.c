@@ -0,0 +1,181 @@
+/**
+ * @file lv_port_draw.c
+ *
+ * 双核并行软件渲染：在 lv_draw_sw 基础上替换 blend 回调，
+ * 将每次像素混合按行拆分为上下两半，由渲染核与协作核同时完成。
+ *
+ * 说明：LVGL 8.3 的对象树遍历、遮罩生成、lv_mem 分配和各类缓存都不可重入，
+ * 因此只并行化无共享状态的像素混合（填充/贴图/遮罩混合），其余绘制流程仍在渲染核执行。
+ */
+
+/*********************
+ *      包含头文件
+ *********************/
+#include "lv_port_draw.h"
+#include "sys_task.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include <stdatomic.h>
+
+#if LV_PORT_DRAW_PARALLEL_ENABLE
+
+/*********************
+ *      宏定义
+ *********************/
+
+/**********************
+ *      类型定义
+ **********************/
+/* 跨核任务状态 */
+enum {
+    DRAW_JOB_IDLE = 0,      // 空闲 / 已被渲染核收回
+    DRAW_JOB_POSTED,        // 已投递，等待协作核领取
+    DRAW_JOB_CLAIMED,       // 协作核正在处理
+};
+
+/* 协作核处理的半区任务 */
+typedef struct {
+    lv_draw_ctx_t ctx;                      // 绘制上下文副本（仅裁剪区域不同）
+    lv_area_t clip;                         // 协作核负责的半区
+    const lv_draw_sw_blend_dsc_t * dsc;     // 混合描述（在渲染核栈上，屏障前保持有效）
+    atomic_int state;
+} lv_port_draw_job_t;
+
+/**********************
+ *  静态函数声明
+ **********************/
+static void draw_blend_parallel(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc);
+static void draw_worker_task(void * arg);
+
+/**********************
+ *  静态变量
+ **********************/
+static const char * TAG = "lv_port_draw";
+
+static lv_port_draw_job_t s_job;
+static TaskHandle_t s_worker = NULL;
+static SemaphoreHandle_t s_job_done = NULL;
+
+/**********************
+ *   全局函数
+ **********************/
+
+void lv_port_draw_ctx_init(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx)
+{
+    lv_draw_sw_init_ctx(drv, draw_ctx);
+
+    if(s_worker == NULL) {
+        atomic_init(&s_job.state, DRAW_JOB_IDLE);
+
+        s_job_done = xSemaphoreCreateBinary();
+        if(s_job_done == NULL) {
+            ESP_LOGE(TAG, "创建同步信号量失败，使用单核渲染");
+            return;
+        }
+
+        if(sys_task_create(SYS_TASK_ID_LVGL_WORKER, draw_worker_task, NULL, &s_worker) != ESP_OK) {
+            ESP_LOGE(TAG, "创建协作任务失败，使用单核渲染");
+            vSemaphoreDelete(s_job_done);
+            s_job_done = NULL;
+            s_worker = NULL;
+            return;
+        }
+    }
+
+    ((lv_draw_sw_ctx_t *)draw_ctx)->blend = draw_blend_parallel;
+}
+
+void lv_port_draw_ctx_deinit(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx)
+{
+    /* 协作任务常驻，供后续注册的显示复用 */
+    lv_draw_sw_deinit_ctx(drv, draw_ctx);
+}
+
+/**********************
+ *   静态函数
+ **********************/
+
+/* 协作核：领取渲染核投递的上半区并完成混合 */
+static void draw_worker_task(void * arg)
+{
+    (void)arg;
+
+    while(1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        int expected = DRAW_JOB_POSTED;
+        if(!atomic_compare_exchange_strong_explicit(&s_job.state, &expected, DRAW_JOB_CLAIMED,
+                                                    memory_order_acquire, memory_order_relaxed)) {
+            /* 任务已被渲染核收回 */
+            continue;
+        }
+
+        lv_draw_sw_blend_basic(&s_job.ctx, s_job.dsc);
+
+        atomic_store_explicit(&s_job.state, DRAW_JOB_IDLE, memory_order_release);
+        xSemaphoreGive(s_job_done);
+    }
+}
+
+/* 渲染核：拆分混合区域，下半区本地处理，上半区交给协作核，返回前等待屏障 */
+static void draw_blend_parallel(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc)
+{
+    lv_area_t blend_area;
+    if(!_lv_area_intersect(&blend_area, dsc->blend_area, draw_ctx->clip_area)) return;
+
+    lv_disp_t * disp = _lv_refr_get_disp_refreshing();
+    lv_coord_t h = lv_area_get_height(&blend_area);
+
+    /* 小区域、逐像素回调、透明屏幕或需要就地修改遮罩（关闭抗锯齿）时不拆分 */
+    if(h < 2 || lv_area_get_size(&blend_area) < LV_PORT_DRAW_PARALLEL_MIN_PX ||
+       disp->driver->set_px_cb != NULL || disp->driver->screen_transp ||
+       (dsc->mask_buf != NULL && disp->driver->antialiasing == 0)) {
+        lv_draw_sw_blend_basic(draw_ctx, dsc);
+        return;
+    }
+
+    lv_coord_t mid = blend_area.y1 + h / 2;
+
+    /* 上半区交给协作核 */
+    s_job.ctx = *draw_ctx;
+    s_job.clip = blend_area;
+    s_job.clip.y2 = mid - 1;
+    s_job.ctx.clip_area = &s_job.clip;
+    s_job.dsc = dsc;
+    atomic_store_explicit(&s_job.state, DRAW_JOB_POSTED, memory_order_release);
+    xTaskNotifyGive(s_worker);
+
+    /* 下半区在本核处理 */
+    lv_draw_ctx_t local_ctx = *draw_ctx;
+    lv_area_t local_clip = blend_area;
+    local_clip.y1 = mid;
+    local_ctx.clip_area = &local_clip;
+    lv_draw_sw_blend_basic(&local_ctx, dsc);
+
+    /* 协作核尚未领取（例如被 Wi-Fi 等高优先级任务占用）时直接收回，避免空等 */
+    int expected = DRAW_JOB_POSTED;
+    if(atomic_compare_exchange_strong_explicit(&s_job.state, &expected, DRAW_JOB_IDLE,
+                                               memory_order_acq_rel, memory_order_relaxed)) {
+        lv_draw_sw_blend_basic(&s_job.ctx, dsc);
+        return;
+    }
+
+    /* 屏障：协作核完成后才能返回，保证 flush 前整块缓冲区已写完 */
+    xSemaphoreTake(s_job_done, portMAX_DELAY);
+}
+
+#else /* LV_PORT_DRAW_PARALLEL_ENABLE */
+
+void lv_port_draw_ctx_init(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx)
+{
+    lv_draw_sw_init_ctx(drv, draw_ctx);
+}
+
+void lv_port_draw_ctx_deinit(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx)
+{
+    lv_draw_sw_deinit_ctx(drv, draw_ctx);
+}
+
+#endif /* LV_PORT_DRAW_PARALLEL_ENABLE */
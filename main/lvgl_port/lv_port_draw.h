@@ -0,0 +1,49 @@
+/**
+ * @file lv_port_draw.h
+ *
+ */
+
+#ifndef LV_PORT_DRAW_H
+#define LV_PORT_DRAW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      包含文件
+ *********************/
+#include "lvgl.h"
+#include "draw/sw/lv_draw_sw.h"
+
+/*********************
+ *      定义
+ *********************/
+/* 双核并行渲染开关 (0=关闭, 1=开启) */
+#define LV_PORT_DRAW_PARALLEL_ENABLE    1
+
+/* 混合区域像素数低于该值时不拆分，避免跨核同步开销大于收益 */
+#define LV_PORT_DRAW_PARALLEL_MIN_PX    (2048)
+
+/**********************
+ *      类型定义
+ **********************/
+
+/**********************
+ * 全局函数原型
+ **********************/
+/* 初始化双核绘制上下文（基于 lv_draw_sw，作为 disp_drv.draw_ctx_init 使用） */
+void lv_port_draw_ctx_init(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx);
+
+/* 反初始化双核绘制上下文（作为 disp_drv.draw_ctx_deinit 使用） */
+void lv_port_draw_ctx_deinit(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx);
+
+/**********************
+ *      宏
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_PORT_DRAW_H*/
@@ -1,15 +1,92 @@
 #include "lvgl_task.h"
 #include "lvgl_ui.h"
 #include "lv_port_disp.h"
+#include "sys_task.h"
+#include "boot.h"
 #include "lvgl.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "esp_log.h"
+#include <stdatomic.h>
 
 static const char *TAG = "lvgl_task";
 
 static TaskHandle_t s_lvgl_task_handle = NULL;
+static SemaphoreHandle_t s_lvgl_mutex = NULL;
 
+#define LVGL_ASYNC_MASK     (LVGL_TASK_ASYNC_QUEUE_LEN - 1)
+
+_Static_assert((LVGL_TASK_ASYNC_QUEUE_LEN & LVGL_ASYNC_MASK) == 0,
+               "LVGL_TASK_ASYNC_QUEUE_LEN 必须为 2 的幂");
+
+/* 邮箱槽位：seq 用于生产者之间的无锁占位和与消费者的发布同步 */
+typedef struct {
+    atomic_uint seq;
+    lvgl_task_async_cb_t cb;
+    void *arg;
+} lvgl_async_cell_t;
+
+static lvgl_async_cell_t s_async_cells[LVGL_TASK_ASYNC_QUEUE_LEN];
+static atomic_uint s_async_head;        // 生产者写入位置（多生产者，CAS 竞争）
+static unsigned int s_async_tail;       // 消费者读取位置（仅 LVGL 任务访问）
+
+static void _lvgl_async_init(void)
+{
+    for (unsigned int i = 0; i < LVGL_TASK_ASYNC_QUEUE_LEN; i++) {
+        atomic_init(&s_async_cells[i].seq, i);
+        s_async_cells[i].cb = NULL;
+        s_async_cells[i].arg = NULL;
+    }
+    atomic_init(&s_async_head, 0);
+    s_async_tail = 0;
+}
+
+// 单消费者出队（仅在 LVGL 任务中调用）
+static bool _lvgl_async_pop(lvgl_async_cell_t *out)
+{
+    lvgl_async_cell_t *cell = &s_async_cells[s_async_tail & LVGL_ASYNC_MASK];
+    unsigned int seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+
+    // 槽位尚未被生产者发布
+    if ((int)(seq - (s_async_tail + 1)) < 0) {
+        return false;
+    }
+
+    out->cb = cell->cb;
+    out->arg = cell->arg;
+    atomic_store_explicit(&cell->seq, s_async_tail + LVGL_TASK_ASYNC_QUEUE_LEN, memory_order_release);
+    s_async_tail++;
+    return true;
+}
+
+// 批量取出邮箱中的回调，合并重复项后统一执行（调用方已持有 LVGL 锁）
+static void _lvgl_async_drain(void)
+{
+    lvgl_async_cell_t batch[LVGL_TASK_ASYNC_QUEUE_LEN];
+    lvgl_async_cell_t item;
+    size_t count = 0;
+
+    // 每轮最多取出一个邮箱长度，避免生产者持续投递时饿死渲染
+    while (count < LVGL_TASK_ASYNC_QUEUE_LEN && _lvgl_async_pop(&item)) {
+        bool duplicated = false;
+        for (size_t i = 0; i < count; i++) {
+            if (batch[i].cb == item.cb && batch[i].arg == item.arg) {
+                duplicated = true;
+                break;
+            }
+        }
+        if (!duplicated) {
+            batch[count].cb = item.cb;
+            batch[count].arg = item.arg;
+            count++;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        batch[i].cb(batch[i].arg);
+    }
+}
 
 static portTASK_FUNCTION(lvgl_task_func, arg)
 {
@@ -17,6 +94,8 @@ static portTASK_FUNCTION(lvgl_task_func, arg)
 
     ESP_LOGI(TAG, "lvgl task started");
 
+    lvgl_task_lock(-1);
+
     /* 初始化LVGL */
     lv_init();
 
@@ -29,10 +108,19 @@ static portTASK_FUNCTION(lvgl_task_func, arg)
     /* 创建UI界面 */
     lvgl_ui_create();
 
-    /* 任务主循环 */
+    /* 立即刷新首屏，记录显示就绪时间 */
+    lv_refr_now(NULL);
+    boot_stage_done(BOOT_STAGE_DISPLAY);
+
+    lvgl_task_unlock();
+
+    /* 任务主循环：先合并处理跨任务更新，再统一刷新 */
     TickType_t last_wake = xTaskGetTickCount();
     while (1) {
+        lvgl_task_lock(-1);
+        _lvgl_async_drain();
         lv_timer_handler();
+        lvgl_task_unlock();
         vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(LVGL_TASK_PERIOD_MS));
     }
 }
@@ -47,16 +135,18 @@ esp_err_t lvgl_task_init(void)
         return ESP_OK;
     }
 
-    BaseType_t ret = xTaskCreate(
-        lvgl_task_func,
-        "lvgl_task",
-        LVGL_TASK_STACK_SIZE,
-        NULL,
-        LVGL_TASK_PRIORITY,
-        &s_lvgl_task_handle
-    );
+    if (s_lvgl_mutex == NULL) {
+        s_lvgl_mutex = xSemaphoreCreateRecursiveMutex();
+        if (s_lvgl_mutex == NULL) {
+            ESP_LOGE(TAG, "failed to create LVGL mutex");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    _lvgl_async_init();
 
-    if (ret != pdPASS) {
+    esp_err_t ret = sys_task_create(SYS_TASK_ID_LVGL, lvgl_task_func, NULL, &s_lvgl_task_handle);
+    if (ret != ESP_OK) {
         ESP_LOGE(TAG, "failed to create LVGL task");
         s_lvgl_task_handle = NULL;
         return ESP_ERR_NO_MEM;
@@ -65,3 +155,61 @@ esp_err_t lvgl_task_init(void)
     ESP_LOGI(TAG, "lvgl task initialized");
     return ESP_OK;
 }
+
+bool lvgl_task_lock(int timeout_ms)
+{
+    if (s_lvgl_mutex == NULL) {
+        return false;
+    }
+
+    TickType_t ticks = (timeout_ms < 0) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    return xSemaphoreTakeRecursive(s_lvgl_mutex, ticks) == pdTRUE;
+}
+
+void lvgl_task_unlock(void)
+{
+    if (s_lvgl_mutex == NULL) {
+        return;
+    }
+
+    xSemaphoreGiveRecursive(s_lvgl_mutex);
+}
+
+esp_err_t lvgl_task_async_call(lvgl_task_async_cb_t cb, void *arg)
+{
+    if (cb == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (s_lvgl_task_handle == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    lvgl_async_cell_t *cell;
+    unsigned int pos = atomic_load_explicit(&s_async_head, memory_order_relaxed);
+
+    while (1) {
+        cell = &s_async_cells[pos & LVGL_ASYNC_MASK];
+        unsigned int seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        int diff = (int)(seq - pos);
+
+        if (diff == 0) {
+            // 槽位空闲，尝试占位
+            if (atomic_compare_exchange_weak_explicit(&s_async_head, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // 邮箱已满（LVGL 任务来不及消费）
+            return ESP_ERR_NO_MEM;
+        } else {
+            // 被其他生产者抢先，重新读取写入位置
+            pos = atomic_load_explicit(&s_async_head, memory_order_relaxed);
+        }
+    }
+
+    cell->cb = cb;
+    cell->arg = arg;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    return ESP_OK;
+}
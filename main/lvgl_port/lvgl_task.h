@@ -2,16 +2,48 @@
 #define __LVGL_TASK_H__
 
 #include "esp_err.h"
+#include <stdbool.h>
 
-/* LVGL任务配置 */
-#define LVGL_TASK_STACK_SIZE    (8192)
-#define LVGL_TASK_PRIORITY      (5)
+/* LVGL任务配置（核心/优先级/栈大小见 sys_task_config.h） */
 #define LVGL_TASK_PERIOD_MS     (10)
 
+/* 跨任务异步调用邮箱配置（长度必须为 2 的幂） */
+#define LVGL_TASK_ASYNC_QUEUE_LEN   (32)
+
+/**
+ * @brief 在 LVGL 任务上下文中执行的异步回调
+ * @param arg 投递时传入的用户参数
+ */
+typedef void (*lvgl_task_async_cb_t)(void *arg);
+
 /**
  * @brief 初始化并启动LVGL任务
  * @return ESP_OK 成功，其他值表示失败
  */
 esp_err_t lvgl_task_init(void);
 
+/**
+ * @brief 获取 LVGL 递归锁（可在同一任务内嵌套调用）
+ * @param timeout_ms 超时时间（毫秒），小于 0 表示永久等待
+ * @return true 获取成功，false 超时或 LVGL 任务未初始化
+ */
+bool lvgl_task_lock(int timeout_ms);
+
+/**
+ * @brief 释放 LVGL 递归锁（与 lvgl_task_lock 成对调用）
+ */
+void lvgl_task_unlock(void);
+
+/**
+ * @brief 投递一个在 LVGL 任务中执行的回调（无锁，不阻塞，可在任意任务中调用）
+ *
+ * 回调在下一次 lv_timer_handler() 之前批量执行，同一批次内相同的 cb/arg 只执行一次，
+ * 因此回调应读取最新状态而不是依赖投递次数，多次更新会合并为一次刷新。
+ *
+ * @param cb 回调函数
+ * @param arg 用户参数
+ * @return ESP_OK 成功，ESP_ERR_INVALID_ARG 参数无效，ESP_ERR_NO_MEM 邮箱已满
+ */
+esp_err_t lvgl_task_async_call(lvgl_task_async_cb_t cb, void *arg);
+
 #endif // __LVGL_TASK_H__
@@ -1,10 +1,14 @@
 #include "lvgl_ui.h"
+#include "lvgl_task.h"
+#include "boot.h"
 #include "esp_timer.h"
 #include "esp_log.h"
 #include "esp_err.h"
 #include "lvgl.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <stdatomic.h>
+#include <string.h>
 
 static const char *TAG = "lvgl_ui";
 
@@ -28,6 +32,25 @@ static lv_obj_t *s_title_label = NULL;
 static lv_timer_t *s_arc_timer = NULL;
 static int32_t s_arc_value = 0;
 
+/* 相机画面相关变量 */
+static lv_obj_t *s_cam_img = NULL;
+static lv_obj_t *s_cam_status_label = NULL;
+static lv_img_dsc_t s_cam_dsc;                              // 数据指针直接指向当前显示帧
+static _Atomic(const uint16_t *) s_cam_pending = NULL;      // 待显示帧（跨任务交接）
+static lvgl_ui_frame_release_cb_t s_cam_release_cb = NULL;
+static uint32_t s_cam_frame_cnt = 0;
+static bool s_cam_status_visible = true;                    // 状态叠加层开关（敲击切换）
+static bool s_cam_started = false;                          // 已收到第一帧（含直通输出）
+static atomic_uint s_cam_direct_cnt = 0;                    // 直通输出的帧数（跨任务累计）
+static lv_area_t s_cam_dirty;                               // 区域更新待重绘范围（图像坐标，受 LVGL 锁保护）
+static bool s_cam_dirty_valid = false;
+
+/* 操作提示 */
+#define LVGL_UI_TOAST_MS        (800)
+static lv_obj_t *s_toast_label = NULL;
+static lv_timer_t *s_toast_timer = NULL;
+static _Atomic int s_action_pending = LVGL_UI_ACTION_NONE;
+
 /**
  * @brief LVGL时钟回调函数
  */
@@ -102,6 +125,273 @@ static void arc_timer_cb(lv_timer_t *timer)
     }
 }
 
+/**
+ * @brief 创建相机画面（最底层）及状态叠加层
+ */
+static void lvgl_ui_camera_create(void)
+{
+    s_cam_dsc.header.always_zero = 0;
+    s_cam_dsc.header.w = LVGL_UI_CAMERA_WIDTH;
+    s_cam_dsc.header.h = LVGL_UI_CAMERA_HEIGHT;
+    s_cam_dsc.header.cf = LV_IMG_CF_TRUE_COLOR;
+    s_cam_dsc.data_size = LVGL_UI_CAMERA_WIDTH * LVGL_UI_CAMERA_HEIGHT * LV_COLOR_SIZE / 8;
+    s_cam_dsc.data = NULL;
+
+    /* 收到第一帧前隐藏，避免绘制空指针 */
+    s_cam_img = lv_img_create(lv_scr_act());
+    lv_img_set_src(s_cam_img, &s_cam_dsc);
+    lv_obj_align(s_cam_img, LV_ALIGN_CENTER, 0, 0);
+    lv_obj_add_flag(s_cam_img, LV_OBJ_FLAG_HIDDEN);
+
+    /* 状态叠加层（由 LVGL 与画面合成） */
+    s_cam_status_label = lv_label_create(lv_scr_act());
+    lv_label_set_text(s_cam_status_label, "");
+    lv_obj_set_style_text_color(s_cam_status_label, lv_color_hex(0xFFFFFF), LV_PART_MAIN);
+    lv_obj_set_style_text_font(s_cam_status_label, &lv_font_montserrat_14, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(s_cam_status_label, lv_color_hex(0x000000), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(s_cam_status_label, LV_OPA_50, LV_PART_MAIN);
+    lv_obj_align(s_cam_status_label, LV_ALIGN_TOP_RIGHT, -4, 4);
+    lv_obj_add_flag(s_cam_status_label, LV_OBJ_FLAG_HIDDEN);
+
+    s_toast_label = lv_label_create(lv_scr_act());
+    lv_label_set_text(s_toast_label, "");
+    lv_obj_set_style_text_color(s_toast_label, lv_color_hex(0xFFFFFF), LV_PART_MAIN);
+    lv_obj_set_style_text_font(s_toast_label, &lv_font_montserrat_14, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(s_toast_label, LV_OPA_70, LV_PART_MAIN);
+    lv_obj_set_style_pad_all(s_toast_label, 6, LV_PART_MAIN);
+    lv_obj_align(s_toast_label, LV_ALIGN_BOTTOM_MID, 0, -12);
+    lv_obj_add_flag(s_toast_label, LV_OBJ_FLAG_HIDDEN);
+}
+
+/**
+ * @brief 第一帧到来：收起加载界面，按开关显示状态叠加层
+ */
+static void lvgl_ui_camera_started(void)
+{
+    if (s_cam_started) return;
+    s_cam_started = true;
+
+    if (s_cam_status_visible) {
+        lv_obj_clear_flag(s_cam_status_label, LV_OBJ_FLAG_HIDDEN);
+    }
+    if (s_arc_timer) {
+        lv_timer_del(s_arc_timer);
+        s_arc_timer = NULL;
+    }
+    if (s_arc) lv_obj_add_flag(s_arc, LV_OBJ_FLAG_HIDDEN);
+    if (s_title_label) lv_obj_add_flag(s_title_label, LV_OBJ_FLAG_HIDDEN);
+    /* 本轮 lv_timer_handler 即刷新上屏 */
+    boot_stage_done(BOOT_STAGE_FIRST_FRAME);
+}
+
+/**
+ * @brief 在 LVGL 任务中交换相机帧指针（由 lvgl_task_async_call 调度）
+ */
+static void lvgl_ui_camera_swap_cb(void *arg)
+{
+    (void)arg;
+
+    const uint16_t *frame = atomic_exchange(&s_cam_pending, NULL);
+    if (frame == NULL || s_cam_img == NULL) return;
+
+    const uint16_t *prev = (const uint16_t *)s_cam_dsc.data;
+    s_cam_dsc.data = (const uint8_t *)frame;
+
+    /* 数据指针变化后旧的解码缓存失效，只重绘相机控件区域 */
+    lv_img_cache_invalidate_src(&s_cam_dsc);
+    lv_obj_invalidate(s_cam_img);
+
+    if (prev == NULL) {
+        /* 第一帧：显示画面，收起加载界面 */
+        lv_obj_clear_flag(s_cam_img, LV_OBJ_FLAG_HIDDEN);
+        lvgl_ui_camera_started();
+    }
+
+    s_cam_frame_cnt++;
+    lv_label_set_text_fmt(s_cam_status_label, "#%lu", (unsigned long)s_cam_frame_cnt);
+
+    /* 旧帧已不再被引用（渲染在 lv_timer_handler 内同步完成），归还给生产者 */
+    if (prev != NULL && s_cam_release_cb) {
+        s_cam_release_cb(prev);
+    }
+}
+
+/**
+ * @brief 在 LVGL 任务中处理直通输出的帧（由 lvgl_task_async_call 调度）
+ */
+static void lvgl_ui_camera_direct_cb(void *arg)
+{
+    (void)arg;
+
+    unsigned n = atomic_exchange(&s_cam_direct_cnt, 0);
+    if (n == 0 || s_cam_status_label == NULL) return;
+
+    /* 相机控件保持隐藏，屏幕背景由直通画面覆盖 */
+    lvgl_ui_camera_started();
+    s_cam_frame_cnt += n;
+    lv_label_set_text_fmt(s_cam_status_label, "#%lu", (unsigned long)s_cam_frame_cnt);
+}
+
+void lvgl_ui_camera_set_release_cb(lvgl_ui_frame_release_cb_t cb)
+{
+    s_cam_release_cb = cb;
+}
+
+void lvgl_ui_camera_update(const uint16_t *frame)
+{
+    if (frame == NULL) return;
+
+    /* 上一帧还没来得及显示就被新帧替换，直接归还 */
+    const uint16_t *superseded = atomic_exchange(&s_cam_pending, frame);
+    if (superseded != NULL && s_cam_release_cb) {
+        s_cam_release_cb(superseded);
+    }
+
+    /* 邮箱满时待显示帧保留在 s_cam_pending，由下一次调度处理 */
+    lvgl_task_async_call(lvgl_ui_camera_swap_cb, NULL);
+}
+
+uint32_t lvgl_ui_camera_frame_count(void)
+{
+    return s_cam_frame_cnt;     // 只在 LVGL 任务中写入，32 位读取不会撕裂
+}
+
+/**
+ * @brief 在 LVGL 任务中重绘区域更新覆盖的范围（由 lvgl_task_async_call 调度，多次更新合并为一次）
+ */
+static void lvgl_ui_camera_dirty_cb(void *arg)
+{
+    (void)arg;
+
+    if (!s_cam_dirty_valid || s_cam_img == NULL) return;
+    s_cam_dirty_valid = false;
+
+    /* 图像坐标换算为屏幕坐标 */
+    lv_area_t coords;
+    lv_obj_get_coords(s_cam_img, &coords);
+    lv_area_t area = s_cam_dirty;
+    lv_area_move(&area, coords.x1, coords.y1);
+    lv_obj_invalidate_area(s_cam_img, &area);
+}
+
+/**
+ * @brief 把若干行像素写入一帧（帧宽 LVGL_UI_CAMERA_WIDTH）
+ */
+static void lvgl_ui_camera_blit(const uint16_t *frame, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                                const uint16_t *pixels)
+{
+    uint16_t *dst = (uint16_t *)frame + (size_t)y * LVGL_UI_CAMERA_WIDTH + x;
+    for (uint16_t row = 0; row < h; row++) {
+        memcpy(dst, pixels, (size_t)w * sizeof(uint16_t));
+        dst += LVGL_UI_CAMERA_WIDTH;
+        pixels += w;
+    }
+}
+
+void lvgl_ui_camera_patch(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *pixels)
+{
+    if (pixels == NULL || w == 0 || h == 0 ||
+        (uint32_t)x + w > LVGL_UI_CAMERA_WIDTH || (uint32_t)y + h > LVGL_UI_CAMERA_HEIGHT) {
+        return;
+    }
+
+    /* 持锁期间 LVGL 不渲染、不交换帧，可以直接改写显示中的帧 */
+    if (!lvgl_task_lock(-1)) return;
+
+    const uint16_t *shown = (const uint16_t *)s_cam_dsc.data;
+    const uint16_t *pending = atomic_load(&s_cam_pending);
+
+    /* 待显示帧先于本区域到达，交换上屏后同样要包含本区域 */
+    if (pending != NULL) {
+        lvgl_ui_camera_blit(pending, x, y, w, h, pixels);
+    }
+    if (shown != NULL && shown != pending) {
+        lvgl_ui_camera_blit(shown, x, y, w, h, pixels);
+
+        lv_area_t area = { .x1 = x, .y1 = y, .x2 = x + w - 1, .y2 = y + h - 1 };
+        if (s_cam_dirty_valid) {
+            _lv_area_join(&s_cam_dirty, &s_cam_dirty, &area);
+        } else {
+            s_cam_dirty = area;
+            s_cam_dirty_valid = true;
+        }
+    }
+    bool dirty = s_cam_dirty_valid;
+
+    lvgl_task_unlock();
+
+    /* 邮箱满时范围保留，由下一次区域更新或帧交换一并重绘 */
+    if (dirty) {
+        lvgl_task_async_call(lvgl_ui_camera_dirty_cb, NULL);
+    }
+}
+
+void lvgl_ui_camera_direct_frame(void)
+{
+    atomic_fetch_add(&s_cam_direct_cnt, 1);
+    lvgl_task_async_call(lvgl_ui_camera_direct_cb, NULL);
+}
+
+static void lvgl_ui_toast_timer_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    lv_obj_add_flag(s_toast_label, LV_OBJ_FLAG_HIDDEN);
+    s_toast_timer = NULL;   // 单次定时器，回调返回后自动删除
+}
+
+static void lvgl_ui_toast_show(const char *text, uint32_t bg_color)
+{
+    lv_label_set_text(s_toast_label, text);
+    lv_obj_set_style_bg_color(s_toast_label, lv_color_hex(bg_color), LV_PART_MAIN);
+    lv_obj_clear_flag(s_toast_label, LV_OBJ_FLAG_HIDDEN);
+
+    if (s_toast_timer) {
+        lv_timer_reset(s_toast_timer);
+    } else {
+        s_toast_timer = lv_timer_create(lvgl_ui_toast_timer_cb, LVGL_UI_TOAST_MS, NULL);
+        lv_timer_set_repeat_count(s_toast_timer, 1);
+    }
+}
+
+/**
+ * @brief 在 LVGL 任务中执行界面操作（由 lvgl_task_async_call 调度）
+ */
+static void lvgl_ui_action_cb(void *arg)
+{
+    (void)arg;
+
+    int action = atomic_exchange(&s_action_pending, LVGL_UI_ACTION_NONE);
+    if (s_cam_status_label == NULL || s_toast_label == NULL) return;
+
+    switch (action) {
+    case LVGL_UI_ACTION_TOGGLE_STATUS:
+        s_cam_status_visible = !s_cam_status_visible;
+        /* 第一帧到来前叠加层保持隐藏，由帧交换回调按开关显示 */
+        if (!s_cam_status_visible) {
+            lv_obj_add_flag(s_cam_status_label, LV_OBJ_FLAG_HIDDEN);
+        } else if (s_cam_started) {
+            lv_obj_clear_flag(s_cam_status_label, LV_OBJ_FLAG_HIDDEN);
+        }
+        break;
+    case LVGL_UI_ACTION_CONFIRM:
+        lvgl_ui_toast_show(LV_SYMBOL_OK, 0x2E7D32);
+        break;
+    case LVGL_UI_ACTION_DISMISS:
+        lvgl_ui_toast_show(LV_SYMBOL_CLOSE, 0xC62828);
+        break;
+    default:
+        break;
+    }
+}
+
+void lvgl_ui_post_action(lvgl_ui_action_t action)
+{
+    if (action == LVGL_UI_ACTION_NONE) return;
+
+    atomic_store(&s_action_pending, (int)action);
+    lvgl_task_async_call(lvgl_ui_action_cb, NULL);
+}
+
 /**
  * @brief 创建UI界面
  */
@@ -109,6 +399,9 @@ void lvgl_ui_create(void)
 {
     /* 设置屏幕背景色为粉红色 */
     lv_obj_set_style_bg_color(lv_scr_act(), lv_color_hex(0xFFB6C1), LV_PART_MAIN);
+
+    /* 0. 相机画面放在最底层，其余控件作为叠加层 */
+    lvgl_ui_camera_create();
     
     /* 1. 创建标题文字 - 中间靠上 */
     s_title_label = lv_label_create(lv_scr_act());
@@ -3,6 +3,17 @@
 
 #include "lvgl.h"
 #include "esp_err.h"
+#include <stdint.h>
+
+/* 相机画面配置（与 MQTT 图像帧尺寸一致） */
+#define LVGL_UI_CAMERA_WIDTH    240
+#define LVGL_UI_CAMERA_HEIGHT   240
+
+/**
+ * @brief 相机帧归还回调（帧被新帧替换、不再被 LVGL 引用时调用）
+ * @param frame 帧数据指针
+ */
+typedef void (*lvgl_ui_frame_release_cb_t)(const uint16_t *frame);
 
 /**
  * @brief 配置LVGL时钟（定时器）
@@ -18,4 +29,63 @@ void lvgl_ui_create(void);
 
 void test_ui_create(void);
 
+/**
+ * @brief 设置相机帧归还回调（需在第一帧到来前设置）
+ * @param cb 归还回调
+ */
+void lvgl_ui_camera_set_release_cb(lvgl_ui_frame_release_cb_t cb);
+
+/**
+ * @brief 提交一帧相机画面（可在任意任务中调用，不拷贝数据）
+ *
+ * 帧数据需为 LVGL 颜色格式（RGB565，LV_COLOR_16_SWAP 字节序），在归还回调之前必须保持有效。
+ * LVGL 任务中只交换 lv_img_dsc_t 的数据指针并仅重绘相机控件，叠加层由 LVGL 合成。
+ *
+ * @param frame 帧数据指针（LVGL_UI_CAMERA_WIDTH x LVGL_UI_CAMERA_HEIGHT）
+ */
+void lvgl_ui_camera_update(const uint16_t *frame);
+
+/**
+ * @brief 把区域更新写入相机画面（在调用 lvgl_ui_camera_update 的同一任务中调用）
+ *
+ * 持 LVGL 锁把像素写入显示中的帧与尚未交换的待显示帧，随后由 LVGL 任务只重绘该区域，
+ * 叠加层照常合成，之后的重绘也不会回退到旧画面。第一帧到来前的区域更新被忽略。
+ *
+ * @param x 起始列
+ * @param y 起始行
+ * @param w 宽度（像素）
+ * @param h 行数
+ * @param pixels 像素（w*h，格式同相机帧，返回后可复用）
+ */
+void lvgl_ui_camera_patch(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *pixels);
+
+/**
+ * @brief 获取累计显示的相机帧数（可在任意任务中调用）
+ */
+uint32_t lvgl_ui_camera_frame_count(void);
+
+/**
+ * @brief 通知一帧相机画面已由外部直接输出到屏幕（直通模式，可在任意任务中调用）
+ *
+ * 直通模式下画面不经过 LVGL，相机控件保持隐藏；此调用只收起加载界面并更新帧计数。
+ * 叠加层仍由 LVGL 绘制，其区域在下一帧画面输出时被覆盖，直到 LVGL 再次刷新该区域。
+ */
+void lvgl_ui_camera_direct_frame(void);
+
+/**
+ * @brief 界面操作（由动作检测等输入源触发）
+ */
+typedef enum {
+    LVGL_UI_ACTION_NONE = 0,
+    LVGL_UI_ACTION_TOGGLE_STATUS,   // 显示/隐藏相机状态叠加层
+    LVGL_UI_ACTION_CONFIRM,         // 确认提示
+    LVGL_UI_ACTION_DISMISS,         // 取消提示
+} lvgl_ui_action_t;
+
+/**
+ * @brief 投递界面操作（可在任意任务中调用，不阻塞；未处理时新操作覆盖旧操作）
+ * @param action 操作
+ */
+void lvgl_ui_post_action(lvgl_ui_action_t action);
+
 #endif // __LVGL_UI_H__
@@ -1,44 +1,172 @@
 #include <stdio.h>
 #include <string.h>
 #include "esp_log.h"
+#include "esp_event.h"
+#include "esp_netif.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "nvs_storage.h"
 #include "wifi.h"
 #include "mymqtt.h"
+#include "sys_task.h"
+#include "lvgl_task.h"
+#include "lvgl_ui.h"
+#include "boot.h"
+#include "mpu6050_task.h"
+#include "mpu6050_trace.h"
+#include "telemetry.h"
+#include "pose.h"
+#include "gesture.h"
 #include "st7789.h"
 
 static const char *TAG = "main";
 
-// 图像帧接收完成回调
+#define BOOT_MQTT_TIMEOUT_MS        (15000)     // 等待 MQTT 连接超时
+#define BOOT_FIRST_FRAME_TIMEOUT_MS (10000)     // 连接后等待第一帧超时
+#define IMU_TRACE_MQTT_SAMPLES      (0)         // >0 时启动后经 MQTT 流式录制该数量的 IMU 采样（复现运动场景用）
+#define IMG_DIRECT_PANEL            (0)         // 1=图像分块直通屏幕（不经 LVGL 合成，需约 225KB 内部 DMA 内存）
+
+// 图像帧接收完成回调：帧指针直接交给 LVGL 相机控件，替换下来的旧帧归还给 mymqtt
 static void _image_cb(const uint16_t *image_data)
 {
-    ESP_LOGI(TAG, "绘制图像");
-    st7789_draw_image(image_data);
+    lvgl_ui_camera_update(image_data);
+}
+
+#if MYMQTT_ROI_ENABLE
+// 区域更新：直通模式下收齐的行直接按窗口写屏；LVGL 模式下写入显示中的相机帧，由 LVGL 重绘该区域
+static void _roi_cb(const mymqtt_roi_t *roi)
+{
+#if IMG_DIRECT_PANEL
+    st7789_draw_area(roi->x, roi->y, roi->x + roi->w - 1, roi->y + roi->h - 1, roi->pixels);
+#else
+    lvgl_ui_camera_patch(roi->x, roi->y, roi->w, roi->h, roi->pixels);
+#endif
+}
+#endif
+
+#if IMG_DIRECT_PANEL
+// 画面传输完成（在下一次访问屏幕的任务中调用）：归还分块帧
+static void _frame_done_cb(void *arg)
+{
+    mymqtt_frame_release(arg);
+}
+
+// 分块帧接收完成回调：块描述表直接交给屏幕驱动排队 DMA，不拷贝像素
+static void _frame_cb(const mymqtt_img_frame_t *frame)
+{
+    esp_err_t err = st7789_draw_chunks(0, 0, ST7789_WIDTH - 1, ST7789_HEIGHT - 1,
+                                       frame->chunks, frame->count,
+                                       _frame_done_cb, (void *)frame);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "直通输出失败: %s", esp_err_to_name(err));
+        mymqtt_frame_release(frame);
+        return;
+    }
+    lvgl_ui_camera_direct_frame();
+}
+#endif
+
+#if IMU_TRACE_MQTT_SAMPLES > 0
+// 轨迹分片输出：QoS 1 保证分片不丢，主机按接收顺序拼接
+static void _imu_trace_sink(const void *data, size_t len)
+{
+    mymqtt_publish(MYMQTT_TOPIC_IMU_TRACE, data, len, 1);
+}
+#endif
+
+// 动作事件：敲击切换状态叠加层，点头/摇头给出确认/取消提示（转投 LVGL 任务，不阻塞消费者）
+static void _gesture_cb(const gesture_event_t *event)
+{
+    switch (event->type) {
+    case GESTURE_TAP:
+        lvgl_ui_post_action(LVGL_UI_ACTION_TOGGLE_STATUS);
+        break;
+    case GESTURE_NOD:
+        lvgl_ui_post_action(LVGL_UI_ACTION_CONFIRM);
+        break;
+    case GESTURE_SHAKE:
+        lvgl_ui_post_action(LVGL_UI_ACTION_DISMISS);
+        break;
+    default:
+        break;
+    }
+}
+
+// 获取 IP：记录启动时间线
+static void _got_ip_handler(void *arg, esp_event_base_t base, int32_t event_id, void *event_data)
+{
+    (void)arg;
+    (void)base;
+    (void)event_id;
+    (void)event_data;
+
+    boot_stage_done(BOOT_STAGE_WIFI);
 }
 
 void app_main(void)
 {
+    ESP_ERROR_CHECK(boot_init());
     ESP_LOGI(TAG, "应用启动");
-    
-    // 初始化 ST7789
-    ESP_ERROR_CHECK(st7789_init());
-    st7789_fill_screen(0xFFFF);  // 清屏
 
+    // NVS 是 WiFi 凭证的前置依赖，最先完成
+    ESP_ERROR_CHECK(nvs_storage_init());
+    boot_stage_done(BOOT_STAGE_NVS);
 
+    // 显示初始化在渲染核上进行，与下面的网络启动并行
+    lvgl_ui_camera_set_release_cb(mymqtt_image_release);
+    ESP_ERROR_CHECK(lvgl_task_init());
 
-    // 启动 WiFi
+    // 提前创建事件循环，保证在 WiFi 启动前注册好 IP 事件（wifi_start 内部重复创建会被忽略）
+    ESP_ERROR_CHECK(esp_netif_init());
+    esp_err_t err = esp_event_loop_create_default();
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_ERROR_CHECK(err);
+    }
+    ESP_ERROR_CHECK(esp_event_handler_register(IP_EVENT, IP_EVENT_STA_GOT_IP, _got_ip_handler, NULL));
+
+    // MQTT 客户端先就绪（分配帧缓冲），获取 IP 后由事件立即启动连接，无需轮询等待
+#if IMG_DIRECT_PANEL
+    ESP_ERROR_CHECK(mymqtt_set_frame_cb(_frame_cb));
+#endif
+#if MYMQTT_ROI_ENABLE
+    ESP_ERROR_CHECK(mymqtt_set_roi_cb(_roi_cb));
+#endif
+    ESP_ERROR_CHECK(mymqtt_init(_image_cb));
+
+    // 启动 WiFi（非阻塞）
     ESP_ERROR_CHECK(wifi_start());
 
-    // 等待 WiFi 连接
-    while (wifi_get_state() != WIFI_STATE_CONNECTED) {
-        vTaskDelay(pdMS_TO_TICKS(100));
+    // 姿态采集与批量遥测立即开始，不等网络（未连接期间发布失败只计数；传感器异常不影响图像显示）
+    if (mpu6050_task_init() == ESP_OK) {
+        pose_start();
+        telemetry_start();
+        gesture_set_event_cb(_gesture_cb);
+        gesture_start();
+#if IMU_TRACE_MQTT_SAMPLES > 0
+        mpu6050_trace_record_start(IMU_TRACE_MQTT_SAMPLES, _imu_trace_sink);
+#endif
+    } else {
+        ESP_LOGW(TAG, "MPU6050 不可用，跳过遥测");
     }
 
-    vTaskDelay(pdMS_TO_TICKS(3000));
-    // 初始化 MQTT（传入图像回调）
-    ESP_ERROR_CHECK(mymqtt_init(_image_cb));
+    if (mymqtt_wait_connected(BOOT_MQTT_TIMEOUT_MS) == ESP_OK) {
+        boot_stage_done(BOOT_STAGE_MQTT);
+        ESP_LOGI(TAG, "等待图像数据...");
+        boot_wait(BOOT_STAGE_BIT(BOOT_STAGE_FIRST_FRAME), BOOT_FIRST_FRAME_TIMEOUT_MS);
+    } else {
+        ESP_LOGW(TAG, "MQTT 连接超时，后台继续重连");
+    }
+    boot_timeline_dump();
+
+#if MYMQTT_FEEDBACK_ENABLE
+    // 图像接收反馈：发布端据此把帧率调到设备能持续显示的上限
+    if (mymqtt_feedback_start(lvgl_ui_camera_frame_count) != ESP_OK) {
+        ESP_LOGW(TAG, "图像反馈启动失败");
+    }
+#endif
 
-    ESP_LOGI(TAG, "等待图像数据...");
+    // 周期输出各任务 CPU 占用与核心分布
+    sys_task_stats_start();
 
     while(1) {
         vTaskDelay(pdMS_TO_TICKS(1000));
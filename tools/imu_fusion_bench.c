@@ -0,0 +1,338 @@
+/*
+ * imu_fusion 主机基准测试：比较互补滤波与 Madgwick 的精度、单步耗时与单步时延分布，
+ * 并测量原始值换算为物理量的吞吐。
+ *
+ * 编译（在仓库根目录）：
+ *   gcc -O2 -Wall -Icomponents/imu_fusion/include -Icomponents/mpu6050/include \
+ *       tools/imu_fusion_bench.c components/imu_fusion/imu_fusion.c -lm -o imu_fusion_bench
+ *
+ * 用法：
+ *   ./imu_fusion_bench                          合成轨迹（已知真值，输出角度误差）
+ *   ./imu_fusion_bench trace.imut [rate_hz]     回放设备录制的二进制轨迹（mpu6050_trace_format.h）
+ *   ./imu_fusion_bench trace.csv [rate_hz]      回放 CSV 轨迹
+ *
+ * 二进制轨迹自带量程、零偏与采样率，rate_hz 省略时取头部记录值。经 MQTT 流式录制的轨迹
+ * 按接收顺序拼接各条消息即为完整文件。
+ *
+ * CSV 每行一个采样，原始 int16 值（±2g / ±250°/s 量程，陀螺仪已去零偏）：
+ *   t_us,ax,ay,az,gx,gy,gz
+ * 以 '#' 开头的行忽略。rate_hz 缺省为 500。
+ */
+
+#include "imu_fusion.h"
+#include "mpu6050_trace_format.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ACCEL_LSB_PER_G     16384.0f
+#define GYRO_LSB_PER_DPS    131.0f
+#define DEG_TO_RAD          0.01745329252f
+#define SYNTH_RATE_HZ       500.0f
+#define SYNTH_SECONDS       60
+#define BENCH_REPEAT        20
+#define LATENCY_PCT_HI      0.99
+
+typedef struct {
+    float ax, ay, az;       // g
+    float gx, gy, gz;       // rad/s
+    float yaw, pitch, roll; // 真值（度），录制轨迹无真值
+} bench_sample_t;
+
+static bench_sample_t *s_samples = NULL;
+static size_t s_count = 0;
+static int s_has_truth = 0;
+
+// 二进制轨迹的原始记录与换算参数（换算吞吐测试用）
+static mpu6050_trace_record_t *s_records = NULL;
+static float s_gyro_sens = GYRO_LSB_PER_DPS;
+static float s_accel_sens = ACCEL_LSB_PER_G;
+static int16_t s_gyro_bias[3] = {0};
+static float s_trace_rate_hz = 0.0f;
+
+static double _now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static float _noise(float amp)
+{
+    return amp * ((float)rand() / (float)RAND_MAX * 2.0f - 1.0f);
+}
+
+static float _angle_diff(float a, float b)
+{
+    float d = fmodf(a - b + 540.0f, 360.0f) - 180.0f;
+    return d;
+}
+
+// 合成轨迹：头部左右摆动 + 上下点头，叠加噪声与小幅陀螺零偏
+static void _make_synthetic(void)
+{
+    const float dt = 1.0f / SYNTH_RATE_HZ;
+    s_count = (size_t)(SYNTH_RATE_HZ * SYNTH_SECONDS);
+    s_samples = calloc(s_count, sizeof(bench_sample_t));
+    s_has_truth = 1;
+
+    for (size_t i = 0; i < s_count; i++) {
+        float t = i * dt;
+        // 欧拉角真值（度）及其导数
+        float yaw = 40.0f * sinf(2.0f * (float)M_PI * 0.3f * t);
+        float pitch = 25.0f * sinf(2.0f * (float)M_PI * 0.5f * t);
+        float roll = 5.0f * sinf(2.0f * (float)M_PI * 0.2f * t);
+        float dyaw = 40.0f * 2.0f * (float)M_PI * 0.3f * cosf(2.0f * (float)M_PI * 0.3f * t) * DEG_TO_RAD;
+        float dpitch = 25.0f * 2.0f * (float)M_PI * 0.5f * cosf(2.0f * (float)M_PI * 0.5f * t) * DEG_TO_RAD;
+        float droll = 5.0f * 2.0f * (float)M_PI * 0.2f * cosf(2.0f * (float)M_PI * 0.2f * t) * DEG_TO_RAD;
+
+        float r = roll * DEG_TO_RAD, p = pitch * DEG_TO_RAD;
+        float sr = sinf(r), cr = cosf(r), sp = sinf(p), cp = cosf(p);
+
+        // ZYX 欧拉角速率 -> 机体角速度
+        bench_sample_t *s = &s_samples[i];
+        s->gx = droll - sp * dyaw + _noise(0.01f) + 0.002f;
+        s->gy = cr * dpitch + sr * cp * dyaw + _noise(0.01f) - 0.001f;
+        s->gz = -sr * dpitch + cr * cp * dyaw + _noise(0.01f);
+
+        // 世界系重力 (0,0,1) 在机体系下的方向
+        s->ax = -sp + _noise(0.02f);
+        s->ay = sr * cp + _noise(0.02f);
+        s->az = cr * cp + _noise(0.02f);
+
+        s->yaw = yaw;
+        s->pitch = pitch;
+        s->roll = roll;
+    }
+}
+
+static int _load_csv(const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    size_t cap = 4096;
+    char line[256];
+    s_samples = malloc(cap * sizeof(bench_sample_t));
+
+    while (fgets(line, sizeof(line), fp)) {
+        long long t;
+        int ax, ay, az, gx, gy, gz;
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%lld,%d,%d,%d,%d,%d,%d", &t, &ax, &ay, &az, &gx, &gy, &gz) != 7) continue;
+
+        if (s_count == cap) {
+            cap *= 2;
+            s_samples = realloc(s_samples, cap * sizeof(bench_sample_t));
+        }
+        bench_sample_t *s = &s_samples[s_count++];
+        s->ax = ax / ACCEL_LSB_PER_G;
+        s->ay = ay / ACCEL_LSB_PER_G;
+        s->az = az / ACCEL_LSB_PER_G;
+        s->gx = gx / GYRO_LSB_PER_DPS * DEG_TO_RAD;
+        s->gy = gy / GYRO_LSB_PER_DPS * DEG_TO_RAD;
+        s->gz = gz / GYRO_LSB_PER_DPS * DEG_TO_RAD;
+    }
+
+    fclose(fp);
+    return s_count > 0 ? 0 : -1;
+}
+
+// 与设备端批量换算相同的算术：预计算倒数系数，循环内只有减零偏与乘法
+static void _convert_records(const mpu6050_trace_record_t *rec, size_t count, bench_sample_t *out)
+{
+    const float ka = 1.0f / s_accel_sens;
+    const float kg = DEG_TO_RAD / s_gyro_sens;
+
+    for (size_t i = 0; i < count; i++) {
+        out[i].ax = rec[i].accel[0] * ka;
+        out[i].ay = rec[i].accel[1] * ka;
+        out[i].az = rec[i].accel[2] * ka;
+        out[i].gx = (rec[i].gyro[0] - s_gyro_bias[0]) * kg;
+        out[i].gy = (rec[i].gyro[1] - s_gyro_bias[1]) * kg;
+        out[i].gz = (rec[i].gyro[2] - s_gyro_bias[2]) * kg;
+    }
+}
+
+static int _load_trace(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    mpu6050_trace_header_t h;
+    if (fread(&h, sizeof(h), 1, fp) != 1 || h.magic != MPU6050_TRACE_MAGIC) {
+        fclose(fp);
+        return 1;   // 不是二进制轨迹，交给 CSV 解析
+    }
+
+    if (h.version != MPU6050_TRACE_VERSION || h.header_bytes < sizeof(h) ||
+        h.record_bytes < sizeof(mpu6050_trace_record_t) ||
+        h.gyro_sensitivity <= 0.0f || h.accel_sensitivity <= 0.0f) {
+        fprintf(stderr, "不支持的轨迹版本或头部无效\n");
+        fclose(fp);
+        return -1;
+    }
+    fseek(fp, h.header_bytes, SEEK_SET);
+
+    size_t cap = h.sample_count ? h.sample_count : 4096;
+    unsigned char rec_buf[256];
+    s_records = malloc(cap * sizeof(mpu6050_trace_record_t));
+
+    while (h.record_bytes <= sizeof(rec_buf) && fread(rec_buf, h.record_bytes, 1, fp) == 1) {
+        if (h.sample_count && s_count == h.sample_count) break;
+        if (s_count == cap) {
+            cap *= 2;
+            s_records = realloc(s_records, cap * sizeof(mpu6050_trace_record_t));
+        }
+        memcpy(&s_records[s_count++], rec_buf, sizeof(mpu6050_trace_record_t));
+    }
+    fclose(fp);
+
+    s_gyro_sens = h.gyro_sensitivity;
+    s_accel_sens = h.accel_sensitivity;
+    if (h.flags & MPU6050_TRACE_FLAG_BIAS_VALID) {
+        memcpy(s_gyro_bias, h.gyro_bias, sizeof(s_gyro_bias));
+    }
+    s_trace_rate_hz = h.rate_hz;
+
+    if (s_count == 0) {
+        return -1;
+    }
+
+    s_samples = calloc(s_count, sizeof(bench_sample_t));
+    _convert_records(s_records, s_count, s_samples);
+
+    double span_s = s_records[s_count - 1].t_us / 1e6;
+    printf("trace: profile %u, ±%.0f°/s ±%.0fg, %.1f s, bias %d/%d/%d LSB%s\n",
+           h.profile, 32768.0f / s_gyro_sens, 32768.0f / s_accel_sens, span_s,
+           s_gyro_bias[0], s_gyro_bias[1], s_gyro_bias[2],
+           (h.flags & MPU6050_TRACE_FLAG_BIAS_VALID) ? "" : " (uncalibrated)");
+    return 0;
+}
+
+static void _bench_convert(void)
+{
+    if (s_records == NULL) return;
+
+    bench_sample_t *out = malloc(s_count * sizeof(bench_sample_t));
+    double t0 = _now_ns();
+    for (int rep = 0; rep < BENCH_REPEAT; rep++) {
+        _convert_records(s_records, s_count, out);
+    }
+    double ns = (_now_ns() - t0) / ((double)BENCH_REPEAT * s_count);
+
+    // 防止编译器把换算结果整体优化掉
+    volatile float sink = out[s_count / 2].gx;
+    (void)sink;
+    free(out);
+
+    printf("%-14s %8.2f ns/sample (%.1f Msample/s)\n", "convert", ns, 1e3 / ns);
+}
+
+static int _cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void _run(const char *name, imu_fusion_algo_t algo, float rate_hz)
+{
+    imu_fusion_t f;
+    double err_sq[3] = {0};
+    float max_err[3] = {0};
+
+    // 精度：单次完整回放
+    imu_fusion_init(&f, algo, rate_hz);
+    imu_fusion_align(&f, s_samples[0].ax, s_samples[0].ay, s_samples[0].az);
+    for (size_t i = 0; i < s_count; i++) {
+        const bench_sample_t *s = &s_samples[i];
+        imu_fusion_update(&f, s->gx, s->gy, s->gz, s->ax, s->ay, s->az);
+
+        if (s_has_truth) {
+            float e[3];
+            imu_fusion_quat_to_euler(&f.q, &e[0], &e[1], &e[2]);
+            e[0] = _angle_diff(e[0], s->yaw);
+            e[1] = _angle_diff(e[1], s->pitch);
+            e[2] = _angle_diff(e[2], s->roll);
+            for (int k = 0; k < 3; k++) {
+                err_sq[k] += (double)e[k] * e[k];
+                if (fabsf(e[k]) > max_err[k]) max_err[k] = fabsf(e[k]);
+            }
+        }
+    }
+
+    float yaw, pitch, roll;
+    imu_fusion_quat_to_euler(&f.q, &yaw, &pitch, &roll);
+
+    // 耗时：重复回放取平均
+    double t0 = _now_ns();
+    for (int rep = 0; rep < BENCH_REPEAT; rep++) {
+        imu_fusion_init(&f, algo, rate_hz);
+        for (size_t i = 0; i < s_count; i++) {
+            const bench_sample_t *s = &s_samples[i];
+            imu_fusion_update(&f, s->gx, s->gy, s->gz, s->ax, s->ay, s->az);
+        }
+    }
+    double ns = (_now_ns() - t0) / ((double)BENCH_REPEAT * s_count);
+
+    // 单步时延分布：逐步计时（含计时开销），关注尾部而非平均
+    double *lat = malloc(s_count * sizeof(double));
+    imu_fusion_init(&f, algo, rate_hz);
+    for (size_t i = 0; i < s_count; i++) {
+        const bench_sample_t *s = &s_samples[i];
+        double t1 = _now_ns();
+        imu_fusion_update(&f, s->gx, s->gy, s->gz, s->ax, s->ay, s->az);
+        lat[i] = _now_ns() - t1;
+    }
+    qsort(lat, s_count, sizeof(double), _cmp_double);
+    double p50 = lat[s_count / 2];
+    double p99 = lat[(size_t)((s_count - 1) * LATENCY_PCT_HI)];
+    double lat_max = lat[s_count - 1];
+    free(lat);
+
+    printf("%-14s %8.1f ns/step   final yaw %7.2f pitch %7.2f roll %7.2f\n", name, ns, yaw, pitch, roll);
+    printf("%-14s latency  p50 %6.0f  p99 %6.0f  max %8.0f (ns)\n", "", p50, p99, lat_max);
+    if (s_has_truth) {
+        printf("%-14s RMS err  yaw %6.2f pitch %6.2f roll %6.2f | max yaw %6.2f pitch %6.2f roll %6.2f (deg)\n", "",
+               sqrt(err_sq[0] / s_count), sqrt(err_sq[1] / s_count), sqrt(err_sq[2] / s_count),
+               max_err[0], max_err[1], max_err[2]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    float rate_hz = SYNTH_RATE_HZ;
+
+    if (argc > 1) {
+        int ret = _load_trace(argv[1]);
+        if (ret > 0) {
+            ret = _load_csv(argv[1]);
+        }
+        if (ret != 0) {
+            fprintf(stderr, "无法读取轨迹: %s\n", argv[1]);
+            return 1;
+        }
+        if (s_trace_rate_hz > 0.0f) rate_hz = s_trace_rate_hz;
+        if (argc > 2) rate_hz = strtof(argv[2], NULL);
+    } else {
+        srand(1);
+        _make_synthetic();
+    }
+
+    printf("%zu samples @ %.0f Hz (%s)\n", s_count, rate_hz, s_has_truth ? "synthetic" : argv[1]);
+    _bench_convert();
+    _run("complementary", IMU_FUSION_COMPLEMENTARY, rate_hz);
+    _run("madgwick", IMU_FUSION_MADGWICK, rate_hz);
+
+    free(s_samples);
+    free(s_records);
+    return 0;
+}
@@ -0,0 +1,303 @@
+#!/usr/bin/env python3
+"""
+设备端协议模拟：在主机上扮演 esp32s3 的 MQTT 侧，使帧发布端、遥测订阅端与代理可以在没有硬件时联调与测量。
+mymqtt 依赖 ESP-IDF（esp-mqtt、FreeRTOS、esp_timer），无法在主机编译，这里按同样的协议与策略重新实现：
+
+  - 接收 esp32/image（整帧 115200 字节）与 esp32/image_roi（8 字节头部 + 像素），校验长度与区域
+  - 帧缓冲模型同 mymqtt + lvgl_ui（LVGL 模式）：共 MYMQTT_IMG_BUF_COUNT 个缓冲，相机控件一直持有屏幕上的一帧，
+    另有至多一帧待显示（更新的帧到达时旧的待显示帧直接归还）；无空闲缓冲时新帧丢弃。
+    显示任务每帧交换后渲染 --display-ms 毫秒，渲染期间不交换
+  - 计数与设备一致：received 只计交付给消费者的帧（丢弃的不计），displayed 只计交换上屏的帧，
+    queue 为等待显示的帧数（不含屏幕上的一帧），queue_cap 为缓冲数减 1
+  - 每 MYMQTT_FEEDBACK_PERIOD_MS 发布 esp32/image_feedback，建议帧率算法与 _mymqtt_feedback_cb 相同
+  - 应答 esp32/cmd/mqtt_rx_stats（同 MYMQTT_BENCH_CMD_ENABLE=1 的基准测试固件）：fragments 按 rx_buf 推算
+    （esp-mqtt 首个分片为接收缓冲区减去 PUBLISH 头部，之后每片一个缓冲区），主机收到的是整条消息，
+    frame_us_* 无法测量恒为 0，没有堆统计；esp32/cmd/mqtt_rx_buf 立即生效，不重启
+  - --imu-rate 大于 0 时按遥测格式 v2（telemetry_config.h）发布合成的 MPU6050 批次到 esp32/mpu6050_data
+
+依赖：pip install paho-mqtt
+
+用法：
+  python3 tools/mqtt_device_emu.py --host 127.0.0.1 --display-ms 60 --imu-rate 500
+"""
+
+import argparse
+import json
+import math
+import struct
+import threading
+import time
+
+import paho.mqtt.client as mqtt
+
+# 与 mymqtt_config.h / telemetry_config.h 保持一致
+TOPIC_IMAGE = "esp32/image"
+TOPIC_IMAGE_ROI = "esp32/image_roi"
+TOPIC_FEEDBACK = "esp32/image_feedback"
+TOPIC_CMD_RX_BUF = "esp32/cmd/mqtt_rx_buf"
+TOPIC_CMD_RX_STATS = "esp32/cmd/mqtt_rx_stats"
+TOPIC_RX_STATS = "esp32/mqtt_rx_stats"
+TOPIC_MPU6050 = "esp32/mpu6050_data"
+
+IMG_W, IMG_H = 240, 240
+FRAME_BYTES = IMG_W * IMG_H * 2
+IMG_BUF_COUNT = 2
+ROI_HEADER_SIZE = 8
+RX_BUFFER_SIZE = 16 * 1024
+RX_BUFFER_MIN, RX_BUFFER_MAX = 2 * 1024, FRAME_BYTES
+
+FEEDBACK_PERIOD_MS = 1000
+FEEDBACK_FPS_MIN, FEEDBACK_FPS_MAX, FEEDBACK_FPS_INIT = 1, 30, 10
+FEEDBACK_DECREASE_PCT = 80
+FEEDBACK_UP_PERIODS = 3
+
+TELEMETRY_FORMAT_VERSION = 2
+TELEMETRY_BATCH_SAMPLES = 25
+TELEMETRY_FLUSH_INTERVAL_MS = 250
+
+
+def mqtt_fragments(rx_buf, topic, payload_len, qos=1):
+    """esp-mqtt 交付一条 PUBLISH 的 MQTT_EVENT_DATA 次数（首片与头部共用接收缓冲区）"""
+    body = 2 + len(topic) + (2 if qos else 0) + payload_len
+    rem_len_bytes = 1
+    while body >= 128 ** rem_len_bytes:
+        rem_len_bytes += 1
+    first = max(rx_buf - (1 + rem_len_bytes + 2 + len(topic) + (2 if qos else 0)), 1)
+    if payload_len <= first:
+        return 1
+    return 1 + -(-(payload_len - first) // rx_buf)
+
+
+class Device:
+    def __init__(self, args):
+        self.args = args
+        self.lock = threading.Lock()
+        self.shown = False              # 相机控件持有屏幕上的一帧（第一帧交换后一直为 True）
+        self.pending = False            # 待显示帧（lvgl_ui 的 s_cam_pending）
+        self.wake = threading.Condition(self.lock)
+        self.received = 0               # s_img_received：完整接收并交付的帧
+        self.dropped = 0                # s_img_dropped：无空闲缓冲丢弃的帧
+        self.displayed = 0              # lvgl_ui_camera_frame_count：交换上屏的帧
+        self.rx_buf = RX_BUFFER_SIZE
+        self.reset_stats()
+
+        self.fb_last = (0, 0, 0, time.monotonic())
+        self.fb_target = FEEDBACK_FPS_INIT
+        self.fb_good = 0
+        self.fb_seq = 0
+
+    def reset_stats(self):
+        self.st = {"frames": 0, "dropped": 0, "fragments": 0, "bytes": 0, "roi_updates": 0,
+                   "roi_rejected": 0, "roi_bytes": 0, "since": time.monotonic()}
+
+    def held(self):
+        return int(self.shown) + int(self.pending)
+
+    def on_frame(self, payload):
+        with self.lock:
+            if len(payload) != FRAME_BYTES:
+                return                  # 设备端长度不符的图像直接忽略，不计数
+            # 首个分片取空闲缓冲：消费者持有全部缓冲时丢帧
+            if self.held() >= IMG_BUF_COUNT:
+                self.dropped += 1
+                self.st["dropped"] += 1
+                return
+            self.received += 1
+            self.st["frames"] += 1
+            self.st["fragments"] += mqtt_fragments(self.rx_buf, TOPIC_IMAGE, len(payload))
+            self.st["bytes"] += len(payload)
+            # lvgl_ui_camera_update：旧的待显示帧被替换后直接归还（不计显示）
+            self.pending = True
+            self.wake.notify()
+
+    def on_roi(self, payload):
+        ok = len(payload) >= ROI_HEADER_SIZE
+        if ok:
+            x, y, w, h = struct.unpack_from("<4H", payload)
+            ok = (w > 0 and h > 0 and x + w <= IMG_W and y + h <= IMG_H and
+                  len(payload) == ROI_HEADER_SIZE + w * h * 2)
+        with self.lock:
+            if ok:
+                self.st["roi_updates"] += 1
+                self.st["roi_bytes"] += len(payload)
+            else:
+                self.st["roi_rejected"] += 1
+
+    def display_loop(self):
+        while True:
+            with self.lock:
+                while not self.pending:
+                    self.wake.wait()
+                # lvgl_ui_camera_swap_cb：待显示帧上屏，原屏幕上的帧归还
+                self.pending = False
+                self.shown = True
+                self.displayed += 1
+            time.sleep(self.args.display_ms / 1000.0)
+
+    def stats_json(self):
+        with self.lock:
+            st = dict(self.st)
+            rx_buf = self.rx_buf
+        return json.dumps({
+            "rx_buf": rx_buf, "frames": st["frames"], "dropped": st["dropped"],
+            "fragments": st["fragments"], "bytes": st["bytes"], "frame_us_min": 0,
+            "frame_us_max": 0, "frame_us_avg": 0, "roi_updates": st["roi_updates"],
+            "roi_rejected": st["roi_rejected"], "roi_bytes": st["roi_bytes"],
+            "elapsed_us": int((time.monotonic() - st["since"]) * 1e6),
+        }, separators=(",", ":"))
+
+    def feedback(self):
+        now = time.monotonic()
+        with self.lock:
+            rx, drop, disp = self.received, self.dropped, self.displayed
+            queue_depth = max(self.held() - 1, 0)
+        last_rx, last_drop, last_disp, last_t = self.fb_last
+        self.fb_last = (rx, drop, disp, now)
+        secs = now - last_t
+        if secs <= 0:
+            return None
+        d_rx, d_drop, d_disp = rx - last_rx, drop - last_drop, disp - last_disp
+        rx_fps, disp_fps = d_rx / secs, d_disp / secs
+
+        level = 0
+        if d_drop > 0 and d_drop * 2 >= d_rx + d_drop:
+            level = 2
+        elif d_drop > 0 or (queue_depth > 0 and queue_depth >= IMG_BUF_COUNT - 1):
+            level = 1
+
+        if level > 0:
+            self.fb_target = min(self.fb_target, int(disp_fps * FEEDBACK_DECREASE_PCT / 100.0))
+            self.fb_good = 0
+        elif d_rx > 0:
+            self.fb_good += 1
+            if self.fb_good >= FEEDBACK_UP_PERIODS:
+                self.fb_target += 1
+                self.fb_good = 0
+        self.fb_target = max(FEEDBACK_FPS_MIN, min(FEEDBACK_FPS_MAX, self.fb_target))
+
+        msg = {"seq": self.fb_seq, "period_ms": FEEDBACK_PERIOD_MS, "rx_fps": round(rx_fps, 1),
+               "disp_fps": round(disp_fps, 1), "dropped": d_drop, "queue": queue_depth,
+               "queue_cap": IMG_BUF_COUNT - 1, "target_fps": self.fb_target, "level": level}
+        self.fb_seq += 1
+        return json.dumps(msg, separators=(",", ":"))
+
+
+def put_varint(out, v):
+    while v >= 0x80:
+        out.append((v & 0x7F) | 0x80)
+        v >>= 7
+    out.append(v)
+
+
+def zigzag(v):
+    return (v << 1) ^ (v >> 31)
+
+
+def synth_sample(t):
+    # ±2g / ±250°/s 量程下的缓慢摆头：俯仰与偏航两路正弦
+    return [int(2000 * math.sin(t * 1.3)), int(1500 * math.sin(t * 0.7)), 16384 - int(300 * math.sin(t)),
+            int(4000 * math.cos(t * 1.3)), int(2500 * math.cos(t * 0.7)), int(200 * math.sin(t * 5))]
+
+
+def telemetry_loop(client, args):
+    period = 1.0 / args.imu_rate
+    seq = 0
+    t0 = time.monotonic()
+    next_t = t0
+    batch = []
+    batch_start = None
+    while True:
+        next_t += period
+        delay = next_t - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+        now = time.monotonic()
+        ts_us = int((now - t0) * 1e6)
+        batch.append((ts_us, synth_sample(now - t0)))
+        if batch_start is None:
+            batch_start = now
+        if (len(batch) < TELEMETRY_BATCH_SAMPLES and
+                (now - batch_start) * 1000 < TELEMETRY_FLUSH_INTERVAL_MS):
+            continue
+
+        pkt = bytearray(struct.pack("<BBHQBB", TELEMETRY_FORMAT_VERSION, len(batch), seq & 0xFFFF,
+                                    batch[0][0], 0, 0))
+        pkt += struct.pack("<6h", *batch[0][1])
+        for (pt, prev), (ct, cur) in zip(batch, batch[1:]):
+            put_varint(pkt, ct - pt)
+            for p, c in zip(prev, cur):
+                put_varint(pkt, zigzag(c - p))
+        client.publish(TOPIC_MPU6050, bytes(pkt), qos=0)
+        seq += 1
+        batch = []
+        batch_start = None
+
+
+def main():
+    ap = argparse.ArgumentParser(description="esp32s3 MQTT 协议模拟（图像接收 + 反馈 + 遥测）")
+    ap.add_argument("--host", default="127.0.0.1")
+    ap.add_argument("--port", type=int, default=1883)
+    ap.add_argument("--username", default="RobiEcho")
+    ap.add_argument("--password", default="123456")
+    ap.add_argument("--client-id", default="esp32s3_client")
+    ap.add_argument("--display-ms", type=float, default=50.0, help="显示一帧的耗时（毫秒），决定可持续帧率")
+    ap.add_argument("--imu-rate", type=float, default=0, help="合成 MPU6050 采样率（Hz），0 表示不发布遥测")
+    args = ap.parse_args()
+
+    dev = Device(args)
+
+    def on_connect(c, u, flags, rc):
+        c.subscribe([(TOPIC_IMAGE, 1), (TOPIC_IMAGE_ROI, 1), (TOPIC_CMD_RX_BUF, 1), (TOPIC_CMD_RX_STATS, 1)])
+        print(f"已连接 {args.host}:{args.port}")
+
+    def on_message(c, u, msg):
+        if msg.topic == TOPIC_IMAGE:
+            dev.on_frame(msg.payload)
+        elif msg.topic == TOPIC_IMAGE_ROI:
+            dev.on_roi(msg.payload)
+        elif msg.topic == TOPIC_CMD_RX_STATS:
+            c.publish(TOPIC_RX_STATS, dev.stats_json(), qos=1)
+            if msg.payload == b"reset":
+                with dev.lock:
+                    dev.reset_stats()
+        elif msg.topic == TOPIC_CMD_RX_BUF:
+            try:
+                size = int(msg.payload)
+            except ValueError:
+                return
+            with dev.lock:
+                same = (size == dev.rx_buf)
+                if not same and RX_BUFFER_MIN <= size <= RX_BUFFER_MAX:
+                    dev.rx_buf = size
+            if same:
+                c.publish(TOPIC_RX_STATS, dev.stats_json(), qos=1)  # 同设备：已是该大小时直接回复
+
+    try:
+        client = mqtt.Client(mqtt.CallbackAPIVersion.VERSION1, client_id=args.client_id)
+    except AttributeError:
+        client = mqtt.Client(client_id=args.client_id)
+    client.username_pw_set(args.username, args.password)
+    client.on_connect = on_connect
+    client.on_message = on_message
+    client.connect(args.host, args.port, keepalive=15)
+    client.loop_start()
+
+    threading.Thread(target=dev.display_loop, daemon=True).start()
+    if args.imu_rate > 0:
+        threading.Thread(target=telemetry_loop, args=(client, args), daemon=True).start()
+
+    try:
+        while True:
+            time.sleep(FEEDBACK_PERIOD_MS / 1000.0)
+            msg = dev.feedback()
+            if msg is not None:
+                client.publish(TOPIC_FEEDBACK, msg, qos=0)
+                print(msg, flush=True)
+    except KeyboardInterrupt:
+        pass
+    client.loop_stop()
+    client.disconnect()
+
+
+if __name__ == "__main__":
+    main()
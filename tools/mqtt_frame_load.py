@@ -0,0 +1,275 @@
+#!/usr/bin/env python3
+"""
+图像发布负载生成器：按给定帧率向设备（或 mqtt_device_emu.py）发布测试帧，
+跟随设备的 esp32/image_feedback 调整帧率，周期打印发送/接收两侧的速率。
+
+依赖：pip install paho-mqtt
+
+用法：
+  # 整帧，初始 10 帧/秒，跟随反馈，持续 30 秒
+  python3 tools/mqtt_frame_load.py --host 127.0.0.1 --fps 10 --duration 30
+  # 固定 20 帧/秒，不跟随反馈，结束时读取设备接收统计
+  python3 tools/mqtt_frame_load.py --fps 20 --no-feedback --device-stats
+  # 区域更新：64x48 的矩形在屏幕上移动
+  python3 tools/mqtt_frame_load.py --mode roi --roi 64x48 --fps 30
+  # zlib 压缩帧（当前固件没有解码，默认发布到 esp32/image_z，只测代理/链路吞吐）
+  python3 tools/mqtt_frame_load.py --compress zlib --pattern gradient
+
+帧内容（--pattern）：
+  gradient  每帧平移的彩色渐变（压缩率高，近似界面画面）
+  bars      每帧平移的竖条（压缩率中等）
+  noise     随机像素（几乎不可压缩，近似摄像头噪声）
+像素为小端 RGB565，与设备端 MYMQTT_IMG_SWAP_BYTES=1 的输入字节序一致。
+
+分片大小：MQTT 消息在发布端不可拆分，设备端分片由接收缓冲区决定（见 mqtt_rx_bench.py），
+链路侧的分段与限速由 mqtt_stub_broker.py 的 --frag / --bandwidth 模拟。
+"""
+
+import argparse
+import array
+import json
+import os
+import struct
+import sys
+import threading
+import time
+import zlib
+
+import paho.mqtt.client as mqtt
+
+# 与 mymqtt_config.h 保持一致
+TOPIC_IMAGE = "esp32/image"
+TOPIC_IMAGE_ROI = "esp32/image_roi"
+TOPIC_IMAGE_Z = "esp32/image_z"
+TOPIC_FEEDBACK = "esp32/image_feedback"
+TOPIC_CMD_RX_STATS = "esp32/cmd/mqtt_rx_stats"
+TOPIC_RX_STATS = "esp32/mqtt_rx_stats"
+
+IMG_W, IMG_H = 240, 240
+FRAME_BYTES = IMG_W * IMG_H * 2
+FEEDBACK_FPS_MIN, FEEDBACK_FPS_MAX = 1, 30
+PATTERN_FRAMES = 30                     # 预生成的帧数（循环发送）
+
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def make_pixels(pattern, w, h, phase):
+    if pattern == "noise":
+        return os.urandom(w * h * 2)
+    px = array.array("H", bytes(w * h * 2))
+    for y in range(h):
+        row = y * w
+        for x in range(w):
+            if pattern == "gradient":
+                px[row + x] = rgb565((x + phase * 8) & 0xFF, (y * 255) // max(h - 1, 1),
+                                     (255 - x - phase * 8) & 0xFF)
+            else:
+                bar = ((x + phase * 8) // 30) & 7
+                px[row + x] = rgb565(255 * (bar & 1), 255 * ((bar >> 1) & 1), 255 * ((bar >> 2) & 1))
+    if sys.byteorder != "little":
+        px.byteswap()
+    return px.tobytes()
+
+
+def make_payloads(args):
+    """预生成一轮负载，发送时循环使用，避免生成开销影响发送节奏"""
+    payloads = []
+    raw_total = 0
+    if args.mode == "roi":
+        rw, rh = args.roi_w, args.roi_h
+        for i in range(PATTERN_FRAMES):
+            x = (i * (IMG_W - rw)) // (PATTERN_FRAMES - 1)
+            y = (i * (IMG_H - rh)) // (PATTERN_FRAMES - 1)
+            payloads.append(struct.pack("<4H", x, y, rw, rh) + make_pixels(args.pattern, rw, rh, i))
+        return payloads, 1.0
+
+    for i in range(PATTERN_FRAMES):
+        raw = make_pixels(args.pattern, IMG_W, IMG_H, i)
+        raw_total += len(raw)
+        payloads.append(zlib.compress(raw, args.zlib_level) if args.compress == "zlib" else raw)
+    ratio = raw_total / sum(len(p) for p in payloads)
+    return payloads, ratio
+
+
+class Feedback:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.last = None
+        self.count = 0
+
+    def update(self, msg):
+        with self.lock:
+            self.last = msg
+            self.count += 1
+
+    def get(self):
+        with self.lock:
+            return self.last, self.count
+
+
+def make_client(args, feedback, replies):
+    try:
+        client = mqtt.Client(mqtt.CallbackAPIVersion.VERSION1, client_id=args.client_id)
+    except AttributeError:
+        client = mqtt.Client(client_id=args.client_id)
+    if args.username:
+        client.username_pw_set(args.username, args.password)
+    client.max_inflight_messages_set(args.inflight)
+
+    def on_message(c, u, msg):
+        try:
+            data = json.loads(msg.payload)
+        except ValueError:
+            return
+        if msg.topic == TOPIC_FEEDBACK:
+            feedback.update(data)
+        else:
+            replies.append(data)
+
+    client.on_message = on_message
+    client.connect(args.host, args.port, keepalive=30)
+    client.subscribe([(TOPIC_FEEDBACK, 0), (TOPIC_RX_STATS, 1)])
+    client.loop_start()
+    return client
+
+
+def request_stats(client, replies, payload="", timeout=2.0):
+    replies.clear()
+    client.publish(TOPIC_CMD_RX_STATS, payload, qos=1)
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        if replies:
+            return replies[-1]
+        time.sleep(0.05)
+    return None
+
+
+def main():
+    ap = argparse.ArgumentParser(description="图像发布负载生成器")
+    ap.add_argument("--host", default="127.0.0.1")
+    ap.add_argument("--port", type=int, default=1883)
+    ap.add_argument("--username", default="RobiEcho")
+    ap.add_argument("--password", default="123456")
+    ap.add_argument("--client-id", default="mqtt_frame_load")
+    ap.add_argument("--mode", choices=("frame", "roi"), default="frame")
+    ap.add_argument("--roi", default="64x48", help="区域更新大小 WxH（--mode roi）")
+    ap.add_argument("--pattern", choices=("gradient", "bars", "noise"), default="bars")
+    ap.add_argument("--compress", choices=("none", "zlib"), default="none",
+                    help="整帧压缩方式（固件无解码，压缩帧默认发往 esp32/image_z）")
+    ap.add_argument("--zlib-level", type=int, default=1)
+    ap.add_argument("--topic", default=None, help="覆盖发布主题")
+    ap.add_argument("--fps", type=float, default=10.0, help="初始发送帧率（不跟随反馈时为固定帧率）")
+    ap.add_argument("--max-fps", type=float, default=FEEDBACK_FPS_MAX, help="跟随反馈时的帧率上限")
+    ap.add_argument("--no-feedback", action="store_true", help="忽略设备反馈，保持 --fps")
+    ap.add_argument("--qos", type=int, choices=(0, 1), default=1)
+    ap.add_argument("--inflight", type=int, default=2, help="未确认的 QoS 1 消息上限（发布端反压）")
+    ap.add_argument("--duration", type=float, default=30.0, help="发送时长（秒）")
+    ap.add_argument("--frames", type=int, default=0, help="发送帧数，大于 0 时优先于 --duration")
+    ap.add_argument("--report", type=float, default=1.0, help="进度打印周期（秒）")
+    ap.add_argument("--device-stats", action="store_true", help="开始前清零、结束后读取设备接收统计")
+    args = ap.parse_args()
+
+    try:
+        args.roi_w, args.roi_h = (int(v) for v in args.roi.lower().split("x"))
+    except ValueError:
+        ap.error("--roi 格式为 WxH")
+    if args.mode == "roi" and not (0 < args.roi_w <= IMG_W and 0 < args.roi_h <= IMG_H):
+        ap.error(f"--roi 超出 {IMG_W}x{IMG_H}")
+
+    topic = args.topic
+    if topic is None:
+        if args.mode == "roi":
+            topic = TOPIC_IMAGE_ROI
+        else:
+            topic = TOPIC_IMAGE_Z if args.compress == "zlib" else TOPIC_IMAGE
+    if topic == TOPIC_IMAGE and args.compress != "none":
+        print("警告：当前固件不解码压缩帧，设备会按长度不符丢弃", file=sys.stderr)
+
+    payloads, ratio = make_payloads(args)
+    avg_len = sum(len(p) for p in payloads) / len(payloads)
+    print(f"主题 {topic}  负载 {avg_len / 1024:.1f} KB/帧  压缩比 {ratio:.2f}")
+
+    feedback = Feedback()
+    replies = []
+    client = make_client(args, feedback, replies)
+    if args.device_stats and request_stats(client, replies, "reset") is None:
+        print("未收到设备统计回复（设备离线或 MYMQTT_BENCH_CMD_ENABLE=0）", file=sys.stderr)
+
+    fps = args.fps
+    sent = sent_bytes = 0
+    fb_seen = 0
+    t0 = time.monotonic()
+    next_t = t0
+    t_report = t0
+    rep_sent = rep_bytes = 0
+    late_ms_max = 0.0
+
+    try:
+        while True:
+            now = time.monotonic()
+            if args.frames > 0 and sent >= args.frames:
+                break
+            if args.frames <= 0 and now - t0 >= args.duration:
+                break
+
+            last, count = feedback.get()
+            if not args.no_feedback and last is not None and count != fb_seen:
+                fb_seen = count
+                fps = max(FEEDBACK_FPS_MIN, min(args.max_fps, float(last.get("target_fps", fps))))
+
+            if now < next_t:
+                time.sleep(next_t - now)
+            else:
+                late_ms_max = max(late_ms_max, (now - next_t) * 1000)
+            payload = payloads[sent % len(payloads)]
+            info = client.publish(topic, payload, qos=args.qos)
+            if args.qos:
+                info.wait_for_publish()
+            sent += 1
+            sent_bytes += len(payload)
+            rep_sent += 1
+            rep_bytes += len(payload)
+            # 发送跟不上时从当前时刻重新计时，不补发积压的帧
+            next_t = max(next_t + 1.0 / fps, time.monotonic() - 1.0 / fps)
+
+            now = time.monotonic()
+            if now - t_report >= args.report:
+                dt = now - t_report
+                fb = ""
+                if last is not None:
+                    fb = (f"  设备 rx {last.get('rx_fps', 0):5.1f} disp {last.get('disp_fps', 0):5.1f} "
+                          f"drop {last.get('dropped', 0):>3} queue {last.get('queue', 0)}/"
+                          f"{last.get('queue_cap', 0)} level {last.get('level', 0)}")
+                print(f"{now - t0:6.1f}s  目标 {fps:5.1f}  发送 {rep_sent / dt:5.1f} fps "
+                      f"{rep_bytes / dt / 1e6:6.2f} MB/s{fb}", flush=True)
+                t_report = now
+                rep_sent = rep_bytes = 0
+    except KeyboardInterrupt:
+        pass
+
+    elapsed = time.monotonic() - t0
+    print(f"合计 {sent} 帧 {sent_bytes / 1e6:.1f} MB，{elapsed:.1f} 秒，"
+          f"平均 {sent / elapsed:.2f} fps {sent_bytes / elapsed / 1e6:.2f} MB/s，最大发送滞后 {late_ms_max:.1f} ms")
+
+    if args.device_stats:
+        time.sleep(1.0)
+        st = request_stats(client, replies)
+        if st is None:
+            print("未收到设备统计回复", file=sys.stderr)
+        else:
+            frames = st.get("frames", 0)
+            line = (f"设备 frames {frames} dropped {st.get('dropped', 0)} "
+                    f"roi {st.get('roi_updates', 0)}/{st.get('roi_rejected', 0)} rejected "
+                    f"frame_us avg {st.get('frame_us_avg', 0)} max {st.get('frame_us_max', 0)}")
+            if "int_min" in st:
+                line += f" 内部 RAM 空闲 {st['int_free']} 最低 {st['int_min']} 堆最低 {st['heap_min']}"
+            print(line)
+
+    client.loop_stop()
+    client.disconnect()
+
+
+if __name__ == "__main__":
+    main()
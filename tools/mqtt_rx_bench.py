@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""
+mymqtt 接收缓冲区基准测试：对每个接收缓冲区大小，向设备连续发布图像帧，
+读取设备端接收统计，比较帧率、吞吐、每帧分片数与丢帧。
+
+依赖：pip install paho-mqtt
+
+设备需运行开启 MYMQTT_BENCH_CMD_ENABLE 的基准测试固件（默认关闭，开启方法见 mymqtt_config.h），
+否则命令主题无应答，步骤 2 会超时。
+
+用法（在同一局域网内的主机上运行，代理即设备使用的代理）：
+  python3 tools/mqtt_rx_bench.py --host 192.168.5.46 --sizes 4096,8192,16384,32768 --frames 200
+
+流程（每个大小）：
+  1. 发布 esp32/cmd/mqtt_rx_buf=<size>；大小变化时设备保存到 NVS 并重启
+  2. 反复请求 esp32/cmd/mqtt_rx_stats，直到回复中的 rx_buf 等于目标值（设备已以新缓冲区上线）
+  3. 请求统计并清零（载荷 "reset"）
+  4. 以 --rate 帧/秒（0 表示不限速）发布 --frames 帧 115200 字节图像（QoS 1）
+  5. 等待设备处理完毕后读取统计
+
+设备端帧率受显示消费者限制时会出现丢帧（dropped），此时吞吐反映的是拼接能力而非显示帧率。
+"""
+
+import argparse
+import json
+import queue
+import sys
+import time
+
+import paho.mqtt.client as mqtt
+
+TOPIC_IMAGE = "esp32/image"
+TOPIC_CMD_RX_BUF = "esp32/cmd/mqtt_rx_buf"
+TOPIC_CMD_RX_STATS = "esp32/cmd/mqtt_rx_stats"
+TOPIC_RX_STATS = "esp32/mqtt_rx_stats"
+
+FRAME_BYTES = 240 * 240 * 2
+
+
+def make_client(args, replies):
+    # paho-mqtt 2.x 需要显式指定回调版本，1.x 没有该参数
+    try:
+        client = mqtt.Client(mqtt.CallbackAPIVersion.VERSION1, client_id="mqtt_rx_bench")
+    except AttributeError:
+        client = mqtt.Client(client_id="mqtt_rx_bench")
+    if args.username:
+        client.username_pw_set(args.username, args.password)
+    client.on_message = lambda c, u, msg: replies.put(json.loads(msg.payload))
+    client.connect(args.host, args.port, keepalive=30)
+    client.subscribe(TOPIC_RX_STATS, qos=1)
+    client.loop_start()
+    return client
+
+
+def request_stats(client, replies, payload="", timeout=2.0):
+    while not replies.empty():
+        replies.get_nowait()
+    client.publish(TOPIC_CMD_RX_STATS, payload, qos=1)
+    try:
+        return replies.get(timeout=timeout)
+    except queue.Empty:
+        return None
+
+
+def apply_size(client, replies, size, timeout):
+    client.publish(TOPIC_CMD_RX_BUF, str(size), qos=1)
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        st = request_stats(client, replies)
+        if st is not None and st["rx_buf"] == size:
+            return True
+        time.sleep(0.5)
+    return False
+
+
+def run_size(client, replies, args, size):
+    if not apply_size(client, replies, size, args.restart_timeout):
+        print(f"{size:>8}  设备未以该缓冲区上线（超时）", file=sys.stderr)
+        return None
+
+    request_stats(client, replies, "reset")
+
+    frame = bytes(i & 0xFF for i in range(FRAME_BYTES))
+    interval = 1.0 / args.rate if args.rate > 0 else 0.0
+    t0 = time.monotonic()
+    for i in range(args.frames):
+        client.publish(TOPIC_IMAGE, frame, qos=1).wait_for_publish()
+        if interval:
+            next_t = t0 + (i + 1) * interval
+            delay = next_t - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+    send_s = time.monotonic() - t0
+
+    time.sleep(args.settle)
+    return request_stats(client, replies), send_s
+
+
+def main():
+    ap = argparse.ArgumentParser(description="mymqtt 接收缓冲区基准测试")
+    ap.add_argument("--host", default="192.168.5.46")
+    ap.add_argument("--port", type=int, default=1883)
+    ap.add_argument("--username", default="RobiEcho")
+    ap.add_argument("--password", default="123456")
+    ap.add_argument("--sizes", default="4096,8192,16384,32768,65536",
+                    help="逗号分隔的接收缓冲区大小（字节，2048 ~ 115200）")
+    ap.add_argument("--frames", type=int, default=200, help="每个大小发布的帧数")
+    ap.add_argument("--rate", type=float, default=0, help="发布帧率上限，0 表示不限速")
+    ap.add_argument("--settle", type=float, default=1.0, help="发布结束后等待设备处理的秒数")
+    ap.add_argument("--restart-timeout", type=float, default=30.0, help="等待设备重启上线的秒数")
+    args = ap.parse_args()
+
+    replies = queue.Queue()
+    client = make_client(args, replies)
+    sizes = [int(s) for s in args.sizes.split(",") if s]
+
+    print(f"{'rx_buf':>8} {'frames':>7} {'drop':>5} {'frag/f':>7} {'fps':>7} {'MB/s':>7} "
+          f"{'f_avg_ms':>9} {'f_max_ms':>9} {'send_s':>7}")
+    for size in sizes:
+        result = run_size(client, replies, args, size)
+        if result is None:
+            continue
+        st, send_s = result
+        if st is None:
+            print(f"{size:>8}  未收到统计回复", file=sys.stderr)
+            continue
+
+        # 设备统计窗口包含等待时间，速率按发布耗时计算（QoS 1 发布受设备接收速度反压）
+        elapsed = send_s
+        frames = st["frames"]
+        print(f"{size:>8} {frames:>7} {st['dropped']:>5} "
+              f"{(st['fragments'] / frames if frames else 0):>7.1f} "
+              f"{(frames / elapsed if elapsed else 0):>7.2f} "
+              f"{(st['bytes'] / elapsed / 1e6 if elapsed else 0):>7.2f} "
+              f"{st['frame_us_avg'] / 1000:>9.2f} {st['frame_us_max'] / 1000:>9.2f} {send_s:>7.2f}")
+
+    client.loop_stop()
+    client.disconnect()
+
+
+if __name__ == "__main__":
+    main()
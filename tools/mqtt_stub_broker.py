@@ -0,0 +1,427 @@
+#!/usr/bin/env python3
+"""
+最小 MQTT 3.1.1 代理（主机基准测试用替身），只依赖标准库。
+
+用途：在没有 mosquitto 的主机/CI 环境中为 mqtt_frame_load.py、mqtt_device_emu.py、
+mqtt_telemetry_sub.py 与 mqtt_rx_bench.py 提供可复现的对端；设备也可直接连接
+（修改 MYMQTT_BROKER_URI），此时可用 --frag / --bandwidth 模拟链路条件。
+
+用法：
+  python3 tools/mqtt_stub_broker.py --port 1883
+  python3 tools/mqtt_stub_broker.py --port 1883 --frag 1460 --frag-delay-ms 1 --bandwidth 800
+
+支持：
+  - CONNECT（不校验用户名密码）、持久会话（clean_session=0 时保留订阅并在 CONNACK 置 session_present）
+  - SUBSCRIBE / UNSUBSCRIBE（'+' '#' 通配符，'$' 开头主题不参与通配符匹配）
+  - PUBLISH QoS 0/1/2 入站，出站 QoS 取发布与订阅的较小值（最高 1）
+  - PINGREQ、DISCONNECT、心跳超时（1.5 倍 keepalive）、同 client_id 顶替旧连接
+不支持：保留消息（retain 标志被忽略）、遗嘱消息（解析后丢弃）、离线会话排队、QoS 1 重传。
+
+转发模型（每个订阅者一个发送队列与发送协程）：
+  - 队列长度超过 --max-queued 时丢弃新消息并计数（同 mosquitto max_queued_messages）
+  - QoS 1 在途消息数达到 --max-inflight 时等待 PUBACK，形成对慢订阅者的反压
+  - 每个报文按 --frag 字节分段写入套接字，段间延时 --frag-delay-ms；
+    --bandwidth 限制每个订阅者的发送速率（KB/s），用于模拟无线链路
+"""
+
+import argparse
+import asyncio
+import itertools
+import struct
+import sys
+import time
+
+CONNECT, CONNACK, PUBLISH, PUBACK, PUBREC, PUBREL, PUBCOMP = 1, 2, 3, 4, 5, 6, 7
+SUBSCRIBE, SUBACK, UNSUBSCRIBE, UNSUBACK, PINGREQ, PINGRESP, DISCONNECT = 8, 9, 10, 11, 12, 13, 14
+
+
+class ProtocolError(Exception):
+    pass
+
+
+def topic_matches(flt, topic):
+    if topic.startswith("$") and flt[:1] in ("+", "#"):
+        return False
+    f_levels = flt.split("/")
+    t_levels = topic.split("/")
+    for i, f in enumerate(f_levels):
+        if f == "#":
+            return True
+        if i >= len(t_levels):
+            return False
+        if f != "+" and f != t_levels[i]:
+            return False
+    return len(f_levels) == len(t_levels)
+
+
+def encode_remaining_length(n):
+    out = bytearray()
+    while True:
+        b = n % 128
+        n //= 128
+        out.append(b | 0x80 if n else b)
+        if not n:
+            return bytes(out)
+
+
+def packet(ptype, flags, body=b""):
+    return bytes([(ptype << 4) | flags]) + encode_remaining_length(len(body)) + body
+
+
+def mqtt_str(s):
+    b = s.encode()
+    return struct.pack("!H", len(b)) + b
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def u8(self):
+        if self.pos + 1 > len(self.data):
+            raise ProtocolError("报文过短")
+        v = self.data[self.pos]
+        self.pos += 1
+        return v
+
+    def u16(self):
+        if self.pos + 2 > len(self.data):
+            raise ProtocolError("报文过短")
+        v = struct.unpack_from("!H", self.data, self.pos)[0]
+        self.pos += 2
+        return v
+
+    def bin(self):
+        n = self.u16()
+        if self.pos + n > len(self.data):
+            raise ProtocolError("报文过短")
+        v = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return v
+
+    def str(self):
+        return self.bin().decode("utf-8", errors="replace")
+
+    def rest(self):
+        v = self.data[self.pos:]
+        self.pos = len(self.data)
+        return v
+
+    def more(self):
+        return self.pos < len(self.data)
+
+
+class Stats:
+    def __init__(self):
+        self.msgs_in = 0
+        self.bytes_in = 0
+        self.msgs_out = 0
+        self.bytes_out = 0
+        self.dropped = 0
+
+    def snapshot(self):
+        return (self.msgs_in, self.bytes_in, self.msgs_out, self.bytes_out, self.dropped)
+
+
+class Session:
+    """订阅状态，持久会话在连接断开后保留"""
+
+    def __init__(self, client_id):
+        self.client_id = client_id
+        self.subs = {}          # filter -> qos
+        self.conn = None
+        self.stats = Stats()
+
+
+class Connection:
+    def __init__(self, broker, reader, writer):
+        self.broker = broker
+        self.reader = reader
+        self.writer = writer
+        self.session = None
+        self.clean = True
+        self.keepalive = 0
+        self.queue = asyncio.Queue()
+        self.inflight = {}                      # packet id -> 发送时间
+        self.inflight_free = asyncio.Event()
+        self.inflight_free.set()
+        self.write_lock = asyncio.Lock()
+        self.pid = itertools.cycle(range(1, 65536))
+        self.qos2_pending = set()
+        self.closed = False
+        self.peer = writer.get_extra_info("peername")
+
+    async def read_packet(self):
+        first = await self.reader.readexactly(1)
+        mult, length = 1, 0
+        for _ in range(4):
+            b = (await self.reader.readexactly(1))[0]
+            length += (b & 0x7F) * mult
+            if not b & 0x80:
+                break
+            mult *= 128
+        else:
+            raise ProtocolError("剩余长度编码无效")
+        body = await self.reader.readexactly(length) if length else b""
+        return first[0] >> 4, first[0] & 0x0F, body
+
+    async def write(self, data, pace=False):
+        """pace=True 时按分段/限速写入（转发给订阅者的 PUBLISH）"""
+        args = self.broker.args
+        async with self.write_lock:
+            if self.closed:
+                return
+            if not pace or (args.frag <= 0 and args.bandwidth <= 0):
+                self.writer.write(data)
+                await self.writer.drain()
+                return
+            step = args.frag if args.frag > 0 else len(data)
+            for off in range(0, len(data), step):
+                seg = data[off:off + step]
+                self.writer.write(seg)
+                await self.writer.drain()
+                delay = args.frag_delay_ms / 1000.0
+                if args.bandwidth > 0:
+                    delay = max(delay, len(seg) / (args.bandwidth * 1024.0))
+                if delay > 0:
+                    await asyncio.sleep(delay)
+
+    async def run(self):
+        try:
+            ptype, _, body = await asyncio.wait_for(self.read_packet(), timeout=10)
+            if ptype != CONNECT:
+                raise ProtocolError("首个报文不是 CONNECT")
+            await self.on_connect(body)
+
+            sender = asyncio.ensure_future(self.send_loop())
+            try:
+                while True:
+                    timeout = self.keepalive * 1.5 if self.keepalive else None
+                    ptype, flags, body = await asyncio.wait_for(self.read_packet(), timeout=timeout)
+                    if ptype == DISCONNECT:
+                        break
+                    await self.dispatch(ptype, flags, body)
+            finally:
+                sender.cancel()
+        except asyncio.TimeoutError:
+            self.broker.log(f"{self.name()} 心跳超时")
+        except (asyncio.IncompleteReadError, ConnectionError):
+            pass
+        except ProtocolError as e:
+            self.broker.log(f"{self.name()} 协议错误：{e}")
+        finally:
+            await self.close()
+
+    def name(self):
+        return self.session.client_id if self.session else str(self.peer)
+
+    async def close(self):
+        if self.closed:
+            return
+        self.closed = True
+        self.inflight_free.set()
+        try:
+            self.writer.close()
+        except Exception:
+            pass
+        if self.session is not None and self.session.conn is self:
+            self.session.conn = None
+            if self.clean:
+                self.broker.sessions.pop(self.session.client_id, None)
+            self.broker.log(f"{self.name()} 断开")
+
+    async def on_connect(self, body):
+        r = Reader(body)
+        proto = r.str()
+        level = r.u8()
+        flags = r.u8()
+        self.keepalive = r.u16()
+        if proto not in ("MQTT", "MQIsdp"):
+            raise ProtocolError(f"协议名 {proto!r}")
+        if level not in (3, 4):
+            await self.write(packet(CONNACK, 0, bytes([0, 1])))
+            raise ProtocolError(f"协议级别 {level}")
+        client_id = r.str()
+        if flags & 0x04:            # 遗嘱
+            r.str()
+            r.bin()
+        if flags & 0x80:
+            r.str()
+        if flags & 0x40:
+            r.bin()
+
+        self.clean = bool(flags & 0x02)
+        if not client_id:
+            client_id = f"anon-{self.peer[1] if self.peer else id(self)}"
+
+        sessions = self.broker.sessions
+        old = sessions.get(client_id)
+        if old is not None and old.conn is not None:
+            self.broker.log(f"{client_id} 被新连接顶替")
+            await old.conn.close()
+        present = False
+        if self.clean or old is None:
+            self.session = Session(client_id)
+        else:
+            self.session = old
+            present = True
+        sessions[client_id] = self.session
+        self.session.conn = self
+
+        await self.write(packet(CONNACK, 0, bytes([1 if present else 0, 0])))
+        self.broker.log(f"{client_id} 连接 {self.peer}（clean={int(self.clean)} "
+                        f"session_present={int(present)} keepalive={self.keepalive}s）")
+
+    async def dispatch(self, ptype, flags, body):
+        r = Reader(body)
+        st = self.session.stats
+        if ptype == PUBLISH:
+            qos = (flags >> 1) & 0x03
+            topic = r.str()
+            pid = r.u16() if qos else 0
+            payload = r.rest()
+            st.msgs_in += 1
+            st.bytes_in += len(payload)
+            if qos == 1:
+                await self.write(packet(PUBACK, 0, struct.pack("!H", pid)))
+            elif qos == 2:
+                await self.write(packet(PUBREC, 0, struct.pack("!H", pid)))
+                if pid in self.qos2_pending:
+                    return              # 重发的 QoS 2 报文只转发一次
+                self.qos2_pending.add(pid)
+            self.broker.route(topic, payload, qos)
+        elif ptype == PUBACK:
+            self.inflight.pop(r.u16(), None)
+            if len(self.inflight) < self.broker.args.max_inflight:
+                self.inflight_free.set()
+        elif ptype == PUBREL:
+            pid = r.u16()
+            self.qos2_pending.discard(pid)
+            await self.write(packet(PUBCOMP, 0, struct.pack("!H", pid)))
+        elif ptype in (PUBREC, PUBCOMP):
+            pass                        # 出站最高 QoS 1，不会收到
+        elif ptype == SUBSCRIBE:
+            pid = r.u16()
+            granted = bytearray()
+            while r.more():
+                flt = r.str()
+                qos = min(r.u8() & 0x03, 1)
+                self.session.subs[flt] = qos
+                granted.append(qos)
+                self.broker.log(f"{self.name()} 订阅 {flt} qos={qos}")
+            await self.write(packet(SUBACK, 0, struct.pack("!H", pid) + bytes(granted)))
+        elif ptype == UNSUBSCRIBE:
+            pid = r.u16()
+            while r.more():
+                self.session.subs.pop(r.str(), None)
+            await self.write(packet(UNSUBACK, 0, struct.pack("!H", pid)))
+        elif ptype == PINGREQ:
+            await self.write(packet(PINGRESP, 0))
+        else:
+            raise ProtocolError(f"未知报文类型 {ptype}")
+
+    def enqueue(self, topic, payload, qos):
+        if self.queue.qsize() >= self.broker.args.max_queued:
+            self.session.stats.dropped += 1
+            return
+        self.queue.put_nowait((topic, payload, qos))
+
+    async def send_loop(self):
+        args = self.broker.args
+        while True:
+            topic, payload, qos = await self.queue.get()
+            body = mqtt_str(topic)
+            if qos:
+                while len(self.inflight) >= args.max_inflight:
+                    self.inflight_free.clear()
+                    await self.inflight_free.wait()
+                    if self.closed:
+                        return
+                pid = next(self.pid)
+                self.inflight[pid] = time.monotonic()
+                body += struct.pack("!H", pid)
+            await self.write(packet(PUBLISH, qos << 1, body + payload), pace=True)
+            st = self.session.stats
+            st.msgs_out += 1
+            st.bytes_out += len(payload)
+
+
+class Broker:
+    def __init__(self, args):
+        self.args = args
+        self.sessions = {}
+
+    def log(self, msg):
+        if not self.args.quiet:
+            print(f"[{time.strftime('%H:%M:%S')}] {msg}", flush=True)
+
+    def route(self, topic, payload, qos):
+        for s in list(self.sessions.values()):
+            if s.conn is None:
+                continue                # 不为离线会话排队
+            best = -1
+            for flt, sub_qos in s.subs.items():
+                if topic_matches(flt, topic):
+                    best = max(best, sub_qos)
+            if best >= 0:
+                s.conn.enqueue(topic, payload, min(qos, best))
+
+    async def report(self):
+        last = {}
+        t_last = time.monotonic()
+        while True:
+            await asyncio.sleep(self.args.stats_interval)
+            now = time.monotonic()
+            dt = now - t_last
+            t_last = now
+            for cid, s in sorted(self.sessions.items()):
+                cur = s.stats.snapshot()
+                prev_session, prev = last.get(cid, (None, None))
+                if prev_session is not s:
+                    prev = (0, 0, 0, 0, 0)      # 新会话（clean_session 重连）统计从零开始
+                last[cid] = (s, cur)
+                d = [c - p for c, p in zip(cur, prev)]
+                if not any(d):
+                    continue
+                q = s.conn.queue.qsize() if s.conn else 0
+                print(f"{cid:>20}  in {d[0] / dt:7.1f} msg/s {d[1] / dt / 1e6:6.2f} MB/s  "
+                      f"out {d[2] / dt:7.1f} msg/s {d[3] / dt / 1e6:6.2f} MB/s  "
+                      f"drop {d[4]:>4}  queue {q}", flush=True)
+
+    async def serve(self):
+        async def on_client(reader, writer):
+            await Connection(self, reader, writer).run()
+
+        server = await asyncio.start_server(on_client, self.args.bind, self.args.port)
+        self.log(f"监听 {self.args.bind}:{self.args.port}")
+        if self.args.stats_interval > 0:
+            asyncio.ensure_future(self.report())
+        async with server:
+            await server.serve_forever()
+
+
+def main():
+    ap = argparse.ArgumentParser(description="最小 MQTT 3.1.1 代理（基准测试替身）")
+    ap.add_argument("--bind", default="0.0.0.0")
+    ap.add_argument("--port", type=int, default=1883)
+    ap.add_argument("--max-queued", type=int, default=8, help="每个订阅者发送队列上限（超出丢弃）")
+    ap.add_argument("--max-inflight", type=int, default=4, help="每个订阅者未确认的 QoS 1 消息上限")
+    ap.add_argument("--frag", type=int, default=0, help="转发报文分段写入的字节数，0 表示整报文写入")
+    ap.add_argument("--frag-delay-ms", type=float, default=0, help="分段之间的延时（毫秒）")
+    ap.add_argument("--bandwidth", type=float, default=0, help="每个订阅者的发送速率上限（KB/s），0 表示不限")
+    ap.add_argument("--stats-interval", type=float, default=5.0, help="吞吐统计打印周期（秒），0 表示不打印")
+    ap.add_argument("--quiet", action="store_true", help="不打印连接/订阅日志")
+    args = ap.parse_args()
+
+    try:
+        asyncio.run(Broker(args).serve())
+    except KeyboardInterrupt:
+        pass
+    except OSError as e:
+        print(f"监听失败：{e}", file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+"""
+遥测订阅端：订阅设备发布的 MPU6050 批次、头部姿态与动作事件，统计各主题吞吐、丢包与到达抖动。
+
+依赖：pip install paho-mqtt
+
+用法：
+  python3 tools/mqtt_telemetry_sub.py --host 127.0.0.1 --duration 60
+  python3 tools/mqtt_telemetry_sub.py --topics esp32/mpu6050_data --report 5
+
+三种消息都以 [2..3] u16 序号、[4..11] u64 设备时间戳（us）开头（格式见 telemetry_config.h、
+pose_config.h、gesture_config.h），据此统计：
+  - msg/s、B/s：按主机接收时间计算
+  - lost：序号跳变累计的丢失消息数（QoS 0 发布，代理或设备发布队列拥塞时丢弃）
+  - jitter：到达时间相对设备时间戳的偏移范围（max - min，ms），包含设备批次停留与网络排队
+MPU6050 批次会完整解码（varint 时间差 + zigzag 差值），额外统计采样数、设备侧采样率与格式错误。
+"""
+
+import argparse
+import struct
+import sys
+import threading
+import time
+
+import paho.mqtt.client as mqtt
+
+# 与 mymqtt_config.h / telemetry_config.h 保持一致
+TOPIC_MPU6050 = "esp32/mpu6050_data"
+TOPIC_POSE = "esp32/pose"
+TOPIC_GESTURE = "esp32/gesture"
+
+TELEMETRY_FORMAT_VERSION = 2
+TELEMETRY_HEADER_BYTES = 14
+TELEMETRY_CHANNELS = 6
+
+
+def get_varint(data, pos):
+    v = shift = 0
+    while True:
+        if pos >= len(data) or shift > 28:
+            raise ValueError("varint 截断")
+        b = data[pos]
+        pos += 1
+        v |= (b & 0x7F) << shift
+        if not b & 0x80:
+            return v, pos
+        shift += 7
+
+
+def unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def decode_telemetry(data):
+    """返回 (采样数, 首采样时间戳, 末采样时间戳)，格式错误抛 ValueError"""
+    if len(data) < TELEMETRY_HEADER_BYTES + TELEMETRY_CHANNELS * 2:
+        raise ValueError("长度不足")
+    ver, n, _, ts = struct.unpack_from("<BBHQ", data)
+    if ver != TELEMETRY_FORMAT_VERSION or n < 1:
+        raise ValueError(f"版本 {ver} 或采样数 {n} 无效")
+    cur = list(struct.unpack_from("<6h", data, TELEMETRY_HEADER_BYTES))
+    pos = TELEMETRY_HEADER_BYTES + TELEMETRY_CHANNELS * 2
+    t = ts
+    for _ in range(n - 1):
+        dt, pos = get_varint(data, pos)
+        t += dt
+        for i in range(TELEMETRY_CHANNELS):
+            d, pos = get_varint(data, pos)
+            cur[i] += unzigzag(d)
+            if not -32768 <= cur[i] <= 32767:
+                raise ValueError("通道值越界")
+    if pos != len(data):
+        raise ValueError(f"多余 {len(data) - pos} 字节")
+    return n, ts, t
+
+
+class TopicStats:
+    def __init__(self):
+        self.msgs = 0
+        self.bytes = 0
+        self.lost = 0
+        self.errors = 0
+        self.samples = 0
+        self.last_seq = None
+        self.first_dev_us = None
+        self.last_dev_us = None
+        self.offset_min = None          # 主机接收时间 - 设备时间戳（ms）
+        self.offset_max = None
+
+    def window(self):
+        """复制并清零区间统计（累计字段保留在 total 中）"""
+        snap = TopicStats()
+        snap.__dict__.update(self.__dict__)
+        self.msgs = self.bytes = self.lost = self.errors = self.samples = 0
+        self.offset_min = self.offset_max = None
+        self.first_dev_us = self.last_dev_us
+        return snap
+
+
+class Collector:
+    def __init__(self, topics):
+        self.lock = threading.Lock()
+        self.win = {t: TopicStats() for t in topics}
+        self.total = {t: TopicStats() for t in topics}
+
+    def on_message(self, topic, data, rx_s):
+        with self.lock:
+            for st in (self.win[topic], self.total[topic]):
+                self._account(st, topic, data, rx_s)
+
+    @staticmethod
+    def _account(st, topic, data, rx_s):
+        st.msgs += 1
+        st.bytes += len(data)
+        if len(data) < 12:
+            st.errors += 1
+            return
+        seq, dev_us = struct.unpack_from("<HQ", data, 2)
+        if st.last_seq is not None:
+            gap = (seq - st.last_seq - 1) & 0xFFFF
+            if gap < 0x8000:            # 大跳变视为设备重启，不计丢包
+                st.lost += gap
+        st.last_seq = seq
+
+        last_us = dev_us
+        if topic == TOPIC_MPU6050:
+            try:
+                n, _, last_us = decode_telemetry(data)
+                st.samples += n
+            except ValueError:
+                st.errors += 1
+                return
+        if st.first_dev_us is None:
+            st.first_dev_us = dev_us
+        st.last_dev_us = last_us
+
+        offset = rx_s * 1000 - dev_us / 1000
+        st.offset_min = offset if st.offset_min is None else min(st.offset_min, offset)
+        st.offset_max = offset if st.offset_max is None else max(st.offset_max, offset)
+
+
+def print_row(name, st, dt):
+    jitter = (st.offset_max - st.offset_min) if st.offset_min is not None else 0.0
+    rate = ""
+    if st.samples and st.first_dev_us is not None and st.last_dev_us > st.first_dev_us:
+        rate = f" {st.samples / ((st.last_dev_us - st.first_dev_us) / 1e6):7.1f} Hz"
+    print(f"{name:>20} {st.msgs / dt:8.1f} {st.bytes / dt:9.0f} {st.lost:>6} {st.errors:>5} "
+          f"{jitter:9.1f} {st.samples / dt:9.1f}{rate}", flush=True)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="遥测订阅端吞吐统计")
+    ap.add_argument("--host", default="127.0.0.1")
+    ap.add_argument("--port", type=int, default=1883)
+    ap.add_argument("--username", default="RobiEcho")
+    ap.add_argument("--password", default="123456")
+    ap.add_argument("--client-id", default="mqtt_telemetry_sub")
+    ap.add_argument("--topics", default=",".join((TOPIC_MPU6050, TOPIC_POSE, TOPIC_GESTURE)))
+    ap.add_argument("--duration", type=float, default=0, help="统计时长（秒），0 表示直到 Ctrl-C")
+    ap.add_argument("--report", type=float, default=1.0, help="区间统计打印周期（秒）")
+    args = ap.parse_args()
+
+    topics = [t for t in args.topics.split(",") if t]
+    col = Collector(topics)
+
+    try:
+        client = mqtt.Client(mqtt.CallbackAPIVersion.VERSION1, client_id=args.client_id)
+    except AttributeError:
+        client = mqtt.Client(client_id=args.client_id)
+    if args.username:
+        client.username_pw_set(args.username, args.password)
+    client.on_connect = lambda c, u, f, rc: c.subscribe([(t, 0) for t in topics])
+    client.on_message = lambda c, u, msg: col.on_message(msg.topic, msg.payload, time.time())
+    try:
+        client.connect(args.host, args.port, keepalive=30)
+    except OSError as e:
+        print(f"连接失败：{e}", file=sys.stderr)
+        sys.exit(1)
+    client.loop_start()
+
+    header = (f"{'topic':>20} {'msg/s':>8} {'B/s':>9} {'lost':>6} {'err':>5} "
+              f"{'jitter_ms':>9} {'sample/s':>9} dev_rate")
+    t0 = time.monotonic()
+    t_last = t0
+    try:
+        while args.duration <= 0 or time.monotonic() - t0 < args.duration:
+            time.sleep(min(args.report, max(args.duration - (time.monotonic() - t0), 0.01))
+                       if args.duration > 0 else args.report)
+            now = time.monotonic()
+            with col.lock:
+                snaps = {t: col.win[t].window() for t in topics}
+            print(header)
+            for t in topics:
+                print_row(t, snaps[t], now - t_last)
+            t_last = now
+    except KeyboardInterrupt:
+        pass
+
+    client.loop_stop()
+    client.disconnect()
+
+    elapsed = time.monotonic() - t0
+    print(f"\n合计（{elapsed:.1f} 秒）")
+    print(header)
+    with col.lock:
+        for t in topics:
+            print_row(t, col.total[t], elapsed)
+
+
+if __name__ == "__main__":
+    main()